@@ -71,6 +71,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define AT_CHARACTER_TIMEOUT				(40)
 
+/* SW timers tick every 100ms and the first tick can come right away, 200 is 100ms at least */
+#define AT_RESET_PULSE_TIME					(200)
+
 #ifdef FSL_RTOS_FREE_RTOS
 #define AT_COMMAND_STACK_SIZE				(256)
 
@@ -113,10 +116,18 @@ void AtCommands_ResponseTimeoutCallback (void * Args);
 
 void AtCommands_CharacterTimeoutCallback (void);
 
+void AtCommands_ResetPulseCallback (void * Args);
+
+static void AtCommands_StartLatency(void);
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                   Global Constants Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+const uint16_t AtCommandsLatencyLimits[ATCOMMANDS_LATENCY_BUCKETS - 1] =
+{
+		100, 200, 500, 1000, 2000
+};
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                   Static Constants Section
@@ -144,6 +155,8 @@ static AtCommand_callback_t ApplicationCallback;
 
 static swtimer_t CommandResponseTimeout = 0xFF;
 
+static swtimer_t ResetPulseTimer = 0xFF;
+
 //static swtimer_t CharacterTimeout = 0xFF;
 
 static uint8_t CommandBuffer[AT_COMMAND_BUFFER_SIZE];
@@ -162,8 +175,20 @@ static AtCommandResponse_t * CommandResponseTable;
 
 static uint16_t CommandResponseTableSize;
 
+/* when set, received frames bypass the response table and are reported as is */
+static volatile bool isRawModeEnabled = false;
+
 RingBuffer_t ResponseRingBuffer;
 
+/* latency from the command sent to the first response, in SW timer ticks */
+static uint32_t CommandSentTick;
+
+static volatile bool isLatencyPending = false;
+
+static uint32_t LatencyHistogram[ATCOMMANDS_LATENCY_BUCKETS];
+
+static uint32_t RxHighWaterMark = 0;
+
 
 #if AT_COMMANDS_DEBUG == 1
 
@@ -186,6 +211,8 @@ void AtCommands_Init(AtCommand_callback_t AppCallback, AtCommandResponse_t * Res
 
 	CommandResponseTimeout = SWTimer_AllocateChannel(AT_RESPONSE_TIMEOUT,AtCommands_ResponseTimeoutCallback,NULL);
 
+	ResetPulseTimer = SWTimer_AllocateChannel(AT_RESET_PULSE_TIME,AtCommands_ResetPulseCallback,NULL);
+
 #if 0
 	CharacterTimeout = SWTimer_AllocateChannel(AT_CHARACTER_TIMEOUT,AtCommands_CharacterTimeoutCallback,NULL);
 #else
@@ -217,13 +244,9 @@ void AtCommands_Init(AtCommand_callback_t AppCallback, AtCommandResponse_t * Res
 void AtCommands_ResetModule(void)
 {
 	AtCommands_PlatformAssertReset();
-#ifdef FSL_RTOS_FREE_RTOS
-	vTaskDelay(50/portTICK_PERIOD_MS);
-#else
-	/* empiric time */
-	MiscFunctions_BlockingDelay(2000);
-#endif
-	AtCommands_PlatformDeassertReset();
+
+	/* reset is released by the timer, nothing is blocked in the meantime */
+	SWTimer_EnableTimer(ResetPulseTimer);
 }
 
 
@@ -277,65 +300,79 @@ void AtCommands_ProcessData(void)
 
 	RingBuffer_ReadBuffer(&ResponseRingBuffer,&ResponseBuffer[0],FrameSize);
 
-	CommandOffset = CommandResponseTableSize;
-
-	/* compare with all the table */
-	while(CommandOffset--)
+	/* the whole ring is drained on each frame, the frame size is its fill level */
+	if(FrameSize > RxHighWaterMark)
 	{
-		if(isSearchingNewCommand == true)
-		{
-			Status = MiscFunction_StringCompare(&CommandStartOfFrame[0],&ResponseBuffer[FrameOffset],AT_COMMAND_SOF_SIZE);
-
-			if(Status == STRING_OK)
-			{
-				/* start comparing after SOF */
-				FrameOffset += AT_COMMAND_SOF_SIZE;
-			}
-
-			isSearchingNewCommand = false;
-		}
+		RxHighWaterMark = FrameSize;
+	}
 
-		Status = MiscFunction_StringCompare(CommandResponseTable[CommandOffset].Response,&ResponseBuffer[FrameOffset],\
-				CommandResponseTable[CommandOffset].ResponseSize);
+	/* on raw mode the UART is just a pipe, nothing to parse */
+	if(isRawModeEnabled == true)
+	{
+		ApplicationCallback(ATCOMMANDS_RAW_DATA_EVENT,&ResponseBuffer[0],FrameSize);
+	}
+	else
+	{
+		CommandOffset = CommandResponseTableSize;
 
-		if(Status == STRING_OK)
+		/* compare with all the table */
+		while(CommandOffset--)
 		{
-			/* found it, now check if there are any parameters */
-			FrameOffset += CommandResponseTable[CommandOffset].ResponseSize;
-
-			if(FrameSize > (FrameOffset + AT_COMMAND_EOF_SIZE))
+			if(isSearchingNewCommand == true)
 			{
+				Status = MiscFunction_StringCompare(&CommandStartOfFrame[0],&ResponseBuffer[FrameOffset],AT_COMMAND_SOF_SIZE);
 
-				ParameterSize = FrameSize - FrameOffset;
-				KeepSearching = CommandResponseTable[CommandOffset].ResponseCallback(&ResponseBuffer[FrameOffset],ParameterSize);
-			}
-			else
-			{
-				KeepSearching = CommandResponseTable[CommandOffset].ResponseCallback(NULL,0);
-			}
+				if(Status == STRING_OK)
+				{
+					/* start comparing after SOF */
+					FrameOffset += AT_COMMAND_SOF_SIZE;
+				}
 
-			if(!KeepSearching)
-			{
-				break;
+				isSearchingNewCommand = false;
 			}
-			else
+
+			Status = MiscFunction_StringCompare(CommandResponseTable[CommandOffset].Response,&ResponseBuffer[FrameOffset],\
+					CommandResponseTable[CommandOffset].ResponseSize);
+
+			if(Status == STRING_OK)
 			{
-				/* if we need to keep searching commands, find where the current command ends 	*/
-				/* and set the offset to the beginning of the next command						*/
-				/* this process assumes the current command ended with EOF (\r\n)				*/
-				/* any special cases will end up as a command not found							*/
-				isSearchingNewCommand = true;
-				CommandOffset = CommandResponseTableSize;
-				NextCommand = MiscFunctions_FindTokenInString(&ResponseBuffer[FrameOffset], CommandEndOfFrame[0]);
-				FrameOffset += ((uint32_t)&NextCommand[1] - (uint32_t)&ResponseBuffer[FrameOffset]);
+				/* found it, now check if there are any parameters */
+				FrameOffset += CommandResponseTable[CommandOffset].ResponseSize;
+
+				if(FrameSize > (FrameOffset + AT_COMMAND_EOF_SIZE))
+				{
+
+					ParameterSize = FrameSize - FrameOffset;
+					KeepSearching = CommandResponseTable[CommandOffset].ResponseCallback(&ResponseBuffer[FrameOffset],ParameterSize);
+				}
+				else
+				{
+					KeepSearching = CommandResponseTable[CommandOffset].ResponseCallback(NULL,0);
+				}
+
+				if(!KeepSearching)
+				{
+					break;
+				}
+				else
+				{
+					/* if we need to keep searching commands, find where the current command ends 	*/
+					/* and set the offset to the beginning of the next command						*/
+					/* this process assumes the current command ended with EOF (\r\n)				*/
+					/* any special cases will end up as a command not found							*/
+					isSearchingNewCommand = true;
+					CommandOffset = CommandResponseTableSize;
+					NextCommand = MiscFunctions_FindTokenInString(&ResponseBuffer[FrameOffset], CommandEndOfFrame[0]);
+					FrameOffset += (uint16_t)(&NextCommand[1] - &ResponseBuffer[FrameOffset]);
+				}
 			}
 		}
-	}
 
-	/* a rollover means we went through all the table without success */
-	if(CommandOffset == 0xFFFF)
-	{
-		ApplicationCallback(ATCOMMANDS_RESPONSE_NOT_FOUND_EVENT,&ResponseBuffer[0],FrameSize);
+		/* a rollover means we went through all the table without success */
+		if(CommandOffset == 0xFFFF)
+		{
+			ApplicationCallback(ATCOMMANDS_RESPONSE_NOT_FOUND_EVENT,&ResponseBuffer[0],FrameSize);
+		}
 	}
 }
 
@@ -349,6 +386,7 @@ AtCommandsStatus_t ATCommands_ExecuteCommand(uint8_t * CommandToSend)
 	if(CommandSize > 0)
 	{
 		/* once the command is built, send it */
+		AtCommands_StartLatency();
 		SWTimer_EnableTimer(CommandResponseTimeout);
 		AtCommands_PlatformUartSend(&CommandBuffer[0],CommandSize);
 	}
@@ -376,6 +414,7 @@ AtCommandsStatus_t ATCommands_SendCustomCommand(uint8_t *CommandToSend, uint16_t
 		CommandBufferOffset += AT_COMMAND_EOF_SIZE;
 
 		/* once the command is built, send it */
+		AtCommands_StartLatency();
 		SWTimer_EnableTimer(CommandResponseTimeout);
 		AtCommands_PlatformUartSend(&CommandBuffer[0],CommandBufferOffset);
 	}
@@ -387,6 +426,25 @@ AtCommandsStatus_t ATCommands_SendCustomCommand(uint8_t *CommandToSend, uint16_t
 	return Status;
 }
 
+AtCommandsStatus_t ATCommands_SendRawData(uint8_t * DataToSend, uint16_t DataSize)
+{
+	AtCommandsStatus_t Status = ATCOMMANDS_OK;
+
+	if((DataToSend != NULL) && (DataSize <= AT_COMMAND_BUFFER_SIZE))
+	{
+		/* no EOF and no response expected, data goes out exactly as received */
+		MiscFunctions_MemCopy(DataToSend,&CommandBuffer[0],DataSize);
+
+		AtCommands_PlatformUartSend(&CommandBuffer[0],DataSize);
+	}
+	else
+	{
+		Status = ATCOMMANDS_WRONG_PARAMETER;
+	}
+
+	return Status;
+}
+
 AtCommandsStatus_t ATCommands_SetCommand(uint8_t * CommandToSend, uint8_t *Parameters)
 {
 
@@ -398,6 +456,7 @@ AtCommandsStatus_t ATCommands_SetCommand(uint8_t * CommandToSend, uint8_t *Param
 	if(CommandSize > 0)
 	{
 		/* once the command is built, send it */
+		AtCommands_StartLatency();
 		SWTimer_EnableTimer(CommandResponseTimeout);
 		AtCommands_PlatformUartSend(&CommandBuffer[0],CommandSize);
 	}
@@ -490,8 +549,17 @@ void AtCommands_ResponseTimeoutCallback (void * Args)
 	ApplicationCallback(ATCOMMANDS_COMMAND_TIMEOUT_ERROR_EVENT,NULL,0);
 }
 
+void AtCommands_ResetPulseCallback (void * Args)
+{
+	SWTimer_DisableTimer(ResetPulseTimer);
+
+	AtCommands_PlatformDeassertReset();
+}
+
 void AtCommands_CharacterTimeoutCallback (void)
 {
+	uint32_t Latency;
+	uint8_t LatencyBucket = 0;
 	#ifdef FSL_RTOS_FREE_RTOS
 	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 	#endif
@@ -500,6 +568,20 @@ void AtCommands_CharacterTimeoutCallback (void)
 	AtCommand_PlatformCharacterTimeoutStop();
 	SWTimer_DisableTimer(CommandResponseTimeout);
 
+	if(isLatencyPending == true)
+	{
+		isLatencyPending = false;
+
+		Latency = (SWTimer_GetTickCount() - CommandSentTick) * SWTIMER_BASE_TIME;
+
+		while((LatencyBucket < (ATCOMMANDS_LATENCY_BUCKETS - 1)) && (Latency >= AtCommandsLatencyLimits[LatencyBucket]))
+		{
+			LatencyBucket++;
+		}
+
+		LatencyHistogram[LatencyBucket]++;
+	}
+
 	/* signal the event or process it here? */
 
 
@@ -514,6 +596,23 @@ void AtCommands_CharacterTimeoutCallback (void)
 	#endif
 }
 
+void AtCommands_GetStatistics(AtCommandsStatistics_t * Statistics)
+{
+	if(Statistics != NULL)
+	{
+		MiscFunctions_MemCopy(&LatencyHistogram[0],&Statistics->LatencyHistogram[0],sizeof(LatencyHistogram));
+
+		Statistics->RxHighWaterMark = RxHighWaterMark;
+	}
+}
+
+static void AtCommands_StartLatency(void)
+{
+	CommandSentTick = SWTimer_GetTickCount();
+
+	isLatencyPending = true;
+}
+
 void AtCommands_EnableUart(bool isEnabled)
 {
 	AtCommands_PlatformUartEnableRx(isEnabled);
@@ -523,6 +622,11 @@ void AtCommands_EnableUart(bool isEnabled)
 	RingBuffer_Reset(&ResponseRingBuffer);
 }
 
+void AtCommands_EnableRawMode(bool isEnabled)
+{
+	isRawModeEnabled = isEnabled;
+}
+
 void AtCommands_EnableUartRx(bool isEnabled)
 {
 	AtCommands_PlatformUartEnableRx(isEnabled);
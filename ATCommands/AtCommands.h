@@ -45,6 +45,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define AT_COMMANDS_TIMEOUT_MS	(2000)
 
+#define ATCOMMANDS_LATENCY_BUCKETS	(6)
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                      Typedef Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -67,9 +69,16 @@ typedef enum
 	ATCOMMANDS_RESPONSE_NOT_FOUND_EVENT = 0,
 	ATCOMMANDS_CUSTOM_RESPONSE_EVENT,
 	ATCOMMANDS_COMMAND_TIMEOUT_ERROR_EVENT,
+	ATCOMMANDS_RAW_DATA_EVENT,
 }AtCommandsEvent_t;
 
 typedef void (* AtCommand_callback_t)(AtCommandsEvent_t, uint8_t*, uint16_t);
+
+typedef struct
+{
+	uint32_t LatencyHistogram[ATCOMMANDS_LATENCY_BUCKETS];
+	uint32_t RxHighWaterMark;
+}AtCommandsStatistics_t;
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                Function-like Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -78,6 +87,9 @@ typedef void (* AtCommand_callback_t)(AtCommandsEvent_t, uint8_t*, uint16_t);
 //                                  Extern Constants Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+/* upper limit in ms of each latency bucket, the last bucket has no limit */
+extern const uint16_t AtCommandsLatencyLimits[ATCOMMANDS_LATENCY_BUCKETS - 1];
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                  Extern Variables Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -107,12 +119,18 @@ AtCommandsStatus_t ATCommands_ExecuteCommand(uint8_t * CommandToSend);
 
 AtCommandsStatus_t ATCommands_SendCustomCommand(uint8_t *CommandToSend, uint16_t CommandSize);
 
+AtCommandsStatus_t ATCommands_SendRawData(uint8_t * DataToSend, uint16_t DataSize);
+
+void AtCommands_EnableRawMode(bool isEnabled);
+
 void AtCommands_EnableUart(bool isEnabled);
 
 void AtCommands_EnableUartRx(bool isEnabled);
 
 void AtCommands_EnableUartTx(bool isEnabled);
 
+void AtCommands_GetStatistics(AtCommandsStatistics_t * Statistics);
+
 #if defined(__cplusplus)
 }
 #endif // __cplusplus
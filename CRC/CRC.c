@@ -20,30 +20,130 @@
 
 #include "CRC.h"
 
+#if (CRC_USE_HARDWARE == 1)
+#include "fsl_common.h"
+#endif
+
+#if (CRC_USE_HARDWARE == 1) && defined(FSL_FEATURE_SOC_CRC_COUNT) && (FSL_FEATURE_SOC_CRC_COUNT > 0)
+#include "fsl_crc.h"
+#define CRC_HARDWARE_BACKEND		(1)
+#else
+#define CRC_HARDWARE_BACKEND		(0)
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                   Defines & Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define CRC_WIDTH    (8 * sizeof(crc_t))
 
-#define CRC_TOPBIT   (1 << (CRC_WIDTH - 1))
+#define CRC_ALGORITHM_MASK(WIDTH)	((WIDTH) == 32 ? 0xFFFFFFFF : ((((uint32_t)1) << (WIDTH)) - 1))
+
+#define CRC_CHECK_MESSAGE			"123456789"
 
-#if (CRC_REFLECT_DATA == TRUE)
-#undef  CRC_REFLECT_DATA
-#define CRC_REFLECT_DATA(X)			((uint8_t) Crc_Reflect((X), 8))
+#define CRC_CHECK_MESSAGE_SIZE		(sizeof(CRC_CHECK_MESSAGE) - 1)
+
+#if (CRC_REFLECT_DATA == TRUE) && (CRC_REFLECT_REMAINDER == TRUE)
+#define CRC_FAST_REFLECTED			(1)
+#elif (CRC_REFLECT_DATA == FALSE) && (CRC_REFLECT_REMAINDER == FALSE)
+#define CRC_FAST_REFLECTED			(0)
 #else
-#undef  CRC_REFLECT_DATA
-#define CRC_REFLECT_DATA(X)			(X)
+#error "CRC_REFLECT_DATA and CRC_REFLECT_REMAINDER must match"
 #endif
 
-#if (CRC_REFLECT_REMAINDER == TRUE)
-#undef  CRC_REFLECT_REMAINDER
-#define CRC_REFLECT_REMAINDER(X)	((crc_t) Crc_Reflect((X), CRC_WIDTH))
-#else
-#undef  CRC_REFLECT_REMAINDER
-#define CRC_REFLECT_REMAINDER(X)	(X)
+#define CRC_IS_REFLECTED			(CRC_FAST_REFLECTED == 1)
+
+#if (CRC_SLICE_BY != 1) && (CRC_SLICE_BY != 4) && (CRC_SLICE_BY != 8)
+#error "CRC_SLICE_BY must be 1, 4 or 8"
+#endif
+
+#if (CRC_SLICE_BY != 1) && (CRC_FAST_REFLECTED == 0)
+#error "slice LUTs are only generated for reflected CRC standards"
 #endif
 
+/*
+ * Compile time LUT generator. A CRC LUT is linear in its index, entry I is
+ * the XOR of the entries of each bit set in I. Those 8 entries are computed
+ * once as enum constants, split in 16 bit halves to stay in int range, so
+ * every other entry expands to 8 terms instead of 8 nested division steps.
+ * Reflected LUTs use the reflected polynomial and shift right.
+ */
+#define CRC_GEN_REFLECT_BIT(X, W, B)	(((((uint32_t)(X)) >> (B)) & 1) << (((W) - 1 - (B)) & 31))
+
+#define CRC_GEN_REFLECT(X, W)	(CRC_GEN_REFLECT_BIT(X, W, 0) | CRC_GEN_REFLECT_BIT(X, W, 1) | CRC_GEN_REFLECT_BIT(X, W, 2) | \
+								 CRC_GEN_REFLECT_BIT(X, W, 3) | CRC_GEN_REFLECT_BIT(X, W, 4) | CRC_GEN_REFLECT_BIT(X, W, 5) | \
+								 CRC_GEN_REFLECT_BIT(X, W, 6) | CRC_GEN_REFLECT_BIT(X, W, 7) | CRC_GEN_REFLECT_BIT(X, W, 8) | \
+								 CRC_GEN_REFLECT_BIT(X, W, 9) | CRC_GEN_REFLECT_BIT(X, W, 10) | CRC_GEN_REFLECT_BIT(X, W, 11) | \
+								 CRC_GEN_REFLECT_BIT(X, W, 12) | CRC_GEN_REFLECT_BIT(X, W, 13) | CRC_GEN_REFLECT_BIT(X, W, 14) | \
+								 CRC_GEN_REFLECT_BIT(X, W, 15) | CRC_GEN_REFLECT_BIT(X, W, 16) | CRC_GEN_REFLECT_BIT(X, W, 17) | \
+								 CRC_GEN_REFLECT_BIT(X, W, 18) | CRC_GEN_REFLECT_BIT(X, W, 19) | CRC_GEN_REFLECT_BIT(X, W, 20) | \
+								 CRC_GEN_REFLECT_BIT(X, W, 21) | CRC_GEN_REFLECT_BIT(X, W, 22) | CRC_GEN_REFLECT_BIT(X, W, 23) | \
+								 CRC_GEN_REFLECT_BIT(X, W, 24) | CRC_GEN_REFLECT_BIT(X, W, 25) | CRC_GEN_REFLECT_BIT(X, W, 26) | \
+								 CRC_GEN_REFLECT_BIT(X, W, 27) | CRC_GEN_REFLECT_BIT(X, W, 28) | CRC_GEN_REFLECT_BIT(X, W, 29) | \
+								 CRC_GEN_REFLECT_BIT(X, W, 30) | CRC_GEN_REFLECT_BIT(X, W, 31))
+
+/* entry for a single bit, base K is index bit K, or bit 7 - K when reflected */
+#define CRC_GEN_BASE(NAME, K)	((((uint32_t)NAME##_B##K##_H) << 16) | ((uint32_t)NAME##_B##K##_L))
+
+#define CRC_GEN_HALVES(NAME, K, VALUE)	NAME##_B##K##_H = (int)(((VALUE) >> 16) & 0xFFFF), \
+										NAME##_B##K##_L = (int)((VALUE) & 0xFFFF)
+
+#define CRC_GEN_FIRST(P, W, R)	((R) ? CRC_GEN_REFLECT(P, W) : ((uint32_t)(P)))
+
+/* one more division step, the next bit of the index */
+#define CRC_GEN_NEXT(V, P, W, R)	((R) ? (((V) >> 1) ^ (((V) & 1) ? CRC_GEN_REFLECT(P, W) : 0)) : \
+									((((V) << 1) ^ ((((V) >> ((W) - 1)) & 1) ? ((uint32_t)(P)) : 0)) & CRC_ALGORITHM_MASK(W)))
+
+#define CRC_GEN_BASES(NAME, P, W, R)	enum \
+										{ \
+											CRC_GEN_HALVES(NAME, 0, CRC_GEN_FIRST(P, W, R)), \
+											CRC_GEN_HALVES(NAME, 1, CRC_GEN_NEXT(CRC_GEN_BASE(NAME, 0), P, W, R)), \
+											CRC_GEN_HALVES(NAME, 2, CRC_GEN_NEXT(CRC_GEN_BASE(NAME, 1), P, W, R)), \
+											CRC_GEN_HALVES(NAME, 3, CRC_GEN_NEXT(CRC_GEN_BASE(NAME, 2), P, W, R)), \
+											CRC_GEN_HALVES(NAME, 4, CRC_GEN_NEXT(CRC_GEN_BASE(NAME, 3), P, W, R)), \
+											CRC_GEN_HALVES(NAME, 5, CRC_GEN_NEXT(CRC_GEN_BASE(NAME, 4), P, W, R)), \
+											CRC_GEN_HALVES(NAME, 6, CRC_GEN_NEXT(CRC_GEN_BASE(NAME, 5), P, W, R)), \
+											CRC_GEN_HALVES(NAME, 7, CRC_GEN_NEXT(CRC_GEN_BASE(NAME, 6), P, W, R)), \
+										}
+
+/* next slice of a reflected LUT, one more zero byte pushed through BYTE */
+#define CRC_GEN_SLICE_NEXT(PREVIOUS, BYTE, K)	((CRC_GEN_BASE(PREVIOUS, K) >> 8) ^ \
+												CRC_GEN_ENTRY(BYTE, 1, CRC_GEN_BASE(PREVIOUS, K) & 0xFF))
+
+#define CRC_GEN_SLICE_BASES(NAME, PREVIOUS, BYTE)	enum \
+													{ \
+														CRC_GEN_HALVES(NAME, 0, CRC_GEN_SLICE_NEXT(PREVIOUS, BYTE, 0)), \
+														CRC_GEN_HALVES(NAME, 1, CRC_GEN_SLICE_NEXT(PREVIOUS, BYTE, 1)), \
+														CRC_GEN_HALVES(NAME, 2, CRC_GEN_SLICE_NEXT(PREVIOUS, BYTE, 2)), \
+														CRC_GEN_HALVES(NAME, 3, CRC_GEN_SLICE_NEXT(PREVIOUS, BYTE, 3)), \
+														CRC_GEN_HALVES(NAME, 4, CRC_GEN_SLICE_NEXT(PREVIOUS, BYTE, 4)), \
+														CRC_GEN_HALVES(NAME, 5, CRC_GEN_SLICE_NEXT(PREVIOUS, BYTE, 5)), \
+														CRC_GEN_HALVES(NAME, 6, CRC_GEN_SLICE_NEXT(PREVIOUS, BYTE, 6)), \
+														CRC_GEN_HALVES(NAME, 7, CRC_GEN_SLICE_NEXT(PREVIOUS, BYTE, 7)), \
+													}
+
+#define CRC_GEN_BIT(K, R)		((R) ? (0x80 >> (K)) : (0x01 << (K)))
+
+#define CRC_GEN_TERM(NAME, R, I, K)	(((I) & CRC_GEN_BIT(K, R)) ? CRC_GEN_BASE(NAME, K) : 0)
+
+#define CRC_GEN_ENTRY(NAME, R, I)	(CRC_GEN_TERM(NAME, R, I, 0) ^ CRC_GEN_TERM(NAME, R, I, 1) ^ \
+									 CRC_GEN_TERM(NAME, R, I, 2) ^ CRC_GEN_TERM(NAME, R, I, 3) ^ \
+									 CRC_GEN_TERM(NAME, R, I, 4) ^ CRC_GEN_TERM(NAME, R, I, 5) ^ \
+									 CRC_GEN_TERM(NAME, R, I, 6) ^ CRC_GEN_TERM(NAME, R, I, 7))
+
+#define CRC_GEN_4(NAME, R, I)	CRC_GEN_ENTRY(NAME, R, (I)), CRC_GEN_ENTRY(NAME, R, (I) + 1), \
+								CRC_GEN_ENTRY(NAME, R, (I) + 2), CRC_GEN_ENTRY(NAME, R, (I) + 3)
+
+#define CRC_GEN_16(NAME, R, I)	CRC_GEN_4(NAME, R, (I)), CRC_GEN_4(NAME, R, (I) + 4), \
+								CRC_GEN_4(NAME, R, (I) + 8), CRC_GEN_4(NAME, R, (I) + 12)
+
+#define CRC_GEN_64(NAME, R, I)	CRC_GEN_16(NAME, R, (I)), CRC_GEN_16(NAME, R, (I) + 16), \
+								CRC_GEN_16(NAME, R, (I) + 32), CRC_GEN_16(NAME, R, (I) + 48)
+
+/* the 256 entries of a LUT whose bases were declared with CRC_GEN_BASES() or CRC_GEN_SLICE_BASES() */
+#define CRC_GEN_LUT(NAME, R)	CRC_GEN_64(NAME, R, 0), CRC_GEN_64(NAME, R, 64), \
+								CRC_GEN_64(NAME, R, 128), CRC_GEN_64(NAME, R, 192)
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                       Typedef Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -54,38 +154,121 @@
 
 static uint32_t Crc_Reflect(uint32_t  data, uint8_t nBits);
 
-///////////////////////////////////////////////////////////////////////////////////////////////////
-//                                   Global Constants Section
-///////////////////////////////////////////////////////////////////////////////////////////////////
-
+static bool Crc_HardwareCalculation(uint8_t Width, uint32_t Polynomial, uint32_t InitialRemainder, uint32_t FinalXorValue, \
+		bool isReflected, uint8_t const * Message, uint32_t nBytes, uint32_t * Crc);
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                   Static Constants Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-#if CRC_CREATE_REMINDER_LUT == 0
+/* one LUT per crc_algorithm_t, the linker drops the ones the application doesn't use */
+CRC_GEN_BASES(CRC_GEN_ARC, 0x8005, 16, 1);
+
+static const uint32_t CrcArcLut[256] =
+{
+	CRC_GEN_LUT(CRC_GEN_ARC, 1)
+};
+
+CRC_GEN_BASES(CRC_GEN_CCITT_FALSE, 0x1021, 16, 0);
+
+static const uint32_t CrcCcittFalseLut[256] =
+{
+	CRC_GEN_LUT(CRC_GEN_CCITT_FALSE, 0)
+};
+
+CRC_GEN_BASES(CRC_GEN_KERMIT, 0x1021, 16, 1);
+
+static const uint32_t CrcKermitLut[256] =
+{
+	CRC_GEN_LUT(CRC_GEN_KERMIT, 1)
+};
+
+CRC_GEN_BASES(CRC_GEN_CRC32, 0x04C11DB7, 32, 1);
+
+static const uint32_t CrcCrc32Lut[256] =
+{
+	CRC_GEN_LUT(CRC_GEN_CRC32, 1)
+};
+
+CRC_GEN_BASES(CRC_GEN_CRC32C, 0x1EDC6F41, 32, 1);
+
+static const uint32_t CrcCrc32CLut[256] =
+{
+	CRC_GEN_LUT(CRC_GEN_CRC32C, 1)
+};
+
+/* LUTs of the CRC standard in CRC.h */
+CRC_GEN_BASES(CRC_GEN_FAST, CRC_POLYNOMIAL, CRC_WIDTH, CRC_FAST_REFLECTED);
+
+#if (CRC_FAST_REFLECTED == 0)
 
 static const crc_t CrcLut[256] =
 {
-	0x0000, 0x8005, 0x800f, 0x000a, 0x801b, 0x001e, 0x0014, 0x8011, 0x8033, 0x0036, 0x003c, 0x8039, 0x0028, 0x802d, 0x8027, 0x0022,
-	0x8063, 0x0066, 0x006c, 0x8069, 0x0078, 0x807d, 0x8077, 0x0072, 0x0050, 0x8055, 0x805f, 0x005a, 0x804b, 0x004e, 0x0044, 0x8041,
-	0x80c3, 0x00c6, 0x00cc, 0x80c9, 0x00d8, 0x80dd, 0x80d7, 0x00d2, 0x00f0, 0x80f5, 0x80ff, 0x00fa, 0x80eb, 0x00ee, 0x00e4, 0x80e1,
-	0x00a0, 0x80a5, 0x80af, 0x00aa, 0x80bb, 0x00be, 0x00b4, 0x80b1, 0x8093, 0x0096, 0x009c, 0x8099, 0x0088, 0x808d, 0x8087, 0x0082,
-	0x8183, 0x0186, 0x018c, 0x8189, 0x0198, 0x819d, 0x8197, 0x0192, 0x01b0, 0x81b5, 0x81bf, 0x01ba, 0x81ab, 0x01ae, 0x01a4, 0x81a1,
-	0x01e0, 0x81e5, 0x81ef, 0x01ea, 0x81fb, 0x01fe, 0x01f4, 0x81f1, 0x81d3, 0x01d6, 0x01dc, 0x81d9, 0x01c8, 0x81cd, 0x81c7, 0x01c2,
-	0x0140, 0x8145, 0x814f, 0x014a, 0x815b, 0x015e, 0x0154, 0x8151, 0x8173, 0x0176, 0x017c, 0x8179, 0x0168, 0x816d, 0x8167, 0x0162,
-	0x8123, 0x0126, 0x012c, 0x8129, 0x0138, 0x813d, 0x8137, 0x0132, 0x0110, 0x8115, 0x811f, 0x011a, 0x810b, 0x010e, 0x0104, 0x8101,
-	0x8303, 0x0306, 0x030c, 0x8309, 0x0318, 0x831d, 0x8317, 0x0312, 0x0330, 0x8335, 0x833f, 0x033a, 0x832b, 0x032e, 0x0324, 0x8321,
-	0x0360, 0x8365, 0x836f, 0x036a, 0x837b, 0x037e, 0x0374, 0x8371, 0x8353, 0x0356, 0x035c, 0x8359, 0x0348, 0x834d, 0x8347, 0x0342,
-	0x03c0, 0x83c5, 0x83cf, 0x03ca, 0x83db, 0x03de, 0x03d4, 0x83d1, 0x83f3, 0x03f6, 0x03fc, 0x83f9, 0x03e8, 0x83ed, 0x83e7, 0x03e2,
-	0x83a3, 0x03a6, 0x03ac, 0x83a9, 0x03b8, 0x83bd, 0x83b7, 0x03b2, 0x0390, 0x8395, 0x839f, 0x039a, 0x838b, 0x038e, 0x0384, 0x8381,
-	0x0280, 0x8285, 0x828f, 0x028a, 0x829b, 0x029e, 0x0294, 0x8291, 0x82b3, 0x02b6, 0x02bc, 0x82b9, 0x02a8, 0x82ad, 0x82a7, 0x02a2,
-	0x82e3, 0x02e6, 0x02ec, 0x82e9, 0x02f8, 0x82fd, 0x82f7, 0x02f2, 0x02d0, 0x82d5, 0x82df, 0x02da, 0x82cb, 0x02ce, 0x02c4, 0x82c1,
-	0x8243, 0x0246, 0x024c, 0x8249, 0x0258, 0x825d, 0x8257, 0x0252, 0x0270, 0x8275, 0x827f, 0x027a, 0x826b, 0x026e, 0x0264, 0x8261,
-	0x0220, 0x8225, 0x822f, 0x022a, 0x823b, 0x023e, 0x0234, 0x8231, 0x8213, 0x0216, 0x021c, 0x8219, 0x0208, 0x820d, 0x8207, 0x0202,
+	CRC_GEN_LUT(CRC_GEN_FAST, 0)
 };
 
+#else
+
+#if (CRC_SLICE_BY >= 4)
+CRC_GEN_SLICE_BASES(CRC_GEN_FAST_S1, CRC_GEN_FAST, CRC_GEN_FAST);
+CRC_GEN_SLICE_BASES(CRC_GEN_FAST_S2, CRC_GEN_FAST_S1, CRC_GEN_FAST);
+CRC_GEN_SLICE_BASES(CRC_GEN_FAST_S3, CRC_GEN_FAST_S2, CRC_GEN_FAST);
+#endif
+
+#if (CRC_SLICE_BY == 8)
+CRC_GEN_SLICE_BASES(CRC_GEN_FAST_S4, CRC_GEN_FAST_S3, CRC_GEN_FAST);
+CRC_GEN_SLICE_BASES(CRC_GEN_FAST_S5, CRC_GEN_FAST_S4, CRC_GEN_FAST);
+CRC_GEN_SLICE_BASES(CRC_GEN_FAST_S6, CRC_GEN_FAST_S5, CRC_GEN_FAST);
+CRC_GEN_SLICE_BASES(CRC_GEN_FAST_S7, CRC_GEN_FAST_S6, CRC_GEN_FAST);
+#endif
+
+/* CrcSliceLut[0] is the reflected byte LUT, each next slice is one more zero byte appended */
+static const crc_t CrcSliceLut[CRC_SLICE_BY][256] =
+{
+	{ CRC_GEN_LUT(CRC_GEN_FAST, 1) },
+#if (CRC_SLICE_BY >= 4)
+	{ CRC_GEN_LUT(CRC_GEN_FAST_S1, 1) },
+	{ CRC_GEN_LUT(CRC_GEN_FAST_S2, 1) },
+	{ CRC_GEN_LUT(CRC_GEN_FAST_S3, 1) },
 #endif
+#if (CRC_SLICE_BY == 8)
+	{ CRC_GEN_LUT(CRC_GEN_FAST_S4, 1) },
+	{ CRC_GEN_LUT(CRC_GEN_FAST_S5, 1) },
+	{ CRC_GEN_LUT(CRC_GEN_FAST_S6, 1) },
+	{ CRC_GEN_LUT(CRC_GEN_FAST_S7, 1) },
+#endif
+};
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+const crc_algorithm_t CrcArc =
+{
+	"CRC-16/ARC", 16, 0x8005, 0x0000, 0x0000, true, 0xBB3D, &CrcArcLut[0]
+};
+
+const crc_algorithm_t CrcCcittFalse =
+{
+	"CRC-16/CCITT-FALSE", 16, 0x1021, 0xFFFF, 0x0000, false, 0x29B1, &CrcCcittFalseLut[0]
+};
+
+const crc_algorithm_t CrcKermit =
+{
+	"CRC-16/KERMIT", 16, 0x1021, 0x0000, 0x0000, true, 0x2189, &CrcKermitLut[0]
+};
+
+const crc_algorithm_t Crc32 =
+{
+	"CRC-32", 32, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, 0xCBF43926, &CrcCrc32Lut[0]
+};
+
+const crc_algorithm_t Crc32C =
+{
+	"CRC-32C", 32, 0x1EDC6F41, 0xFFFFFFFF, 0xFFFFFFFF, true, 0xE3069283, &CrcCrc32CLut[0]
+};
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -97,8 +280,9 @@ static const crc_t CrcLut[256] =
 //                                   Static Variables Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-#if CRC_CREATE_REMINDER_LUT == 1
-static crc_t CrcLut[256];
+#if (CRC_HARDWARE_BACKEND == 1)
+/* the peripheral is shared by tasks and interrupts */
+static volatile bool isCrcHardwareBusy = false;
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -132,7 +316,7 @@ static uint32_t Crc_Reflect(uint32_t  data, uint8_t nBits)
 		 */
 		if (data & 0x01)
 		{
-			reflection |= (1 << ((nBits - 1) - bit));
+			reflection |= (((uint32_t)1) << ((nBits - 1) - bit));
 		}
 
 		data = (data >> 1);
@@ -147,60 +331,132 @@ static uint32_t Crc_Reflect(uint32_t  data, uint8_t nBits)
  *
  * Function:    Crc_Init()
  *
- * Description: Populate the partial CRC lookup table.
+ * Description: Kept for callers of the old runtime LUT generation.
  *
- * Notes:		This function must be rerun any time the CRC standard
- *				is changed.  If desired, it can be run "offline" and
- *				the table results stored in an embedded system's ROM.
+ * Notes:		Every LUT is generated by the compiler and lives in
+ *				flash, there is nothing left to populate.
  *
  * Returns:		None defined.
  *
  *********************************************************************/
 void Crc_Init(void)
 {
-#if CRC_CREATE_REMINDER_LUT == 1
-    crc_t	  remainder;
-	int16_t	  dividend;
-	uint8_t	  bit;
+}
+
+
+/*********************************************************************
+ *
+ * Function:    Crc_Begin()
+ *
+ * Description: Start a CRC calculation done in chunks.
+ *
+ * Notes:		The value returned is only meaningful to Crc_Update()
+ *				and Crc_Finish(), it is kept reflected for reflected
+ *				standards.
+ *
+ * Returns:		The initial remainder.
+ *
+ *********************************************************************/
+crc_t Crc_Begin(void)
+{
+#if (CRC_FAST_REFLECTED == 0)
+	return (CRC_INITIAL_REMAINDER);
+#else
+	return ((crc_t) Crc_Reflect(CRC_INITIAL_REMAINDER, CRC_WIDTH));
+#endif
+}
+
+
+/*********************************************************************
+ *
+ * Function:    Crc_Update()
+ *
+ * Description: Add the next chunk of a message to the CRC.
+ *
+ * Notes:		With CRC_SLICE_BY set to 4 or 8 the message is
+ *				consumed that many bytes per loop, read a byte at a
+ *				time so it doesn't need to be aligned. Chunks can have
+ *				any size.
+ *
+ * Returns:		The remainder to pass to the next Crc_Update() or to
+ *				Crc_Finish().
+ *
+ *********************************************************************/
+crc_t Crc_Update(crc_t Remainder, uint8_t const * Message, uint32_t nBytes)
+{
+#if (CRC_FAST_REFLECTED == 0)
+    uint8_t  		data;
 
 
     /*
-     * Compute the remainder of each possible dividend.
+     * Divide the message by the polynomial, a byte at a time.
      */
-    for (dividend = 0; dividend < 256; ++dividend)
+    while (nBytes > 0)
     {
-        /*
-         * Start with the dividend followed by zeros.
-         */
-        remainder = dividend << (CRC_WIDTH - 8);
-
-        /*
-         * Perform modulo-2 division, a bit at a time.
-         */
-        for (bit = 8; bit > 0; --bit)
-        {
-            /*
-             * Try to divide the current data bit.
-             */
-            if (remainder & CRC_TOPBIT)
-            {
-                remainder = (remainder << 1) ^ CRC_POLYNOMIAL;
-            }
-            else
-            {
-                remainder = (remainder << 1);
-            }
-        }
+        data = *Message ^ (Remainder >> (CRC_WIDTH - 8));
+  		Remainder = CrcLut[data] ^ (Remainder << 8);
 
-        /*
-         * Store the result into the table.
-         */
-        CrcLut[dividend] = remainder;
+        Message++;
+        nBytes--;
     }
+#else
+#if (CRC_SLICE_BY > 1)
+    /*
+     * Remainder and message are both reflected, so the first two bytes
+     * are folded into the remainder and the rest index their own slice.
+     */
+    while (nBytes >= CRC_SLICE_BY)
+    {
+        Remainder ^= (crc_t)(Message[0] | (Message[1] << 8));
 
+#if CRC_SLICE_BY == 8
+        Remainder = CrcSliceLut[7][Remainder & 0xFF] ^ CrcSliceLut[6][Remainder >> 8] ^
+                    CrcSliceLut[5][Message[2]] ^ CrcSliceLut[4][Message[3]] ^
+                    CrcSliceLut[3][Message[4]] ^ CrcSliceLut[2][Message[5]] ^
+                    CrcSliceLut[1][Message[6]] ^ CrcSliceLut[0][Message[7]];
 #else
+        Remainder = CrcSliceLut[3][Remainder & 0xFF] ^ CrcSliceLut[2][Remainder >> 8] ^
+                    CrcSliceLut[1][Message[2]] ^ CrcSliceLut[0][Message[3]];
+#endif
+
+        Message += CRC_SLICE_BY;
+        nBytes -= CRC_SLICE_BY;
+    }
+#endif
+
+    /*
+     * Whatever doesn't fill a slice goes a byte at a time.
+     */
+    while (nBytes > 0)
+    {
+        Remainder = CrcSliceLut[0][(Remainder ^ *Message) & 0xFF] ^ (Remainder >> 8);
 
+        Message++;
+        nBytes--;
+    }
 #endif
+
+    return (Remainder);
+}
+
+
+/*********************************************************************
+ *
+ * Function:    Crc_Finish()
+ *
+ * Description: End a CRC calculation done in chunks.
+ *
+ * Notes:		None.
+ *
+ * Returns:		The CRC of all the chunks.
+ *
+ *********************************************************************/
+crc_t Crc_Finish(crc_t Remainder)
+{
+    /*
+     * The final remainder is the CRC, already reflected if it has to be.
+     */
+    return (Remainder ^ CRC_FINAL_XOR_VALUE);
 }
 
 
@@ -210,32 +466,270 @@ void Crc_Init(void)
  *
  * Description: Compute the CRC of a given message.
  *
- * Notes:		crcInit() must be called first.
+ * Notes:		Negative sizes give
+ *				the CRC of an empty message, longer messages go
+ *				through Crc_Begin(), Crc_Update() and Crc_Finish().
+ *				The CRC peripheral is used instead when there is one
+ *				and it's free.
  *
  * Returns:		The CRC of the message.
  *
  *********************************************************************/
 crc_t Crc_FastCalculation(uint8_t const * Message, int16_t nBytes)
 {
-    crc_t	       	remainder = CRC_INITIAL_REMAINDER;
-    uint8_t  		data;
-	int16_t         byte;
+    crc_t	       	remainder = Crc_Begin();
+    uint32_t		hardwareCrc = 0;
+    bool			isHardwareCrc = false;
 
 
-    /*
-     * Divide the message by the polynomial, a byte at a time.
-     */
-    for (byte = 0; byte < nBytes; ++byte)
+    if (nBytes > 0)
     {
-        data = CRC_REFLECT_DATA(Message[byte]) ^ (remainder >> (CRC_WIDTH - 8));
-  		remainder = CrcLut[data] ^ (remainder << 8);
+        isHardwareCrc = Crc_HardwareCalculation(CRC_WIDTH, CRC_POLYNOMIAL, CRC_INITIAL_REMAINDER, CRC_FINAL_XOR_VALUE, \
+        		CRC_IS_REFLECTED, Message, (uint32_t)nBytes, &hardwareCrc);
+
+        if (isHardwareCrc == false)
+        {
+            remainder = Crc_Update(remainder, Message, (uint32_t)nBytes);
+        }
     }
 
-    /*
-     * The final remainder is the CRC.
-     */
-    return (CRC_REFLECT_REMAINDER(remainder) ^ CRC_FINAL_XOR_VALUE);
+    if (isHardwareCrc == false)
+    {
+        hardwareCrc = Crc_Finish(remainder);
+    }
+
+    return ((crc_t)hardwareCrc);
+}
+
+
+/*********************************************************************
+ *
+ * Function:    Crc_AlgorithmBegin()
+ *
+ * Description: Start a CRC calculation with the given algorithm.
+ *
+ * Notes:		Reflected algorithms keep the remainder reflected, the
+ *				table already is, so nothing is reflected per byte.
+ *
+ * Returns:		The initial remainder.
+ *
+ *********************************************************************/
+uint32_t Crc_AlgorithmBegin(const crc_algorithm_t * Algorithm)
+{
+	uint32_t  remainder = Algorithm->InitialRemainder;
+
+	if (Algorithm->isReflected == true)
+	{
+		remainder = Crc_Reflect(remainder, Algorithm->Width);
+	}
+
+	return (remainder);
+}
+
+
+/*********************************************************************
+ *
+ * Function:    Crc_AlgorithmUpdate()
+ *
+ * Description: Add the next chunk of a message to the CRC.
+ *
+ * Notes:		Non reflected remainders keep garbage above Width,
+ *				it is masked by Crc_AlgorithmFinish().
+ *
+ * Returns:		The remainder for the next chunk.
+ *
+ *********************************************************************/
+uint32_t Crc_AlgorithmUpdate(const crc_algorithm_t * Algorithm, uint32_t Remainder, uint8_t const * Message, uint32_t nBytes)
+{
+	const uint32_t * lut = Algorithm->Lut;
+	uint8_t  shift = Algorithm->Width - 8;
+
+	if (Algorithm->isReflected == true)
+	{
+		while (nBytes > 0)
+		{
+			Remainder = lut[(Remainder ^ *Message) & 0xFF] ^ (Remainder >> 8);
+
+			Message++;
+			nBytes--;
+		}
+	}
+	else
+	{
+		while (nBytes > 0)
+		{
+			Remainder = lut[((Remainder >> shift) ^ *Message) & 0xFF] ^ (Remainder << 8);
+
+			Message++;
+			nBytes--;
+		}
+	}
+
+	return (Remainder);
+}
+
+
+/*********************************************************************
+ *
+ * Function:    Crc_AlgorithmFinish()
+ *
+ * Description: End a CRC calculation with the given algorithm.
+ *
+ * Notes:		None.
+ *
+ * Returns:		The CRC, Width bits wide.
+ *
+ *********************************************************************/
+uint32_t Crc_AlgorithmFinish(const crc_algorithm_t * Algorithm, uint32_t Remainder)
+{
+	return ((Remainder ^ Algorithm->FinalXorValue) & CRC_ALGORITHM_MASK(Algorithm->Width));
+}
+
+
+/*********************************************************************
+ *
+ * Function:    Crc_Calculate()
+ *
+ * Description: Compute the CRC of a message with the given algorithm.
+ *
+ * Notes:		Goes to the CRC peripheral when there is one, it's free
+ *				and it supports the algorithm, to the tables otherwise.
+ *
+ * Returns:		The CRC of the message.
+ *
+ *********************************************************************/
+uint32_t Crc_Calculate(const crc_algorithm_t * Algorithm, uint8_t const * Message, uint32_t nBytes)
+{
+	uint32_t  remainder;
+	bool	  isHardwareCrc;
+
+	isHardwareCrc = Crc_HardwareCalculation(Algorithm->Width, Algorithm->Polynomial, Algorithm->InitialRemainder, \
+			Algorithm->FinalXorValue, Algorithm->isReflected, Message, nBytes, &remainder);
+
+	if (isHardwareCrc == false)
+	{
+		remainder = Crc_AlgorithmBegin(Algorithm);
+
+		remainder = Crc_AlgorithmUpdate(Algorithm, remainder, Message, nBytes);
+
+		remainder = Crc_AlgorithmFinish(Algorithm, remainder);
+	}
+
+	return (remainder);
+}
+
+
+/*********************************************************************
+ *
+ * Function:    Crc_SelfTest()
+ *
+ * Description: Check an algorithm against its "123456789" check value.
+ *
+ * Notes:		Catches a table that doesn't match its parameters, or a
+ *				CRC peripheral configured differently than the tables.
+ *
+ * Returns:		true when both backends match the check value.
+ *
+ *********************************************************************/
+bool Crc_SelfTest(const crc_algorithm_t * Algorithm)
+{
+	uint32_t  checkCrc;
+	uint32_t  tableCrc;
+
+	checkCrc = Crc_Calculate(Algorithm, (uint8_t const *)CRC_CHECK_MESSAGE, CRC_CHECK_MESSAGE_SIZE);
+
+	/* always through the tables as well, both backends have to agree */
+	tableCrc = Crc_AlgorithmBegin(Algorithm);
+	tableCrc = Crc_AlgorithmUpdate(Algorithm, tableCrc, (uint8_t const *)CRC_CHECK_MESSAGE, CRC_CHECK_MESSAGE_SIZE);
+	tableCrc = Crc_AlgorithmFinish(Algorithm, tableCrc);
+
+	return ((checkCrc == Algorithm->CheckValue) && (tableCrc == Algorithm->CheckValue));
+}
+
+
+/*********************************************************************
+ *
+ * Function:    Crc_HardwareCalculation()
+ *
+ * Description: Compute a CRC with the CRC peripheral.
+ *
+ * Notes:		Only 16 and 32 bit algorithms whose initial remainder
+ *				and final XOR are all zeros or all ones fit it. When
+ *				the peripheral is in use by someone else the caller
+ *				uses the tables instead of waiting.
+ *
+ * Returns:		true when Crc has been calculated.
+ *
+ *********************************************************************/
+#if (CRC_HARDWARE_BACKEND == 1)
+static bool Crc_HardwareCalculation(uint8_t Width, uint32_t Polynomial, uint32_t InitialRemainder, uint32_t FinalXorValue, \
+		bool isReflected, uint8_t const * Message, uint32_t nBytes, uint32_t * Crc)
+{
+	crc_config_t  config;
+	uint32_t  mask = CRC_ALGORITHM_MASK(Width);
+	uint32_t  interruptMask;
+	bool	  isAvailable = false;
+
+	if (((Width == 16) || (Width == 32)) && \
+		((InitialRemainder == 0) || (InitialRemainder == mask)) && \
+		((FinalXorValue == 0) || (FinalXorValue == mask)))
+	{
+		interruptMask = DisableGlobalIRQ();
+
+		if (isCrcHardwareBusy == false)
+		{
+			isCrcHardwareBusy = true;
+			isAvailable = true;
+		}
+
+		EnableGlobalIRQ(interruptMask);
+	}
+
+	if (isAvailable == true)
+	{
+		config.polynomial = Polynomial;
+		config.seed = InitialRemainder;
+		config.reflectIn = isReflected;
+		config.reflectOut = isReflected;
+		config.complementChecksum = (FinalXorValue != 0);
+		config.crcBits = (Width == 16) ? kCrcBits16 : kCrcBits32;
+		config.crcResult = kCrcFinalChecksum;
+
+		CRC_Init(CRC0, &config);
+
+		CRC_WriteData(CRC0, Message, nBytes);
+
+		if (Width == 16)
+		{
+			*Crc = CRC_Get16bitResult(CRC0);
+		}
+		else
+		{
+			*Crc = CRC_Get32bitResult(CRC0);
+		}
+
+		isCrcHardwareBusy = false;
+	}
+
+	return (isAvailable);
 }
+#else
+static bool Crc_HardwareCalculation(uint8_t Width, uint32_t Polynomial, uint32_t InitialRemainder, uint32_t FinalXorValue, \
+		bool isReflected, uint8_t const * Message, uint32_t nBytes, uint32_t * Crc)
+{
+	/* no CRC peripheral, the tables do it all */
+	(void)Width;
+	(void)Polynomial;
+	(void)InitialRemainder;
+	(void)FinalXorValue;
+	(void)isReflected;
+	(void)Message;
+	(void)nBytes;
+	(void)Crc;
+
+	return (false);
+}
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // EOF
@@ -21,11 +21,20 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <stdint.h>
+#include <stdbool.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                  Defines & Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+#ifndef TRUE
+#define TRUE				(1)
+#endif
+
+#ifndef FALSE
+#define FALSE				(0)
+#endif
+
 #define CRC_NAME			"CRC-16"
 
 #define CRC_POLYNOMIAL			0x8005
@@ -40,7 +49,15 @@
 
 #define CRC_CHECK_VALUE			0xBB3D
 
-#define CRC_CREATE_REMINDER_LUT	(0)
+/* bytes consumed per loop, 4 or 8 need a reflected standard, every slice is a 512 bytes LUT in flash */
+#ifndef CRC_SLICE_BY
+#define CRC_SLICE_BY			(4)
+#endif
+
+/* use the CRC peripheral when the part has one, host builds define it to 0 */
+#ifndef CRC_USE_HARDWARE
+#define CRC_USE_HARDWARE		(1)
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                      Typedef Section
@@ -48,6 +65,20 @@
 
 typedef uint16_t  crc_t;
 
+/* Rocksoft model parameters, reflected algorithms reflect both data and remainder */
+typedef struct
+{
+	const char * Name;
+	uint8_t Width;
+	uint32_t Polynomial;
+	uint32_t InitialRemainder;
+	uint32_t FinalXorValue;
+	bool isReflected;
+	uint32_t CheckValue;
+	/* already reflected for reflected algorithms */
+	const uint32_t * Lut;
+}crc_algorithm_t;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                Function-like Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +87,16 @@ typedef uint16_t  crc_t;
 //                                  Extern Constants Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+extern const crc_algorithm_t CrcArc;
+
+extern const crc_algorithm_t CrcCcittFalse;
+
+extern const crc_algorithm_t CrcKermit;
+
+extern const crc_algorithm_t Crc32;
+
+extern const crc_algorithm_t Crc32C;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                  Extern Variables Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -72,6 +113,22 @@ void Crc_Init(void);
 
 crc_t Crc_FastCalculation(uint8_t const * Message, int16_t nBytes);
 
+crc_t Crc_Begin(void);
+
+crc_t Crc_Update(crc_t Remainder, uint8_t const * Message, uint32_t nBytes);
+
+crc_t Crc_Finish(crc_t Remainder);
+
+uint32_t Crc_AlgorithmBegin(const crc_algorithm_t * Algorithm);
+
+uint32_t Crc_AlgorithmUpdate(const crc_algorithm_t * Algorithm, uint32_t Remainder, uint8_t const * Message, uint32_t nBytes);
+
+uint32_t Crc_AlgorithmFinish(const crc_algorithm_t * Algorithm, uint32_t Remainder);
+
+uint32_t Crc_Calculate(const crc_algorithm_t * Algorithm, uint8_t const * Message, uint32_t nBytes);
+
+bool Crc_SelfTest(const crc_algorithm_t * Algorithm);
+
 #if defined(__cplusplus)
 }
 #endif // __cplusplus
@@ -0,0 +1,326 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Host check and throughput of Crc_Update with the CRC_SLICE_BY it is built
+ * with. The result is first compared bit for bit against a bitwise reference
+ * on every length up to CRC_BENCHMARK_CHECK_SIZE and every alignment, fed
+ * whole and in random chunks, then timed against a plain byte table loop on
+ * a buffer that fits in the cache.
+ *
+ * usage: CrcBenchmark [buffer size] [passes]
+ *
+ * gcc -O2 -DCRC_USE_HARDWARE=0 -DCRC_SLICE_BY=8 -I.. CrcBenchmark.c ../CRC.c -o CrcBenchmark
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "CRC.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if (CRC_USE_HARDWARE != 0)
+#error "build with -DCRC_USE_HARDWARE=0, there's no CRC peripheral on the host"
+#endif
+
+#define CRC_BENCHMARK_CHECK_SIZE		(300)
+
+#define CRC_BENCHMARK_ALIGNMENTS		(8)
+
+#define CRC_BENCHMARK_SIZE_DEFAULT		(4096)
+
+#define CRC_BENCHMARK_PASSES_DEFAULT	(50000)
+
+/* CRC-16/ARC, the standard CRC.h is set up for, reflected */
+#define CRC_BENCHMARK_POLYNOMIAL		(0xA001)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static double CrcBenchmark_GetTime(void);
+
+static crc_t CrcBenchmark_Bitwise(uint8_t const * Message, uint32_t nBytes);
+
+static crc_t CrcBenchmark_ByteLut(uint8_t const * Message, uint32_t nBytes);
+
+static uint32_t CrcBenchmark_Check(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static crc_t CrcBenchmarkLut[256];
+
+static uint8_t CrcBenchmarkCheckBuffer[CRC_BENCHMARK_CHECK_SIZE + CRC_BENCHMARK_ALIGNMENTS];
+
+/* the result of every pass goes here so the loops aren't optimized away */
+static volatile crc_t CrcBenchmarkSink;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char ** argv)
+{
+	uint32_t BufferSize = CRC_BENCHMARK_SIZE_DEFAULT;
+	uint32_t Passes = CRC_BENCHMARK_PASSES_DEFAULT;
+	uint8_t * Buffer;
+	uint32_t Failures;
+	uint32_t Pass;
+	uint32_t ByteOffset;
+	uint32_t TableIndex;
+	uint32_t BitIndex;
+	crc_t Remainder;
+	double StartTime;
+	double SliceTime;
+	double LutTime;
+	double Megabytes;
+
+	if(argc > 1)
+	{
+		BufferSize = (uint32_t)strtoul(argv[1], NULL, 10);
+	}
+
+	if(argc > 2)
+	{
+		Passes = (uint32_t)strtoul(argv[2], NULL, 10);
+	}
+
+	/* the usual byte table, what CRC_SLICE_BY 1 does */
+	for(TableIndex = 0; TableIndex < 256; TableIndex++)
+	{
+		Remainder = (crc_t)TableIndex;
+
+		for(BitIndex = 0; BitIndex < 8; BitIndex++)
+		{
+			Remainder = (Remainder & 1) ? ((Remainder >> 1) ^ CRC_BENCHMARK_POLYNOMIAL) : (Remainder >> 1);
+		}
+
+		CrcBenchmarkLut[TableIndex] = Remainder;
+	}
+
+	Failures = CrcBenchmark_Check();
+
+	Buffer = malloc(BufferSize);
+
+	if(Buffer == NULL)
+	{
+		return EXIT_FAILURE;
+	}
+
+	for(ByteOffset = 0; ByteOffset < BufferSize; ByteOffset++)
+	{
+		Buffer[ByteOffset] = (uint8_t)rand();
+	}
+
+	if(Crc_Finish(Crc_Update(Crc_Begin(), Buffer, BufferSize)) != CrcBenchmark_ByteLut(Buffer, BufferSize))
+	{
+		printf("benchmark buffer: slice and byte table differ\n");
+		Failures++;
+	}
+
+	StartTime = CrcBenchmark_GetTime();
+
+	for(Pass = 0; Pass < Passes; Pass++)
+	{
+		CrcBenchmarkSink = Crc_Finish(Crc_Update(Crc_Begin(), Buffer, BufferSize));
+	}
+
+	SliceTime = CrcBenchmark_GetTime() - StartTime;
+
+	StartTime = CrcBenchmark_GetTime();
+
+	for(Pass = 0; Pass < Passes; Pass++)
+	{
+		CrcBenchmarkSink = CrcBenchmark_ByteLut(Buffer, BufferSize);
+	}
+
+	LutTime = CrcBenchmark_GetTime() - StartTime;
+
+	Megabytes = ((double)BufferSize * (double)Passes) / 1000000.0;
+
+	printf("%s slice by %d, %u bytes x %u passes\n", CRC_NAME, CRC_SLICE_BY, BufferSize, Passes);
+	printf("Crc_Update  %8.1f MB/s\n", Megabytes / SliceTime);
+	printf("byte table  %8.1f MB/s\n", Megabytes / LutTime);
+	printf("%u failures\n", Failures);
+
+	free(Buffer);
+
+	return (Failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static uint32_t CrcBenchmark_Check(void)
+{
+	uint32_t Failures = 0;
+	uint32_t Alignment;
+	uint32_t Size;
+	uint32_t ByteOffset;
+	uint32_t ChunkSize;
+	crc_t Expected;
+	crc_t Remainder;
+	uint8_t * Message;
+
+	for(ByteOffset = 0; ByteOffset < sizeof(CrcBenchmarkCheckBuffer); ByteOffset++)
+	{
+		CrcBenchmarkCheckBuffer[ByteOffset] = (uint8_t)rand();
+	}
+
+	if(Crc_FastCalculation((uint8_t const *)"123456789", 9) != CRC_CHECK_VALUE)
+	{
+		printf("check value: got 0x%04X\n", Crc_FastCalculation((uint8_t const *)"123456789", 9));
+		Failures++;
+	}
+
+	for(Alignment = 0; Alignment < CRC_BENCHMARK_ALIGNMENTS; Alignment++)
+	{
+		for(Size = 0; Size <= CRC_BENCHMARK_CHECK_SIZE; Size++)
+		{
+			Message = &CrcBenchmarkCheckBuffer[Alignment];
+			Expected = CrcBenchmark_Bitwise(Message, Size);
+
+			/* whole, then in chunks that split the slices anywhere */
+			Remainder = Crc_Update(Crc_Begin(), Message, Size);
+
+			if((Crc_Finish(Remainder) != Expected) || (Crc_FastCalculation(Message, (int16_t)Size) != Expected))
+			{
+				if(Failures < 10)
+				{
+					printf("size %u, alignment %u: got 0x%04X, expected 0x%04X\n", Size, Alignment, \
+							Crc_Finish(Remainder), Expected);
+				}
+
+				Failures++;
+			}
+
+			Remainder = Crc_Begin();
+			ByteOffset = 0;
+
+			while(ByteOffset < Size)
+			{
+				ChunkSize = (uint32_t)(rand() % 20);
+
+				if(ChunkSize > (Size - ByteOffset))
+				{
+					ChunkSize = Size - ByteOffset;
+				}
+
+				Remainder = Crc_Update(Remainder, &Message[ByteOffset], ChunkSize);
+				ByteOffset += ChunkSize;
+			}
+
+			if(Crc_Finish(Remainder) != Expected)
+			{
+				if(Failures < 10)
+				{
+					printf("size %u, alignment %u in chunks: got 0x%04X, expected 0x%04X\n", Size, Alignment, \
+							Crc_Finish(Remainder), Expected);
+				}
+
+				Failures++;
+			}
+		}
+	}
+
+	return Failures;
+}
+
+static crc_t CrcBenchmark_Bitwise(uint8_t const * Message, uint32_t nBytes)
+{
+	crc_t Remainder = CRC_INITIAL_REMAINDER;
+	uint8_t BitIndex;
+
+	while(nBytes--)
+	{
+		Remainder ^= *Message++;
+
+		for(BitIndex = 0; BitIndex < 8; BitIndex++)
+		{
+			Remainder = (Remainder & 1) ? ((Remainder >> 1) ^ CRC_BENCHMARK_POLYNOMIAL) : (Remainder >> 1);
+		}
+	}
+
+	return (crc_t)(Remainder ^ CRC_FINAL_XOR_VALUE);
+}
+
+static crc_t CrcBenchmark_ByteLut(uint8_t const * Message, uint32_t nBytes)
+{
+	crc_t Remainder = CRC_INITIAL_REMAINDER;
+
+	while(nBytes--)
+	{
+		Remainder = CrcBenchmarkLut[(Remainder ^ *Message++) & 0xFF] ^ (Remainder >> 8);
+	}
+
+	return (crc_t)(Remainder ^ CRC_FINAL_XOR_VALUE);
+}
+
+static double CrcBenchmark_GetTime(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (double)Now.tv_sec + ((double)Now.tv_nsec / 1000000000.0);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -162,6 +162,9 @@ static bool isCardPresent = false;
 static int8_t LogMessage[DATALOGGER_MAX_LOG_MESSAGE];
 
 static uint8_t CardDetectTimer;
+
+/* deepest the log queue has been */
+static uint8_t MaxPendingLogs = 0;
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                      Functions Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -249,6 +252,11 @@ uint32_t DataLogger_PostEvent(uint8_t * pLogMessage, uint8_t *pLogData, uint16_t
 			SET_FLAG(DataLogger_Event,DATA_LOGGER_POST_EVENT);
 
 			PendingLogs++;
+
+			if(PendingLogs > MaxPendingLogs)
+			{
+				MaxPendingLogs = PendingLogs;
+			}
 		}
 
 		PostEventStatus = DATA_LOGGER_OK;
@@ -333,6 +341,11 @@ uint32_t DataLogger_PostEvent(uint8_t * pLogMessage, uint8_t *pLogData, uint16_t
 
 		xQueueSend(DataLoggerMessageQueue, &MessageToPost, 0);
 
+		if(uxQueueMessagesWaiting(DataLoggerMessageQueue) > MaxPendingLogs)
+		{
+			MaxPendingLogs = uxQueueMessagesWaiting(DataLoggerMessageQueue);
+		}
+
 		PostEventStatus = DATA_LOGGER_OK;
 	}
 
@@ -380,6 +393,24 @@ void Datalogger_Task (void * param)
 #endif
 
 
+uint8_t DataLogger_GetPendingLogs(void)
+{
+	uint8_t Pending;
+
+#ifndef FSL_RTOS_FREE_RTOS
+	Pending = PendingLogs;
+#else
+	Pending = uxQueueMessagesWaiting(DataLoggerMessageQueue);
+#endif
+
+	return (Pending);
+}
+
+uint8_t DataLogger_GetMaxPendingLogs(void)
+{
+	return (MaxPendingLogs);
+}
+
 static void DataLogger_WriteMessage(datalogger_event_t * EventPost)
 {
 	uint32_t	BytesWritten;
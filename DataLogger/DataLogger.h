@@ -82,6 +82,10 @@ uint32_t DataLogger_Init(void);
 
 uint32_t DataLogger_PostEvent(uint8_t * pLogMessage, uint8_t *pLogData, uint16_t LogDataSize);
 
+uint8_t DataLogger_GetPendingLogs(void);
+
+uint8_t DataLogger_GetMaxPendingLogs(void);
+
 #ifndef FSL_RTOS_FREE_RTOS
 
 void Datalogger_Task (void);
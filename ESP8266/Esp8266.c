@@ -57,10 +57,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define ESP8266_TIMEOUT						(100)
 
-#define ESP8266_RESET_TIMER					(1000)
+/* upper bound for the ready URC after a reset */
+#define ESP8266_RESET_TIMER					(3000)
 
 #define ESP8266_DISCONNECT_COUNTER			(5)
 
+/* +++ needs 1s of silence around it, the SW timer first tick can come right away */
+#define ESP8266_PASSTHROUGH_GUARD_TIME		(1100)
+
 #ifdef FSL_RTOS_FREE_RTOS
 #define ESP8266_STACK_SIZE					(256)
 
@@ -68,6 +72,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define ESP8266_SELF_EVENT					(1 << 0)
 
+/* the batch and the send flags are shared between the app tasks and the AT task */
+#define ESP8266_ENTER_CRITICAL()			taskENTER_CRITICAL()
+
+#define ESP8266_EXIT_CRITICAL()				taskEXIT_CRITICAL()
+#else
+#define ESP8266_ENTER_CRITICAL()
+
+#define ESP8266_EXIT_CRITICAL()
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -78,7 +90,8 @@ typedef enum
 	ESP8266_STATUS_SERVER_ENABLED = 0,
 	ESP8266_STATUS_AP_ENABLED,
 	ESP8266_STATUS_WIFI_CONNECTED,
-	ESP8266_STATUS_MUX_ENABLED
+	ESP8266_STATUS_MUX_ENABLED,
+	ESP8266_STATUS_PASSTHROUGH_ENABLED
 }esp8266_internal_commands_status_t;
 
 typedef enum
@@ -88,7 +101,10 @@ typedef enum
 	ESP8266_COMMAND_GENERATE_EVENT,
 	ESP8266_OK_RECEIVED,
 	ESP8366_COMMAND_TIMEOUT_EVENT,
-	ESP8366_START_TIMER_EVENT
+	ESP8366_START_TIMER_EVENT,
+	ESP8266_PASSTHROUGH_REQUESTED,
+	ESP8266_UDP_BATCH_IN_PROGRESS,
+	ESP8266_TCP_SEND_IN_PROGRESS
 }esp8266_commands_status_t;
 
 typedef enum
@@ -101,9 +117,26 @@ typedef enum
 	ESP8266_INIT_DONE_STATE,
 	ESP8266_ENABLE_MULT_CONNECTIONS_STATE,
 	ESP8266_DISABLE_ECHO_STATE,
+	ESP8266_PASSTHROUGH_SINGLE_CONNECTION_STATE,
+	ESP8266_PASSTHROUGH_MODE_STATE,
+	ESP8266_PASSTHROUGH_CONNECT_STATE,
+	ESP8266_PASSTHROUGH_SEND_STATE,
+	ESP8266_PASSTHROUGH_ESCAPE_STATE,
+	ESP8266_PASSTHROUGH_EXIT_STATE,
+	ESP8266_PASSTHROUGH_CLOSE_STATE,
+	ESP8266_PASSTHROUGH_ABORT_STATE,
+	ESP8266_PASSTHROUGH_RESTORE_MUX_STATE,
+	ESP8266_WAIT_READY_STATE,
 	ESP8266_MAX_STATE
 }esp8266_states_t;
 
+typedef struct
+{
+	uint8_t Link;
+	uint16_t Offset;
+	uint16_t Size;
+}esp8266_datagram_t;
+
 enum esp8266_commands_t
 {
 	ESP8266_DISABLE_ECHO_COMMAND = 0,
@@ -122,6 +155,7 @@ enum esp8266_commands_t
 	ESP8266_CONNECT_TO_SERVER_COMMAND,
 	ESP8266_AUTO_CONNECT_COMMAND,
 	ESP8266_POLL_STATUS_COMMAND,
+	ESP8266_TRANSPARENT_MODE_COMMAND,
 	ESP8266_MAX_COMMAND
 };
 
@@ -149,16 +183,34 @@ bool AtCommand_TcpDataReceivedCallbak(uint8_t * Parameters, uint16_t ParametersS
 
 bool AtCommand_TcpSendOkCallbak(uint8_t * Parameters, uint16_t ParametersSize);
 
+bool AtCommand_TcpSendFailCallbak(uint8_t * Parameters, uint16_t ParametersSize);
+
 bool AtCommand_FailCallbak(uint8_t * Parameters, uint16_t ParametersSize);
 
 bool AtCommand_JoinStatus(uint8_t * Parameters, uint16_t ParametersSize);
 
 bool AtCommand_TcpSendDataCallback(uint8_t * Parameters, uint16_t ParametersSize);
 
+bool AtCommand_SingleLinkStatusCallback(uint8_t * Parameters, uint16_t ParametersSize);
+
+bool AtCommand_SendBytesReceivedCallback(uint8_t * Parameters, uint16_t ParametersSize);
+
+bool AtCommand_ReadyCallback(uint8_t * Parameters, uint16_t ParametersSize);
+
 void Esp8266_TimerCallback (void * Args);
 
 void Esp8266_ResetTimerCallback(void * Args);
 
+void Esp8266_PassthroughTimerCallback(void * Args);
+
+static uint16_t Esp8266_BuildLinkParameters(const uint8_t * LinkType, uint8_t * IpAddressString, uint16_t PortNumber, uint16_t ParameterOffset);
+
+static esp8266_tcp_callback_t Esp8266_GetLinkCallback(uint16_t Link);
+
+static void Esp8266_UdpSendNextDatagram(void);
+
+static void Esp8266_UdpBatchReset(void);
+
 static void Esp8266_IdleState(void);
 
 static void Esp8266_WaitOkState(void);
@@ -175,6 +227,25 @@ static void Esp8266_EnableMultipleConnectionsState(void);
 
 static void Esp8266_DisableEchoState(void);
 
+static void Esp8266_PassthroughSingleConnectionState(void);
+
+static void Esp8266_PassthroughModeState(void);
+
+static void Esp8266_PassthroughConnectState(void);
+
+static void Esp8266_PassthroughSendState(void);
+
+static void Esp8266_PassthroughEscapeState(void);
+
+static void Esp8266_PassthroughExitState(void);
+
+static void Esp8266_PassthroughCloseState(void);
+
+static void Esp8266_PassthroughAbortState(void);
+
+static void Esp8266_PassthroughRestoreMuxState(void);
+
+static void Esp8266_WaitReadyState(void);
 
 static void (* Esp8266_StateMachineFunctions[ESP8266_MAX_STATE])(void) =
 {
@@ -185,7 +256,17 @@ static void (* Esp8266_StateMachineFunctions[ESP8266_MAX_STATE])(void) =
 		Esp8266_TimeoutState,
 		Esp8266_InitDoneState,
 		Esp8266_EnableMultipleConnectionsState,
-		Esp8266_DisableEchoState
+		Esp8266_DisableEchoState,
+		Esp8266_PassthroughSingleConnectionState,
+		Esp8266_PassthroughModeState,
+		Esp8266_PassthroughConnectState,
+		Esp8266_PassthroughSendState,
+		Esp8266_PassthroughEscapeState,
+		Esp8266_PassthroughExitState,
+		Esp8266_PassthroughCloseState,
+		Esp8266_PassthroughAbortState,
+		Esp8266_PassthroughRestoreMuxState,
+		Esp8266_WaitReadyState
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -210,10 +291,11 @@ const uint8_t * AtCommandTable[ESP8266_MAX_COMMAND] =
 		(uint8_t *)"CIPSTART",			/* 13 - connects to a tcp server			*/
 		(uint8_t *)"CWAUTOCONN",		/* 14 - Enables auto connect				*/
 		(uint8_t *)"AT",				/* 15 - polling command						*/
+		(uint8_t *)"CIPMODE",			/* 16 - transparent transmission mode		*/
 
 };
 
-const AtCommandResponse_t AtCommandsResponseTable[12] =
+const AtCommandResponse_t AtCommandsResponseTable[17] =
 {
 		{
 			(uint8_t*)"OK",
@@ -255,6 +337,11 @@ const AtCommandResponse_t AtCommandsResponseTable[12] =
 			7,
 			AtCommand_TcpSendOkCallbak
 		},
+		{
+			(uint8_t*)"SEND FAIL",
+			9,
+			AtCommand_TcpSendFailCallbak
+		},
 		{
 			(uint8_t*)"FAIL",
 			4,
@@ -275,6 +362,26 @@ const AtCommandResponse_t AtCommandsResponseTable[12] =
 			7,
 			AtCommand_JoinStatus
 		},
+		{
+			(uint8_t*)"CONNECT",
+			7,
+			AtCommand_SingleLinkStatusCallback
+		},
+		{
+			(uint8_t*)"CLOSED",
+			6,
+			AtCommand_SingleLinkStatusCallback
+		},
+		{
+			(uint8_t*)"Recv ",
+			5,
+			AtCommand_SendBytesReceivedCallback
+		},
+		{
+			(uint8_t*)"ready",
+			5,
+			AtCommand_ReadyCallback
+		},
 };
 
 static const uint8_t TcpConnectString[] =
@@ -286,6 +393,21 @@ static const uint8_t TcpDisconnectString[] =
 {
 		"CLOSED"
 };
+
+static const uint8_t ReadyString[] =
+{
+		"ready"
+};
+
+static const uint8_t PassthroughEscapeString[] =
+{
+		"+++"
+};
+
+static const uint8_t DataReceivedHeaderString[] =
+{
+		"\r\n+IPD,"
+};
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                   Static Constants Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -309,6 +431,8 @@ static esp8266_callback_t AppGenericEventsCallback;
 
 static esp8266_tcp_callback_t AppTcpCallback;
 
+static esp8266_tcp_callback_t AppUdpCallback;
+
 static esp8266_events_t EventToReport;
 
 static uint16_t ServerPortNumber = 0;
@@ -327,6 +451,27 @@ static swtimer_t ResetTimer = 0xFF;
 
 static uint8_t DisconnectCounter = ESP8266_DISCONNECT_COUNTER;
 
+static swtimer_t PassthroughGuardTimer = 0xFF;
+
+static uint8_t * PassthroughIpAddress;
+
+static uint16_t PassthroughPortNumber;
+
+/* links opened by us (TCP client or UDP), these don't count as server connections */
+static uint8_t ClientLinks = 0;
+
+static uint8_t UdpLinks = 0;
+
+static esp8266_datagram_t UdpBatch[ESP8266_UDP_BATCH_SIZE];
+
+static uint8_t UdpBatchBuffer[ESP8266_UDP_BATCH_BUFFER_SIZE];
+
+static uint16_t UdpBatchBufferOffset = 0;
+
+static uint8_t UdpBatchPending = 0;
+
+static uint8_t UdpBatchCurrent = 0;
+
 #ifdef FSL_RTOS_FREE_RTOS
 
 static EventGroupHandle_t Esp8266_Event = NULL;
@@ -348,6 +493,7 @@ void Esp8266_Init(esp8266_callback_t Callback)
 
 	CommandTimer = SWTimer_AllocateChannel(ESP8266_TIMEOUT,Esp8266_TimerCallback,NULL);
 	ResetTimer  = SWTimer_AllocateChannel(ESP8266_RESET_TIMER,Esp8266_ResetTimerCallback,NULL);
+	PassthroughGuardTimer = SWTimer_AllocateChannel(ESP8266_PASSTHROUGH_GUARD_TIME,Esp8266_PassthroughTimerCallback,NULL);
 
 	StatusRegister = 0;
 
@@ -400,16 +546,33 @@ esp8266_status_t Esp8266_Reset(void)
 {
 	esp8266_status_t Status = ESP8266_SUCCESS;
 
-	/* TODO: Polling mechanism to identify if the device is connected or not */
-	AtCommands_EnableUartRx(false);
+	/* a reset is how a stuck session is recovered, transparent transmission doesn't */
+	/* survive it and the boot frames must go through the response table again		*/
+	AtCommands_EnableRawMode(false);
+
+	SWTimer_DisableTimer(PassthroughGuardTimer);
+
+	CLEAR_FLAG(StatusRegister,ESP8266_STATUS_PASSTHROUGH_ENABLED);
+	CLEAR_FLAG(CommandStatusRegister,ESP8266_PASSTHROUGH_REQUESTED);
+	CLEAR_FLAG(CommandStatusRegister,ESP8366_COMMAND_TIMEOUT_EVENT);
+	CLEAR_FLAG(CommandStatusRegister,ESP8266_SM_PROCESSING);
+
+	/* RX stays enabled, the module reports ready once it's done booting */
+	AtCommands_EnableUartRx(true);
 
 	AtCommands_ResetModule();
 
+	/* nothing sent before the reset is going to be confirmed */
+	CLEAR_FLAG(CommandStatusRegister,ESP8266_TCP_SEND_IN_PROGRESS);
+
+	Esp8266_UdpBatchReset();
+
+	Esp8266_States.CurrentState = ESP8266_WAIT_READY_STATE;
 	Esp8266_States.NextState = ESP8266_DISABLE_ECHO_STATE;
 
 	//ATCommands_ExecuteCommand((uint8_t*)AtCommandTable[ESP8266_RESET_COMMAND]);
 
-	/* Trigger a timer, more or less 1 seconds (empiric time)			*/
+	/* in case ready is lost among the boot messages, move on anyway after a while */
 	SWTimer_EnableTimer(ResetTimer);
 
 	return Status;
@@ -615,29 +778,53 @@ esp8266_status_t Esp8266_ShutdownServer(void)
 
 esp8266_status_t Esp8266_TcpSendData(uint32_t ConnectionNumber, uint8_t * DataToSend, uint16_t DataSize)
 {
+	esp8266_status_t Status = ESP8266_INVALID_STATE;
 	uint16_t ParameterOffset = 0;
 
+	/* CIPSEND with parameters is not accepted on transparent transmission */
+	if(!CHECK_FLAG(StatusRegister,ESP8266_STATUS_PASSTHROUGH_ENABLED))
+	{
+		ESP8266_ENTER_CRITICAL();
+
+		/* the prompt can't be shared with a UDP batch or a previous send until SEND OK */
+		if((!CHECK_FLAG(CommandStatusRegister,ESP8266_UDP_BATCH_IN_PROGRESS)) && \
+				(!CHECK_FLAG(CommandStatusRegister,ESP8266_TCP_SEND_IN_PROGRESS)))
+		{
+			SET_FLAG(CommandStatusRegister,ESP8266_TCP_SEND_IN_PROGRESS);
 
-	MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
-	/* back up to send later */
-	TcpSendDataBuffer = DataToSend;
+			Status = ESP8266_SUCCESS;
+		}
+		else
+		{
+			Status = ESP8266_BUSY;
+		}
+
+		ESP8266_EXIT_CRITICAL();
+	}
 
-	TcpSendDataSize = DataSize;
+	if(Status == ESP8266_SUCCESS)
+	{
+		MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
+		/* back up to send later */
+		TcpSendDataBuffer = DataToSend;
 
-	/* AT+CIPSEND = Connection,DataSize 		*/
-	/* Once that send, module will reply with >	*/
-	/* and the data must be sent then 			*/
-	ParameterOffset = MiscFunctions_IntegerToAscii(ConnectionNumber,&ParametersBuffer[0]);
+		TcpSendDataSize = DataSize;
 
-	ParametersBuffer[ParameterOffset] = ',';
+		/* AT+CIPSEND = Connection,DataSize 		*/
+		/* Once that send, module will reply with >	*/
+		/* and the data must be sent then 			*/
+		ParameterOffset = MiscFunctions_IntegerToAscii(ConnectionNumber,&ParametersBuffer[0]);
 
-	ParameterOffset++;
+		ParametersBuffer[ParameterOffset] = ',';
 
-	MiscFunctions_IntegerToAscii(DataSize,&ParametersBuffer[ParameterOffset]);
+		ParameterOffset++;
 
-	ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_SOCKET_SEND_COMMAND],&ParametersBuffer[0]);
+		MiscFunctions_IntegerToAscii(DataSize,&ParametersBuffer[ParameterOffset]);
 
-	return ESP8266_SUCCESS;
+		ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_SOCKET_SEND_COMMAND],&ParametersBuffer[0]);
+	}
+
+	return Status;
 
 }
 
@@ -656,7 +843,6 @@ esp8266_status_t Esp8266_TcpClose(uint32_t ConnectionNumber)
 esp8266_status_t Esp8266_ConnectToTcpServer(uint8_t * IpAddressString, uint16_t PortNumber, esp8266_tcp_callback_t TcpCallback)
 {
 	esp8266_status_t Status = ESP8266_WIFI_NOT_CONNECTED;
-	uint16_t StringSize;
 	uint16_t ParameterOffset = 0;
 
 	MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
@@ -675,29 +861,16 @@ esp8266_status_t Esp8266_ConnectToTcpServer(uint8_t * IpAddressString, uint16_t
 
 			ParameterOffset += 1;
 
-			MiscFunctions_MemCopy((uint8_t*)"\"TCP\",\"", &ParametersBuffer[ParameterOffset], 7);
-
-			ParameterOffset += 7;
-
-			StringSize = strlen((char*)IpAddressString);
-
-			MiscFunctions_MemCopy(IpAddressString, &ParametersBuffer[ParameterOffset], StringSize);
-
-			ParameterOffset += StringSize;
-
-			ParametersBuffer[ParameterOffset] = '"';
-
-			ParameterOffset += 1;
-
-			ParametersBuffer[ParameterOffset] = ',';
-
-			ParameterOffset += 1;
-
-			ParameterOffset += MiscFunctions_IntegerToAscii(PortNumber,&ParametersBuffer[ParameterOffset]);
+			ParameterOffset = Esp8266_BuildLinkParameters((uint8_t*)"TCP", IpAddressString, PortNumber, ParameterOffset);
 
 			AppTcpCallback = TcpCallback;
 
+			SET_FLAG(ClientLinks,0);
+			CLEAR_FLAG(UdpLinks,0);
+
 			ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_CONNECT_TO_SERVER_COMMAND],&ParametersBuffer[0]);
+
+			Status = ESP8266_SUCCESS;
 		}
 	}
 
@@ -727,6 +900,200 @@ esp8266_status_t Esp8266_AutoConnect(bool isEnabled)
 	return ESP8266_SUCCESS;
 }
 
+esp8266_status_t Esp8266_OpenUdpSocket(uint8_t Link, uint8_t * IpAddressString, uint16_t RemotePort, uint16_t LocalPort, esp8266_tcp_callback_t UdpCallback)
+{
+	esp8266_status_t Status = ESP8266_WIFI_NOT_CONNECTED;
+	uint16_t ParameterOffset = 0;
+
+	if((IpAddressString == NULL) || (UdpCallback == NULL) || (Link >= ESP8266_MAX_LINKS))
+	{
+		Status = ESP8266_WRONG_PARAMETER;
+	}
+	else if(CHECK_FLAG(StatusRegister,ESP8266_STATUS_WIFI_CONNECTED))
+	{
+		if(CHECK_FLAG(StatusRegister,ESP8266_STATUS_MUX_ENABLED))
+		{
+			/* AT+CIPSTART=link,"UDP","ip",remote port,local port,0 */
+			MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
+
+			ParameterOffset += MiscFunctions_IntegerToAscii(Link,&ParametersBuffer[ParameterOffset]);
+
+			ParametersBuffer[ParameterOffset] = ',';
+
+			ParameterOffset += 1;
+
+			ParameterOffset = Esp8266_BuildLinkParameters((uint8_t*)"UDP", IpAddressString, RemotePort, ParameterOffset);
+
+			ParametersBuffer[ParameterOffset] = ',';
+
+			ParameterOffset += 1;
+
+			ParameterOffset += MiscFunctions_IntegerToAscii(LocalPort,&ParametersBuffer[ParameterOffset]);
+
+			/* mode 0, the remote peer is fixed */
+			ParametersBuffer[ParameterOffset] = ',';
+
+			ParameterOffset += 1;
+
+			ParametersBuffer[ParameterOffset] = '0';
+
+			AppUdpCallback = UdpCallback;
+
+			SET_FLAG(ClientLinks,Link);
+			SET_FLAG(UdpLinks,Link);
+
+			/* there's no handshake, the module replies link,CONNECT right away */
+			ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_CONNECT_TO_SERVER_COMMAND],&ParametersBuffer[0]);
+
+			Status = ESP8266_SUCCESS;
+		}
+		else
+		{
+			Status = ESP8266_INVALID_STATE;
+		}
+	}
+
+	return Status;
+}
+
+esp8266_status_t Esp8266_UdpSendData(uint8_t Link, uint8_t * DataToSend, uint16_t DataSize)
+{
+	esp8266_status_t Status = ESP8266_WRONG_PARAMETER;
+	bool isBatchStarted = false;
+
+	if((DataToSend != NULL) && (DataSize != 0) && (Link < ESP8266_MAX_LINKS) && CHECK_FLAG(UdpLinks,Link))
+	{
+		ESP8266_ENTER_CRITICAL();
+
+		/* the TCP send owns the prompt and the send buffers until its SEND OK */
+		if(CHECK_FLAG(CommandStatusRegister,ESP8266_TCP_SEND_IN_PROGRESS))
+		{
+			Status = ESP8266_BUSY;
+		}
+		else if((UdpBatchPending < ESP8266_UDP_BATCH_SIZE) && \
+				((UdpBatchBufferOffset + DataSize) <= ESP8266_UDP_BATCH_BUFFER_SIZE))
+		{
+			/* fire and forget: data is copied so the caller doesn't wait for SEND OK */
+			MiscFunctions_MemCopy(DataToSend, &UdpBatchBuffer[UdpBatchBufferOffset], DataSize);
+
+			UdpBatch[UdpBatchPending].Link = Link;
+			UdpBatch[UdpBatchPending].Offset = UdpBatchBufferOffset;
+			UdpBatch[UdpBatchPending].Size = DataSize;
+
+			UdpBatchBufferOffset += DataSize;
+
+			UdpBatchPending++;
+
+			/* if the batch is already going out, this datagram is sent after the current ones */
+			if(!CHECK_FLAG(CommandStatusRegister,ESP8266_UDP_BATCH_IN_PROGRESS))
+			{
+				SET_FLAG(CommandStatusRegister,ESP8266_UDP_BATCH_IN_PROGRESS);
+
+				isBatchStarted = true;
+			}
+
+			Status = ESP8266_SUCCESS;
+		}
+		else
+		{
+			Status = ESP8266_BUFFER_FULL;
+		}
+
+		ESP8266_EXIT_CRITICAL();
+
+		/* the AT command is issued out of the critical section */
+		if(isBatchStarted == true)
+		{
+			Esp8266_UdpSendNextDatagram();
+		}
+	}
+
+	return Status;
+}
+
+esp8266_status_t Esp8266_StartPassthrough(uint8_t * IpAddressString, uint16_t PortNumber, esp8266_tcp_callback_t TcpCallback)
+{
+	esp8266_status_t Status = ESP8266_WIFI_NOT_CONNECTED;
+
+	if((IpAddressString == NULL) || (TcpCallback == NULL))
+	{
+		Status = ESP8266_WRONG_PARAMETER;
+	}
+	else if(CHECK_FLAG(StatusRegister,ESP8266_STATUS_PASSTHROUGH_ENABLED))
+	{
+		Status = ESP8266_INVALID_STATE;
+	}
+	else if(CHECK_FLAG(StatusRegister,ESP8266_STATUS_WIFI_CONNECTED))
+	{
+		/* the link is created later on by the SM, IP string must remain valid until then */
+		PassthroughIpAddress = IpAddressString;
+
+		PassthroughPortNumber = PortNumber;
+
+		AppTcpCallback = TcpCallback;
+
+		SET_FLAG(CommandStatusRegister,ESP8266_PASSTHROUGH_REQUESTED);
+
+		/* transparent transmission is only supported on single connection mode */
+		Esp8266_States.CurrentState = ESP8266_PASSTHROUGH_SINGLE_CONNECTION_STATE;
+
+		#ifdef FSL_RTOS_FREE_RTOS
+		xEventGroupSetBits(Esp8266_Event, ESP8266_SELF_EVENT);
+		#endif
+
+		Status = ESP8266_SUCCESS;
+	}
+
+	return Status;
+}
+
+esp8266_status_t Esp8266_PassthroughSendData(uint8_t * DataToSend, uint16_t DataSize)
+{
+	esp8266_status_t Status = ESP8266_INVALID_STATE;
+	AtCommandsStatus_t SendStatus;
+
+	if((DataToSend == NULL) || (DataSize == 0))
+	{
+		Status = ESP8266_WRONG_PARAMETER;
+	}
+	else if(CHECK_FLAG(StatusRegister,ESP8266_STATUS_PASSTHROUGH_ENABLED))
+	{
+		/* no CIPSEND, no prompt and no SEND OK. The UART goes straight to the link */
+		SendStatus = ATCommands_SendRawData(DataToSend,DataSize);
+
+		if(SendStatus == ATCOMMANDS_OK)
+		{
+			Status = ESP8266_SUCCESS;
+		}
+		else
+		{
+			Status = ESP8266_WRONG_PARAMETER;
+		}
+	}
+
+	return Status;
+}
+
+esp8266_status_t Esp8266_StopPassthrough(void)
+{
+	esp8266_status_t Status = ESP8266_INVALID_STATE;
+
+	if(CHECK_FLAG(StatusRegister,ESP8266_STATUS_PASSTHROUGH_ENABLED))
+	{
+		/* no more data from the application, +++ must be surrounded by silence */
+		CLEAR_FLAG(StatusRegister,ESP8266_STATUS_PASSTHROUGH_ENABLED);
+
+		Esp8266_States.CurrentState = ESP8266_TIMEOUT_STATE;
+		Esp8266_States.NextState = ESP8266_PASSTHROUGH_ESCAPE_STATE;
+
+		SWTimer_EnableTimer(PassthroughGuardTimer);
+
+		Status = ESP8266_SUCCESS;
+	}
+
+	return Status;
+}
+
 static void Esp8266_IdleState(void)
 {
 
@@ -843,6 +1210,229 @@ static void Esp8266_EnableMultipleConnectionsState(void)
 	#endif
 }
 
+static void Esp8266_WaitReadyState(void)
+{
+
+}
+
+static void Esp8266_PassthroughSingleConnectionState(void)
+{
+	MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
+
+	SET_FLAG(CommandStatusRegister,ESP8266_SM_PROCESSING);
+
+	ParametersBuffer[0] = (uint8_t)'0';
+
+	ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_SET_CONNECTIONS_COMMAND],&ParametersBuffer[0]);
+
+	Esp8266_States.CurrentState = ESP8266_WAIT_OK_STATE;
+	Esp8266_States.NextState = ESP8266_PASSTHROUGH_MODE_STATE;
+}
+
+static void Esp8266_PassthroughModeState(void)
+{
+	/* CIPMUX=0 was acknowledged, MUX only APIs are rejected from now on */
+	CLEAR_FLAG(StatusRegister,ESP8266_STATUS_MUX_ENABLED);
+
+	/* AT+CIPMODE=1 */
+	MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
+
+	SET_FLAG(CommandStatusRegister,ESP8266_SM_PROCESSING);
+
+	ParametersBuffer[0] = (uint8_t)'1';
+
+	ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_TRANSPARENT_MODE_COMMAND],&ParametersBuffer[0]);
+
+	Esp8266_States.CurrentState = ESP8266_WAIT_OK_STATE;
+	Esp8266_States.NextState = ESP8266_PASSTHROUGH_CONNECT_STATE;
+}
+
+static void Esp8266_PassthroughConnectState(void)
+{
+	/* AT+CIPSTART="TCP","ip",port */
+	MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
+
+	SET_FLAG(CommandStatusRegister,ESP8266_SM_PROCESSING);
+
+	(void)Esp8266_BuildLinkParameters((uint8_t*)"TCP", PassthroughIpAddress, PassthroughPortNumber, 0);
+
+	ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_CONNECT_TO_SERVER_COMMAND],&ParametersBuffer[0]);
+
+	Esp8266_States.CurrentState = ESP8266_WAIT_OK_STATE;
+	Esp8266_States.NextState = ESP8266_PASSTHROUGH_SEND_STATE;
+}
+
+static void Esp8266_PassthroughSendState(void)
+{
+	/* AT+CIPSEND without parameters, the prompt is handled by the send data callback */
+	Esp8266_States.CurrentState = ESP8266_IDLE_STATE;
+
+	ATCommands_ExecuteCommand((uint8_t*)AtCommandTable[ESP8266_SOCKET_SEND_COMMAND]);
+}
+
+static void Esp8266_PassthroughEscapeState(void)
+{
+	ATCommands_SendRawData((uint8_t*)&PassthroughEscapeString[0],sizeof(PassthroughEscapeString) - 1u);
+
+	/* silence after +++ as well, then the module is back on command mode */
+	Esp8266_States.CurrentState = ESP8266_TIMEOUT_STATE;
+	Esp8266_States.NextState = ESP8266_PASSTHROUGH_EXIT_STATE;
+
+	SWTimer_EnableTimer(PassthroughGuardTimer);
+}
+
+static void Esp8266_PassthroughExitState(void)
+{
+	/* AT+CIPMODE=0 */
+	AtCommands_EnableRawMode(false);
+
+	MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
+
+	SET_FLAG(CommandStatusRegister,ESP8266_SM_PROCESSING);
+
+	ParametersBuffer[0] = (uint8_t)'0';
+
+	ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_TRANSPARENT_MODE_COMMAND],&ParametersBuffer[0]);
+
+	Esp8266_States.CurrentState = ESP8266_WAIT_OK_STATE;
+	Esp8266_States.NextState = ESP8266_PASSTHROUGH_CLOSE_STATE;
+}
+
+static void Esp8266_PassthroughCloseState(void)
+{
+	/* the link survives the escape sequence, MUX can't be enabled with it open */
+	SET_FLAG(CommandStatusRegister,ESP8266_SM_PROCESSING);
+
+	ATCommands_ExecuteCommand((uint8_t*)AtCommandTable[ESP8266_CLOSE_SOCKET_COMMAND]);
+
+	Esp8266_States.CurrentState = ESP8266_WAIT_OK_STATE;
+	Esp8266_States.NextState = ESP8266_PASSTHROUGH_RESTORE_MUX_STATE;
+}
+
+static void Esp8266_PassthroughAbortState(void)
+{
+	/* AT+CIPMODE=0, a start that failed on CIPSTART has no link to close */
+	MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
+
+	SET_FLAG(CommandStatusRegister,ESP8266_SM_PROCESSING);
+
+	ParametersBuffer[0] = (uint8_t)'0';
+
+	ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_TRANSPARENT_MODE_COMMAND],&ParametersBuffer[0]);
+
+	Esp8266_States.CurrentState = ESP8266_WAIT_OK_STATE;
+	Esp8266_States.NextState = ESP8266_PASSTHROUGH_RESTORE_MUX_STATE;
+}
+
+static void Esp8266_PassthroughRestoreMuxState(void)
+{
+	MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
+
+	ParametersBuffer[0] = (uint8_t)'1';
+
+	SET_FLAG(CommandStatusRegister,ESP8266_COMMAND_GENERATE_EVENT);
+	SET_FLAG(StatusRegister,ESP8266_STATUS_MUX_ENABLED);
+
+	EventToReport = ESP8266_PASSTHROUGH_STOPPED_EVENT;
+
+	ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_SET_CONNECTIONS_COMMAND],&ParametersBuffer[0]);
+
+	Esp8266_States.CurrentState = ESP8266_IDLE_STATE;
+}
+
+static void Esp8266_UdpSendNextDatagram(void)
+{
+	uint16_t ParameterOffset;
+
+	/* AT+CIPSEND=link,size, the prompt callback sends the datagram */
+	MiscFunctions_MemClear(&ParametersBuffer[0],PARAMETERS_BUFFER_SIZE);
+
+	TcpSendDataBuffer = &UdpBatchBuffer[UdpBatch[UdpBatchCurrent].Offset];
+
+	TcpSendDataSize = UdpBatch[UdpBatchCurrent].Size;
+
+	ParameterOffset = MiscFunctions_IntegerToAscii(UdpBatch[UdpBatchCurrent].Link,&ParametersBuffer[0]);
+
+	ParametersBuffer[ParameterOffset] = ',';
+
+	ParameterOffset++;
+
+	MiscFunctions_IntegerToAscii(TcpSendDataSize,&ParametersBuffer[ParameterOffset]);
+
+	ATCommands_SetCommand((uint8_t*)AtCommandTable[ESP8266_SOCKET_SEND_COMMAND],&ParametersBuffer[0]);
+}
+
+static void Esp8266_UdpBatchReset(void)
+{
+	ESP8266_ENTER_CRITICAL();
+
+	UdpBatchPending = 0;
+	UdpBatchCurrent = 0;
+	UdpBatchBufferOffset = 0;
+
+	CLEAR_FLAG(CommandStatusRegister,ESP8266_UDP_BATCH_IN_PROGRESS);
+
+	ESP8266_EXIT_CRITICAL();
+}
+
+static esp8266_tcp_callback_t Esp8266_GetLinkCallback(uint16_t Link)
+{
+	esp8266_tcp_callback_t LinkCallback = AppTcpCallback;
+
+	if((Link < ESP8266_MAX_LINKS) && CHECK_FLAG(UdpLinks,Link))
+	{
+		LinkCallback = AppUdpCallback;
+	}
+
+	return LinkCallback;
+}
+
+static uint16_t Esp8266_BuildLinkParameters(const uint8_t * LinkType, uint8_t * IpAddressString, uint16_t PortNumber, uint16_t ParameterOffset)
+{
+	uint16_t StringSize;
+
+	/* "type","ip",port */
+	ParametersBuffer[ParameterOffset] = '"';
+
+	ParameterOffset += 1;
+
+	StringSize = strlen((char*)LinkType);
+
+	MiscFunctions_MemCopy(LinkType, &ParametersBuffer[ParameterOffset], StringSize);
+
+	ParameterOffset += StringSize;
+
+	ParametersBuffer[ParameterOffset] = '"';
+
+	ParameterOffset += 1;
+
+	ParametersBuffer[ParameterOffset] = ',';
+
+	ParameterOffset += 1;
+
+	ParametersBuffer[ParameterOffset] = '"';
+
+	ParameterOffset += 1;
+
+	StringSize = strlen((char*)IpAddressString);
+
+	MiscFunctions_MemCopy(IpAddressString, &ParametersBuffer[ParameterOffset], StringSize);
+
+	ParameterOffset += StringSize;
+
+	ParametersBuffer[ParameterOffset] = '"';
+
+	ParameterOffset += 1;
+
+	ParametersBuffer[ParameterOffset] = ',';
+
+	ParameterOffset += 1;
+
+	ParameterOffset += MiscFunctions_IntegerToAscii(PortNumber,&ParametersBuffer[ParameterOffset]);
+
+	return ParameterOffset;
+}
+
 void Esp8266_ResetTimerCallback(void * Args)
 {
 	SWTimer_DisableTimer(ResetTimer);
@@ -864,14 +1454,35 @@ void Esp8266_TimerCallback (void * Args)
 	#endif
 }
 
+void Esp8266_PassthroughTimerCallback(void * Args)
+{
+	SET_FLAG(CommandStatusRegister,ESP8366_COMMAND_TIMEOUT_EVENT);
+	SWTimer_DisableTimer(PassthroughGuardTimer);
+
+	#ifdef FSL_RTOS_FREE_RTOS
+	xEventGroupSetBits(Esp8266_Event, ESP8266_SELF_EVENT);
+	#endif
+}
+
 static void Esp8266_AtCommandsCallback(AtCommandsEvent_t Event, uint8_t*Data, uint16_t DataSize)
 {
 	uint16_t NewConnectionHandle;
 	static uint16_t ConnectionToRefused = 0xFF;
-	uint8_t StringStatus;
+	int32_t MatchPosition;
 
 	if(Event == ATCOMMANDS_RESPONSE_NOT_FOUND_EVENT)
 	{
+		/* the boot banner comes on the same frame as ready, so the table entry misses it */
+		if(Esp8266_States.CurrentState == ESP8266_WAIT_READY_STATE)
+		{
+			MatchPosition = MiscFunctions_SearchInString(Data,DataSize,&ReadyString[0],sizeof(ReadyString) - 1u);
+
+			if(MatchPosition != MISC_FUNCTIONS_NOT_FOUND)
+			{
+				(void)AtCommand_ReadyCallback(Data,DataSize);
+			}
+		}
+
 		/* process custom responses */
 
 		/* for now, the only custom response is the connection which comes on the form of 	*/
@@ -881,12 +1492,17 @@ static void Esp8266_AtCommandsCallback(AtCommandsEvent_t Event, uint8_t*Data, ui
 		/* get the connection number */
 		NewConnectionHandle = MiscFunctions_AsciiToUnsignedInteger(Data);
 		/* now just confirm is "CONNECT" or "CLOSE" the rest of the text								*/
-		StringStatus = MiscFunctions_SearchInString(Data,0,&TcpConnectString[0],sizeof(TcpConnectString) - 1u);
+		MatchPosition = MiscFunctions_SearchInString(Data,DataSize,&TcpConnectString[0],sizeof(TcpConnectString) - 1u);
 
-		if(StringStatus == STRING_OK)
+		if(MatchPosition != MISC_FUNCTIONS_NOT_FOUND)
 		{
+			/* links we opened are always accepted */
+			if((NewConnectionHandle < ESP8266_MAX_LINKS) && CHECK_FLAG(ClientLinks,NewConnectionHandle))
+			{
+				Esp8266_GetLinkCallback(NewConnectionHandle)(ESP8266_TCP_SERVER_NEW_CONNECTION_EVENT,NewConnectionHandle,NULL,0);
+			}
 			/* confirm we can handle this connection or reject it otherwise AT+CIPCLOSE=X		*/
-			if(ServerConnectionsAvailable)
+			else if(ServerConnectionsAvailable)
 			{
 				/* ACK the upper layer a new connection is ready through the TCP callback			*/
 				/* connection ID																	*/
@@ -906,12 +1522,19 @@ static void Esp8266_AtCommandsCallback(AtCommandsEvent_t Event, uint8_t*Data, ui
 		}
 		else
 		{
-			StringStatus = MiscFunctions_SearchInString(Data,0,&TcpDisconnectString[0],sizeof(TcpDisconnectString) - 1u);
+			MatchPosition = MiscFunctions_SearchInString(Data,DataSize,&TcpDisconnectString[0],sizeof(TcpDisconnectString) - 1u);
 
-			if(StringStatus == STRING_OK)
+			if(MatchPosition != MISC_FUNCTIONS_NOT_FOUND)
 			{
+				if((NewConnectionHandle < ESP8266_MAX_LINKS) && CHECK_FLAG(ClientLinks,NewConnectionHandle))
+				{
+					Esp8266_GetLinkCallback(NewConnectionHandle)(ESP8266_TCP_SERVER_CONNECTION_CLOSED_EVENT,NewConnectionHandle,NULL,0);
+
+					CLEAR_FLAG(ClientLinks,NewConnectionHandle);
+					CLEAR_FLAG(UdpLinks,NewConnectionHandle);
+				}
 				/* just report when a valid connection was closed */
-				if(ConnectionToRefused != NewConnectionHandle)
+				else if(ConnectionToRefused != NewConnectionHandle)
 				{
 					AppTcpCallback(ESP8266_TCP_SERVER_CONNECTION_CLOSED_EVENT,NewConnectionHandle,NULL,0);
 					ServerConnectionsAvailable++;
@@ -925,6 +1548,12 @@ static void Esp8266_AtCommandsCallback(AtCommandsEvent_t Event, uint8_t*Data, ui
 
 	}
 
+	if(Event == ATCOMMANDS_RAW_DATA_EVENT)
+	{
+		/* transparent transmission, everything received belongs to the single link */
+		AppTcpCallback(ESP8266_TCP_SERVER_DATA_RECEIVED_EVENT,0,Data,DataSize);
+	}
+
 	if(Event == ATCOMMANDS_COMMAND_TIMEOUT_ERROR_EVENT)
 	{
 		DisconnectCounter--;
@@ -940,6 +1569,9 @@ static void Esp8266_AtCommandsCallback(AtCommandsEvent_t Event, uint8_t*Data, ui
 		}
 		CLEAR_FLAG(CommandStatusRegister,ESP8266_COMMAND_GENERATE_EVENT);
 		CLEAR_FLAG(CommandStatusRegister,ESP8266_SM_PROCESSING);
+		CLEAR_FLAG(CommandStatusRegister,ESP8266_TCP_SEND_IN_PROGRESS);
+
+		Esp8266_UdpBatchReset();
 
 		Esp8266_States.CurrentState = ESP8266_IDLE_STATE;
 	}
@@ -978,6 +1610,53 @@ bool AtCommand_ErrorCallback(uint8_t * Parameters, uint16_t ParametersSize)
 {
 	bool Status = false;
 
+	/* a failed passthrough step would leave the SM waiting for an OK forever and the	*/
+	/* module half configured, what was acknowledged is undone the way a stop does it	*/
+	/* and ends with ESP8266_PASSTHROUGH_STOPPED_EVENT. Other flows are left as they were	*/
+	if(CHECK_FLAG(CommandStatusRegister,ESP8266_SM_PROCESSING) && \
+			(Esp8266_States.CurrentState == ESP8266_WAIT_OK_STATE) && \
+			(Esp8266_States.NextState >= ESP8266_PASSTHROUGH_SINGLE_CONNECTION_STATE) && \
+			(Esp8266_States.NextState <= ESP8266_PASSTHROUGH_RESTORE_MUX_STATE))
+	{
+		CLEAR_FLAG(CommandStatusRegister,ESP8266_SM_PROCESSING);
+
+		if(Esp8266_States.NextState == ESP8266_PASSTHROUGH_MODE_STATE)
+		{
+			/* CIPMUX=0 refused, nothing changed on the module */
+			Esp8266_States.CurrentState = ESP8266_IDLE_STATE;
+		}
+		else if(Esp8266_States.NextState == ESP8266_PASSTHROUGH_CONNECT_STATE)
+		{
+			/* CIPMODE=1 refused, only MUX is off */
+			Esp8266_States.CurrentState = ESP8266_PASSTHROUGH_RESTORE_MUX_STATE;
+		}
+		else if(Esp8266_States.NextState == ESP8266_PASSTHROUGH_SEND_STATE)
+		{
+			/* CIPSTART refused (server unreachable), MUX off and CIPMODE=1 */
+			Esp8266_States.CurrentState = ESP8266_PASSTHROUGH_ABORT_STATE;
+		}
+		else
+		{
+			/* a stop keeps going, the link can be gone already when closing it */
+			Esp8266_States.CurrentState = Esp8266_States.NextState;
+		}
+	}
+	else if(CHECK_FLAG(CommandStatusRegister,ESP8266_PASSTHROUGH_REQUESTED))
+	{
+		/* CIPSEND refused with the link open, same as a stop after the escape sequence */
+		Esp8266_States.CurrentState = ESP8266_PASSTHROUGH_EXIT_STATE;
+	}
+
+	#ifdef FSL_RTOS_FREE_RTOS
+	xEventGroupSetBits(Esp8266_Event, ESP8266_SELF_EVENT);
+	#endif
+
+	CLEAR_FLAG(CommandStatusRegister,ESP8266_PASSTHROUGH_REQUESTED);
+	CLEAR_FLAG(CommandStatusRegister,ESP8266_TCP_SEND_IN_PROGRESS);
+
+	/* whatever was left on the batch is dropped */
+	Esp8266_UdpBatchReset();
+
 	/* report error to upper layer */
 	AppGenericEventsCallback(ESP8266_ERROR_EVENT,ESP8266_EVENT_ERROR_STATUS);
 
@@ -1063,6 +1742,26 @@ bool AtCommand_EchoOffCallbak(uint8_t * Parameters, uint16_t ParametersSize)
 	return Status;
 }
 
+bool AtCommand_TcpSendFailCallbak(uint8_t * Parameters, uint16_t ParametersSize)
+{
+	bool Status = false;
+
+	/* the link dropped mid-send, nothing else is coming to release the prompt */
+	CLEAR_FLAG(CommandStatusRegister,ESP8266_TCP_SEND_IN_PROGRESS);
+
+	/* the rest of the batch would go to the same dead link */
+	Esp8266_UdpBatchReset();
+
+	AppGenericEventsCallback(ESP8266_ERROR_EVENT,ESP8266_EVENT_ERROR_STATUS);
+
+	if(ParametersSize)
+	{
+		Status = true;
+	}
+
+	return Status;
+}
+
 bool AtCommand_FailCallbak(uint8_t * Parameters, uint16_t ParametersSize)
 {
 	bool Status = false;
@@ -1103,7 +1802,21 @@ bool AtCommand_TcpSendDataCallback(uint8_t * Parameters, uint16_t ParametersSize
 {
 	bool Status = false;
 
-	ATCommands_SendCustomCommand(TcpSendDataBuffer,TcpSendDataSize);
+	if(CHECK_FLAG(CommandStatusRegister,ESP8266_PASSTHROUGH_REQUESTED))
+	{
+		CLEAR_FLAG(CommandStatusRegister,ESP8266_PASSTHROUGH_REQUESTED);
+
+		SET_FLAG(StatusRegister,ESP8266_STATUS_PASSTHROUGH_ENABLED);
+
+		/* from now on, everything on the UART is link data */
+		AtCommands_EnableRawMode(true);
+
+		AppGenericEventsCallback(ESP8266_PASSTHROUGH_STARTED_EVENT,ESP8266_EVENT_OK_STATUS);
+	}
+	else
+	{
+		ATCommands_SendCustomCommand(TcpSendDataBuffer,TcpSendDataSize);
+	}
 
 	if(ParametersSize)
 	{
@@ -1113,26 +1826,110 @@ bool AtCommand_TcpSendDataCallback(uint8_t * Parameters, uint16_t ParametersSize
 	return Status;
 }
 
+bool AtCommand_SingleLinkStatusCallback(uint8_t * Parameters, uint16_t ParametersSize)
+{
+	bool Status = false;
+
+	/* single connection mode reports CONNECT/CLOSED without link ID 	*/
+	/* nothing to do here, the OK that follows moves the SM				*/
+	if(ParametersSize)
+	{
+		Status = true;
+	}
+
+	return Status;
+}
+
+bool AtCommand_ReadyCallback(uint8_t * Parameters, uint16_t ParametersSize)
+{
+	/* only meaningful after a reset, otherwise is ignored */
+	if(Esp8266_States.CurrentState == ESP8266_WAIT_READY_STATE)
+	{
+		SWTimer_DisableTimer(ResetTimer);
+
+		Esp8266_States.CurrentState = Esp8266_States.NextState;
+
+		#ifdef FSL_RTOS_FREE_RTOS
+		xEventGroupSetBits(Esp8266_Event, ESP8266_SELF_EVENT);
+		#endif
+	}
+
+	return false;
+}
+
+bool AtCommand_SendBytesReceivedCallback(uint8_t * Parameters, uint16_t ParametersSize)
+{
+	bool Status = false;
+
+	/* Recv x bytes comes before SEND OK, keep going to get it */
+	if(ParametersSize)
+	{
+		Status = true;
+	}
+
+	return Status;
+}
+
 bool AtCommand_TcpDataReceivedCallbak(uint8_t * Parameters, uint16_t ParametersSize)
 {
 	uint32_t ConnectionNumber;
 	uint32_t DataSize;
 	uint8_t * DataSizeString;
 	uint8_t * ReceivedData;
+	uint16_t DataAvailable;
+	uint16_t DatagramSize;
+
+	/* data is received on the following command: +IPD,connection,datasize:data... 	*/
+	/* datagrams received back to back come on the same frame, one +IPD each		*/
+	while((Parameters != NULL) && (ParametersSize > 0))
+	{
+		/* extract connection, data size and pointer to the data */
+		ConnectionNumber = MiscFunctions_AsciiToUnsignedInteger(Parameters);
 
-	/* data is received on the following command: +IPD,connection,datasize:data... */
+		DataSizeString = MiscFunctions_FindTokenInString(Parameters, ',');
 
-	/* extract connection, data size and pointer to the data */
-	ConnectionNumber = MiscFunctions_AsciiToUnsignedInteger(Parameters);
+		if(DataSizeString == NULL)
+		{
+			break;
+		}
 
-	DataSizeString = MiscFunctions_FindTokenInString(Parameters, ',');
+		DataSize = MiscFunctions_AsciiToUnsignedInteger(DataSizeString);
 
-	DataSize = MiscFunctions_AsciiToUnsignedInteger(DataSizeString);
+		ReceivedData = MiscFunctions_FindTokenInString(DataSizeString, ':');
 
-	ReceivedData = MiscFunctions_FindTokenInString(DataSizeString, ':');
+		if((ReceivedData == NULL) || ((uint32_t)(ReceivedData - Parameters) > ParametersSize))
+		{
+			break;
+		}
 
-	/* upper layer must copy the data, after returning callback, the data is not valid */
-	AppTcpCallback(ESP8266_TCP_SERVER_DATA_RECEIVED_EVENT,ConnectionNumber,ReceivedData,DataSize);
+		/* the size on the header can't be trusted past what was actually received */
+		DataAvailable = ParametersSize - (uint16_t)(ReceivedData - Parameters);
+
+		if(DataSize > DataAvailable)
+		{
+			DataSize = DataAvailable;
+		}
+
+		/* upper layer must copy the data, after returning callback, the data is not valid */
+		Esp8266_GetLinkCallback(ConnectionNumber)(ESP8266_TCP_SERVER_DATA_RECEIVED_EVENT,ConnectionNumber,ReceivedData,DataSize);
+
+		/* move to the next +IPD if any, its header must be within the frame too */
+		DatagramSize = (uint16_t)(&ReceivedData[DataSize] - Parameters) + (sizeof(DataReceivedHeaderString) - 1u);
+
+		if(DatagramSize > ParametersSize)
+		{
+			break;
+		}
+
+		if(STRING_OK != MiscFunction_StringCompare(&DataReceivedHeaderString[0],&ReceivedData[DataSize],sizeof(DataReceivedHeaderString) - 1u))
+		{
+			break;
+		}
+
+		Parameters += DatagramSize;
+
+		ParametersSize -= DatagramSize;
+	}
 
 	return false;
 }
@@ -1140,8 +1937,38 @@ bool AtCommand_TcpDataReceivedCallbak(uint8_t * Parameters, uint16_t ParametersS
 bool AtCommand_TcpSendOkCallbak(uint8_t * Parameters, uint16_t ParametersSize)
 {
 	bool Status = false;
+	bool isBatchDone = true;
+
+	if(CHECK_FLAG(CommandStatusRegister,ESP8266_UDP_BATCH_IN_PROGRESS))
+	{
+		/* no report on fire and forget datagrams, just keep draining the batch */
+		ESP8266_ENTER_CRITICAL();
 
-	AppTcpCallback(ESP8266_TCP_SERVER_DATA_SENT_EVENT,0xFF,NULL,0);
+		UdpBatchCurrent++;
+
+		if(UdpBatchCurrent < UdpBatchPending)
+		{
+			isBatchDone = false;
+		}
+		else
+		{
+			Esp8266_UdpBatchReset();
+		}
+
+		ESP8266_EXIT_CRITICAL();
+
+		if(isBatchDone == false)
+		{
+			Esp8266_UdpSendNextDatagram();
+		}
+	}
+	else
+	{
+		/* released before the report so the app can send again from the callback */
+		CLEAR_FLAG(CommandStatusRegister,ESP8266_TCP_SEND_IN_PROGRESS);
+
+		AppTcpCallback(ESP8266_TCP_SERVER_DATA_SENT_EVENT,0xFF,NULL,0);
+	}
 
 	if(ParametersSize)
 	{
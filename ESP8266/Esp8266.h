@@ -40,6 +40,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //                                  Defines & Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #define ESP8266_MAX_CONNECTIONS	(1)
+
+#define ESP8266_MAX_LINKS		(5)
+
+#define ESP8266_UDP_BATCH_SIZE			(4)
+
+#define ESP8266_UDP_BATCH_BUFFER_SIZE	(512)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                      Typedef Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -55,7 +61,10 @@ typedef enum
 {
 	ESP8266_SUCCESS = 0,
 	ESP8266_WRONG_PARAMETER,
-	ESP8266_WIFI_NOT_CONNECTED
+	ESP8266_WIFI_NOT_CONNECTED,
+	ESP8266_INVALID_STATE,
+	ESP8266_BUFFER_FULL,
+	ESP8266_BUSY
 }esp8266_status_t;
 
 typedef enum
@@ -71,6 +80,8 @@ typedef enum
 	ESP8266_ERROR_JOINING_WIFI_EVENT,
 	ESP8266_INVALID_EVENT,
 	ESP8266_AUTOCONN_EVENT,
+	ESP8266_PASSTHROUGH_STARTED_EVENT,
+	ESP8266_PASSTHROUGH_STOPPED_EVENT,
 }esp8266_events_t;
 
 typedef enum
@@ -152,6 +163,16 @@ esp8266_status_t Esp8266_ConnectToTcpServer(uint8_t * IpAddressString, uint16_t
 
 esp8266_status_t Esp8266_AutoConnect(bool isEnabled);
 
+esp8266_status_t Esp8266_OpenUdpSocket(uint8_t Link, uint8_t * IpAddressString, uint16_t RemotePort, uint16_t LocalPort, esp8266_tcp_callback_t UdpCallback);
+
+esp8266_status_t Esp8266_UdpSendData(uint8_t Link, uint8_t * DataToSend, uint16_t DataSize);
+
+esp8266_status_t Esp8266_StartPassthrough(uint8_t * IpAddressString, uint16_t PortNumber, esp8266_tcp_callback_t TcpCallback);
+
+esp8266_status_t Esp8266_PassthroughSendData(uint8_t * DataToSend, uint16_t DataSize);
+
+esp8266_status_t Esp8266_StopPassthrough(void);
+
 #if defined(__cplusplus)
 }
 #endif // __cplusplus
@@ -0,0 +1,971 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Host simulation of periodic telemetry pushes through the real Esp8266 and
+ * AtCommands code, comparing a TCP connection per push, a persistent TCP
+ * connection and a UDP socket. The UART runs at AT_COMMANDS_BAUDRATE, the
+ * SW timers tick every SWTIMER_BASE_TIME and the module answers the way the
+ * AT firmware does: TCP waits a round trip for the handshake, the ACK behind
+ * SEND OK and the close, UDP answers right away.
+ *
+ * Delivery is from the push call to the payload reaching the server, busy is
+ * how long the application waits for the driver before it can push again.
+ *
+ * usage: Esp8266Simulation [pushes] [round trip ms]
+ *
+ * gcc -O2 -I. -I.. -I../../ATCommands -I../../MiscFunctions -I../../RingBuffer \
+ *     -I../../SW_Timers -I../../StateMachine Esp8266Simulation.c ../Esp8266.c \
+ *     ../../ATCommands/AtCommands.c ../../MiscFunctions/MiscFunctions.c \
+ *     ../../RingBuffer/RingBuffer.c -o Esp8266Simulation
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "AtCommands.h"
+#include "AtCommandsPlatform.h"
+#include "SW_Timer.h"
+#include "Esp8266.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define SIM_MS_TO_NS(Milliseconds)		((uint64_t)(Milliseconds) * 1000000ULL)
+
+#define SIM_NS_TO_MS(Nanoseconds)		((double)(Nanoseconds) / 1000000.0)
+
+/* the main loop runs every step, well under a byte time */
+#define SIM_STEP_TIME					(10000ULL)
+
+/* start, 8 data and stop bits */
+#define SIM_BYTE_TIME					((10ULL * 1000000000ULL) / AT_COMMANDS_BAUDRATE)
+
+#define SIM_PUSHES_DEFAULT				(20)
+
+#define SIM_ROUND_TRIP_DEFAULT			(20)
+
+#define SIM_PUSH_PERIOD					(1000)
+
+/* any step taking longer than this is a stuck driver */
+#define SIM_STEP_LIMIT					(10000)
+
+#define SIM_MODULE_BOOT_TIME			(300)
+
+#define SIM_MODULE_JOIN_TIME			(2000)
+
+/* parsing and lwIP time on the module before it answers */
+#define SIM_MODULE_COMMAND_TIME			(1)
+
+#define SIM_UART_QUEUE_SIZE				(4096)
+
+#define SIM_REPLIES_MAX					(16)
+
+#define SIM_REPLY_SIZE					(64)
+
+#define SIM_LINE_SIZE					(256)
+
+#define SIM_PAYLOAD_SIZE_MAX			(256)
+
+#define SIM_TIMERS_MAX					(SWTIMER_MAX_TIMERS)
+
+#define SIM_TCP_LINK					(0)
+
+#define SIM_UDP_LINK					(1)
+
+#define SIM_SERVER_ADDRESS				"192.168.1.10"
+
+#define SIM_SERVER_PORT					(5000)
+
+#define SIM_LOCAL_PORT					(5001)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+	SIM_MODE_TCP_PER_PUSH = 0,
+	SIM_MODE_TCP_PERSISTENT,
+	SIM_MODE_UDP,
+	SIM_MODE_MAX
+}sim_mode_t;
+
+typedef enum
+{
+	SIM_APP_WAIT_CONFIG_STATE = 0,
+	SIM_APP_WAIT_NETWORK_STATE,
+	SIM_APP_WAIT_LINK_STATE,
+	SIM_APP_IDLE_STATE,
+	SIM_APP_WAIT_CONNECT_STATE,
+	SIM_APP_WAIT_SENT_STATE,
+	SIM_APP_WAIT_CLOSE_STATE,
+	SIM_APP_WAIT_DELIVERY_STATE,
+	SIM_APP_WAIT_MODE_CLOSE_STATE,
+	SIM_APP_DONE_STATE
+}sim_app_state_t;
+
+/* bytes on one direction of the UART, each with the time it's fully received */
+typedef struct
+{
+	uint8_t Data[SIM_UART_QUEUE_SIZE];
+	uint64_t Time[SIM_UART_QUEUE_SIZE];
+	uint16_t Head;
+	uint16_t Tail;
+	uint64_t LastTime;
+}sim_uart_queue_t;
+
+typedef struct
+{
+	uint64_t Time;
+	uint8_t Text[SIM_REPLY_SIZE];
+	bool isPending;
+}sim_reply_t;
+
+typedef struct
+{
+	uint32_t Counter;
+	uint32_t CounterReload;
+	bool isEnabled;
+	void (* Callback)(void *);
+	void * Args;
+}sim_timer_t;
+
+typedef struct
+{
+	uint32_t Pushes;
+	uint64_t DeliveryMin;
+	uint64_t DeliveryMax;
+	uint64_t DeliveryTotal;
+	uint64_t BusyTotal;
+	uint32_t UartBytes;
+}sim_mode_stats_t;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void Sim_UartQueuePush(sim_uart_queue_t * Queue, const uint8_t * Data, uint16_t Size);
+
+static void Sim_ServiceUart(void);
+
+static void Sim_ServiceTimers(void);
+
+static void Sim_ModuleReply(uint32_t Delay, const char * Text);
+
+static void Sim_ModuleServiceReplies(void);
+
+static void Sim_ModuleReceive(uint8_t Data);
+
+static void Sim_ModuleCommand(const char * Line);
+
+static void Sim_AppTask(void);
+
+static void Sim_AppStartMode(void);
+
+static void Sim_AppStartPush(void);
+
+static void Sim_AppPushDelivered(void);
+
+static void Sim_AppCallback(esp8266_events_t Event, esp8266_event_status_t Status);
+
+static void Sim_AppLinkCallback(esp8266_tcp_events_t Event, uint16_t Link, uint8_t * Data, uint16_t DataSize);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const char * const SimModeNames[SIM_MODE_MAX] =
+{
+	"tcp per push",
+	"tcp persistent",
+	"udp"
+};
+
+/* a typical sensor push */
+static const uint8_t SimTelemetry[] = "{\"id\":17,\"t\":23.45,\"h\":41.20,\"p\":1013.25,\"bat\":3.71,\"seq\":0}";
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t SimTime = 0;
+
+static uint64_t SimRoundTrip;
+
+static uint32_t SimPushesPerMode = SIM_PUSHES_DEFAULT;
+
+static uint32_t SimErrors = 0;
+
+/* platform side */
+static sim_uart_queue_t SimToModule;
+
+static sim_uart_queue_t SimFromModule;
+
+static AtCommandsPlatformCallback_t SimUartCallback = NULL;
+
+static AtCommandsPlatformTimeoutCallback_t SimCharacterTimeoutCallback = NULL;
+
+static uint64_t SimCharacterTimeout;
+
+static uint64_t SimCharacterTimeoutDeadline;
+
+static bool isSimCharacterTimeoutRunning = false;
+
+static bool isSimRxEnabled = true;
+
+static sim_timer_t SimTimers[SIM_TIMERS_MAX];
+
+static uint8_t SimTimersAllocated = 0;
+
+static uint32_t SimTickCount = 0;
+
+static uint64_t SimNextTick = SIM_MS_TO_NS(SWTIMER_BASE_TIME);
+
+/* module side */
+static bool isModuleInReset = false;
+
+static bool isModuleEchoEnabled = true;
+
+static bool ModuleUdpLinks[ESP8266_MAX_LINKS];
+
+static char ModuleLine[SIM_LINE_SIZE];
+
+static uint16_t ModuleLineSize = 0;
+
+static uint8_t ModulePayload[SIM_PAYLOAD_SIZE_MAX];
+
+static uint16_t ModulePayloadSize = 0;
+
+static uint16_t ModulePayloadExpected = 0;
+
+static uint8_t ModulePayloadLink;
+
+static sim_reply_t ModuleReplies[SIM_REPLIES_MAX];
+
+/* server side */
+static uint32_t ServerPayloads = 0;
+
+static uint32_t ServerCorruptPayloads = 0;
+
+static uint64_t ServerLastTime;
+
+/* application side */
+static sim_app_state_t AppState = SIM_APP_WAIT_CONFIG_STATE;
+
+static uint64_t AppStateTime = 0;
+
+static sim_mode_t AppMode = SIM_MODE_TCP_PER_PUSH;
+
+static sim_mode_stats_t AppStats[SIM_MODE_MAX];
+
+static uint64_t AppPushTime;
+
+static uint64_t AppNextPushTime;
+
+static uint32_t AppUartBytesAtPush;
+
+static uint32_t AppUartBytes = 0;
+
+static bool isAppConfigured = false;
+
+static bool isAppNetworkConnected = false;
+
+static bool isAppLinkOpen = false;
+
+static bool isAppDataSent = false;
+
+static bool isAppBusyRecorded = false;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char * argv[])
+{
+	int ExitCode = EXIT_FAILURE;
+	sim_mode_stats_t * Stats;
+	uint8_t Mode;
+
+	SimRoundTrip = SIM_MS_TO_NS(SIM_ROUND_TRIP_DEFAULT);
+
+	if(argc >= 2)
+	{
+		SimPushesPerMode = (uint32_t)strtoul(argv[1], NULL, 0);
+	}
+
+	if(argc >= 3)
+	{
+		SimRoundTrip = SIM_MS_TO_NS(strtoul(argv[2], NULL, 0));
+	}
+
+	Esp8266_Init(Sim_AppCallback);
+
+	/* the bare metal main loop, everything else happens on the simulated ISRs */
+	while((AppState != SIM_APP_DONE_STATE) && ((SimTime - AppStateTime) < SIM_MS_TO_NS(SIM_STEP_LIMIT)))
+	{
+		SimTime += SIM_STEP_TIME;
+
+		Sim_ServiceTimers();
+
+		Sim_ModuleServiceReplies();
+
+		Sim_ServiceUart();
+
+		Esp8266_Task();
+
+		Sim_AppTask();
+	}
+
+	printf("round trip %.1f ms, %u pushes of %u bytes per mode, UART at %u baud\n\n", SIM_NS_TO_MS(SimRoundTrip), \
+			SimPushesPerMode, (uint32_t)(sizeof(SimTelemetry) - 1), AT_COMMANDS_BAUDRATE);
+
+	printf("%-16s %8s %8s %8s %8s %12s\n", "mode", "min ms", "avg ms", "max ms", "busy ms", "UART B/push");
+
+	for(Mode = 0; Mode < SIM_MODE_MAX; Mode++)
+	{
+		Stats = &AppStats[Mode];
+
+		if(Stats->Pushes > 0)
+		{
+			printf("%-16s %8.1f %8.1f %8.1f %8.1f %12u\n", SimModeNames[Mode], SIM_NS_TO_MS(Stats->DeliveryMin), \
+					SIM_NS_TO_MS(Stats->DeliveryTotal / Stats->Pushes), SIM_NS_TO_MS(Stats->DeliveryMax), \
+					SIM_NS_TO_MS(Stats->BusyTotal / Stats->Pushes), Stats->UartBytes / Stats->Pushes);
+		}
+	}
+
+	printf("\nerrors %u, corrupt payloads %u\n", SimErrors, ServerCorruptPayloads);
+
+	if(AppState != SIM_APP_DONE_STATE)
+	{
+		printf("stuck on application state %u, mode %s\n", AppState, SimModeNames[AppMode]);
+	}
+	else if((SimErrors == 0) && (ServerCorruptPayloads == 0))
+	{
+		ExitCode = EXIT_SUCCESS;
+	}
+
+	return ExitCode;
+}
+
+static void Sim_UartQueuePush(sim_uart_queue_t * Queue, const uint8_t * Data, uint16_t Size)
+{
+	/* bytes go out back to back, after whatever is still on the line */
+	if(Queue->LastTime < SimTime)
+	{
+		Queue->LastTime = SimTime;
+	}
+
+	while(Size--)
+	{
+		Queue->LastTime += SIM_BYTE_TIME;
+
+		Queue->Data[Queue->Head] = *Data++;
+		Queue->Time[Queue->Head] = Queue->LastTime;
+
+		Queue->Head = (Queue->Head + 1) % SIM_UART_QUEUE_SIZE;
+
+		AppUartBytes++;
+	}
+}
+
+static void Sim_ServiceUart(void)
+{
+	uint8_t Data;
+
+	while((SimToModule.Tail != SimToModule.Head) && (SimToModule.Time[SimToModule.Tail] <= SimTime))
+	{
+		Data = SimToModule.Data[SimToModule.Tail];
+		SimToModule.Tail = (SimToModule.Tail + 1) % SIM_UART_QUEUE_SIZE;
+
+		Sim_ModuleReceive(Data);
+	}
+
+	while((SimFromModule.Tail != SimFromModule.Head) && (SimFromModule.Time[SimFromModule.Tail] <= SimTime))
+	{
+		Data = SimFromModule.Data[SimFromModule.Tail];
+		SimFromModule.Tail = (SimFromModule.Tail + 1) % SIM_UART_QUEUE_SIZE;
+
+		if((isSimRxEnabled == true) && (SimUartCallback != NULL))
+		{
+			SimUartCallback(Data);
+		}
+	}
+
+	if((isSimCharacterTimeoutRunning == true) && (SimCharacterTimeoutDeadline <= SimTime))
+	{
+		SimCharacterTimeoutCallback();
+	}
+}
+
+/* same counting as SW_Timer.c, a tick can come right after a timer is enabled */
+static void Sim_ServiceTimers(void)
+{
+	uint8_t TimerOffset;
+
+	if(SimNextTick <= SimTime)
+	{
+		SimNextTick += SIM_MS_TO_NS(SWTIMER_BASE_TIME);
+		SimTickCount++;
+
+		for(TimerOffset = 0; TimerOffset < SimTimersAllocated; TimerOffset++)
+		{
+			if(SimTimers[TimerOffset].isEnabled == true)
+			{
+				SimTimers[TimerOffset].Counter--;
+
+				if(SimTimers[TimerOffset].Counter == 0)
+				{
+					SimTimers[TimerOffset].Counter = SimTimers[TimerOffset].CounterReload;
+					SimTimers[TimerOffset].Callback(SimTimers[TimerOffset].Args);
+				}
+			}
+		}
+	}
+}
+
+static void Sim_ModuleReply(uint32_t Delay, const char * Text)
+{
+	uint8_t ReplyOffset = 0;
+
+	while((ReplyOffset < SIM_REPLIES_MAX) && (ModuleReplies[ReplyOffset].isPending == true))
+	{
+		ReplyOffset++;
+	}
+
+	if(ReplyOffset < SIM_REPLIES_MAX)
+	{
+		ModuleReplies[ReplyOffset].Time = SimTime + SIM_MS_TO_NS(Delay);
+		ModuleReplies[ReplyOffset].isPending = true;
+
+		strncpy((char *)&ModuleReplies[ReplyOffset].Text[0], Text, SIM_REPLY_SIZE - 1);
+	}
+	else
+	{
+		printf("module reply queue full\n");
+		SimErrors++;
+	}
+}
+
+/* the oldest due reply goes out first */
+static void Sim_ModuleServiceReplies(void)
+{
+	sim_reply_t * NextReply;
+	uint8_t ReplyOffset;
+
+	do
+	{
+		NextReply = NULL;
+
+		for(ReplyOffset = 0; ReplyOffset < SIM_REPLIES_MAX; ReplyOffset++)
+		{
+			if((ModuleReplies[ReplyOffset].isPending == true) && (ModuleReplies[ReplyOffset].Time <= SimTime) && \
+					((NextReply == NULL) || (ModuleReplies[ReplyOffset].Time < NextReply->Time)))
+			{
+				NextReply = &ModuleReplies[ReplyOffset];
+			}
+		}
+
+		if(NextReply != NULL)
+		{
+			NextReply->isPending = false;
+
+			if(isModuleInReset == false)
+			{
+				Sim_UartQueuePush(&SimFromModule, &NextReply->Text[0], (uint16_t)strlen((char *)&NextReply->Text[0]));
+			}
+		}
+	}while(NextReply != NULL);
+}
+
+static void Sim_ModuleReceive(uint8_t Data)
+{
+	uint32_t Delay;
+	char Reply[SIM_REPLY_SIZE];
+
+	if(isModuleInReset == false)
+	{
+		if(ModulePayloadExpected > 0)
+		{
+			/* after the prompt exactly the announced size goes to the link */
+			ModulePayload[ModulePayloadSize++] = Data;
+
+			if(ModulePayloadSize == ModulePayloadExpected)
+			{
+				ModulePayloadExpected = 0;
+
+				snprintf(Reply, sizeof(Reply), "\r\nRecv %u bytes\r\n", ModulePayloadSize);
+				Sim_ModuleReply(SIM_MODULE_COMMAND_TIME, Reply);
+
+				/* TCP only reports SEND OK once the server ACKs */
+				Delay = SIM_MODULE_COMMAND_TIME;
+
+				if(ModuleUdpLinks[ModulePayloadLink] == false)
+				{
+					Delay += (uint32_t)(SimRoundTrip / SIM_MS_TO_NS(1));
+				}
+
+				Sim_ModuleReply(Delay, "\r\nSEND OK\r\n");
+
+				ServerLastTime = SimTime + (SimRoundTrip / 2);
+				ServerPayloads++;
+
+				if((ModulePayloadSize != (sizeof(SimTelemetry) - 1)) || \
+						(memcmp(&ModulePayload[0], &SimTelemetry[0], ModulePayloadSize) != 0))
+				{
+					ServerCorruptPayloads++;
+				}
+			}
+		}
+		else if(Data == '\n')
+		{
+			if((ModuleLineSize > 0) && (ModuleLine[ModuleLineSize - 1] == '\r'))
+			{
+				ModuleLineSize--;
+			}
+
+			ModuleLine[ModuleLineSize] = '\0';
+			ModuleLineSize = 0;
+
+			Sim_ModuleCommand(&ModuleLine[0]);
+		}
+		else if(ModuleLineSize < (SIM_LINE_SIZE - 1))
+		{
+			ModuleLine[ModuleLineSize++] = (char)Data;
+		}
+	}
+}
+
+static void Sim_ModuleCommand(const char * Line)
+{
+	uint32_t RoundTrip = (uint32_t)(SimRoundTrip / SIM_MS_TO_NS(1));
+	unsigned int Link;
+	unsigned int Size;
+	char Reply[SIM_REPLY_SIZE];
+
+	if(Line[0] == '\0')
+	{
+		/* the line end the driver appends to the payload */
+	}
+	else if(strcmp(Line, "ATE0") == 0)
+	{
+		/* the command itself is still echoed */
+		isModuleEchoEnabled = false;
+		Sim_ModuleReply(SIM_MODULE_COMMAND_TIME, "ATE0\r\n\r\nOK\r\n");
+	}
+	else if(strncmp(Line, "AT+CIPMUX=", 10) == 0)
+	{
+		Sim_ModuleReply(SIM_MODULE_COMMAND_TIME, "\r\nOK\r\n");
+	}
+	else if(strncmp(Line, "AT+CWJAP_CUR=", 13) == 0)
+	{
+		Sim_ModuleReply(SIM_MODULE_JOIN_TIME / 2, "WIFI CONNECTED\r\n");
+		Sim_ModuleReply(SIM_MODULE_JOIN_TIME, "WIFI GOT IP\r\n\r\nOK\r\n");
+	}
+	else if((sscanf(Line, "AT+CIPSTART=%u,", &Link) == 1) && (Link < ESP8266_MAX_LINKS))
+	{
+		ModuleUdpLinks[Link] = (strstr(Line, "\"UDP\"") != NULL) ? true : false;
+
+		snprintf(Reply, sizeof(Reply), "%u,CONNECT\r\n\r\nOK\r\n", Link);
+
+		/* SYN and SYN ACK, UDP has nothing to wait for */
+		Sim_ModuleReply(SIM_MODULE_COMMAND_TIME + ((ModuleUdpLinks[Link] == true) ? 0 : RoundTrip), Reply);
+	}
+	else if((sscanf(Line, "AT+CIPSEND=%u,%u", &Link, &Size) == 2) && (Link < ESP8266_MAX_LINKS) && \
+			(Size > 0) && (Size <= SIM_PAYLOAD_SIZE_MAX))
+	{
+		ModulePayloadLink = (uint8_t)Link;
+		ModulePayloadExpected = (uint16_t)Size;
+		ModulePayloadSize = 0;
+
+		Sim_ModuleReply(SIM_MODULE_COMMAND_TIME, "\r\nOK\r\n> ");
+	}
+	else if((sscanf(Line, "AT+CIPCLOSE=%u", &Link) == 1) && (Link < ESP8266_MAX_LINKS))
+	{
+		snprintf(Reply, sizeof(Reply), "%u,CLOSED\r\n\r\nOK\r\n", Link);
+
+		/* FIN and its ACK */
+		Sim_ModuleReply(SIM_MODULE_COMMAND_TIME + ((ModuleUdpLinks[Link] == true) ? 0 : RoundTrip), Reply);
+	}
+	else
+	{
+		printf("module: unexpected \"%s\"\n", Line);
+		Sim_ModuleReply(SIM_MODULE_COMMAND_TIME, "\r\nERROR\r\n");
+	}
+}
+
+static void Sim_AppTask(void)
+{
+	sim_app_state_t PreviousState = AppState;
+
+	switch(AppState)
+	{
+		case SIM_APP_WAIT_CONFIG_STATE:
+			if(isAppConfigured == true)
+			{
+				(void)Esp8266_ConnectToNetwork((uint8_t *)"telemetry", (uint8_t *)"password");
+				AppState = SIM_APP_WAIT_NETWORK_STATE;
+			}
+			break;
+		case SIM_APP_WAIT_NETWORK_STATE:
+			if(isAppNetworkConnected == true)
+			{
+				Sim_AppStartMode();
+			}
+			break;
+		case SIM_APP_WAIT_LINK_STATE:
+			if(isAppLinkOpen == true)
+			{
+				AppNextPushTime = SimTime;
+				AppState = SIM_APP_IDLE_STATE;
+			}
+			break;
+		case SIM_APP_IDLE_STATE:
+			if(SimTime >= AppNextPushTime)
+			{
+				Sim_AppStartPush();
+			}
+			break;
+		case SIM_APP_WAIT_CONNECT_STATE:
+			if(isAppLinkOpen == true)
+			{
+				isAppDataSent = false;
+				(void)Esp8266_TcpSendData(SIM_TCP_LINK, (uint8_t *)&SimTelemetry[0], sizeof(SimTelemetry) - 1);
+				AppState = SIM_APP_WAIT_SENT_STATE;
+			}
+			break;
+		case SIM_APP_WAIT_SENT_STATE:
+			if(isAppDataSent == true)
+			{
+				if(AppMode == SIM_MODE_TCP_PER_PUSH)
+				{
+					(void)Esp8266_TcpClose(SIM_TCP_LINK);
+					AppState = SIM_APP_WAIT_CLOSE_STATE;
+				}
+				else
+				{
+					AppStats[AppMode].BusyTotal += SimTime - AppPushTime;
+					isAppBusyRecorded = true;
+					AppState = SIM_APP_WAIT_DELIVERY_STATE;
+				}
+			}
+			break;
+		case SIM_APP_WAIT_CLOSE_STATE:
+			if(isAppLinkOpen == false)
+			{
+				AppStats[AppMode].BusyTotal += SimTime - AppPushTime;
+				isAppBusyRecorded = true;
+				AppState = SIM_APP_WAIT_DELIVERY_STATE;
+			}
+			break;
+		case SIM_APP_WAIT_DELIVERY_STATE:
+			/* the next push waits for the previous one to be fully done */
+			if((ServerPayloads > AppStats[AppMode].Pushes) && (isAppBusyRecorded == true))
+			{
+				Sim_AppPushDelivered();
+			}
+			break;
+		case SIM_APP_WAIT_MODE_CLOSE_STATE:
+			if(isAppLinkOpen == false)
+			{
+				AppMode++;
+				Sim_AppStartMode();
+			}
+			break;
+		case SIM_APP_DONE_STATE:
+		default:
+			break;
+	}
+
+	if(AppState != PreviousState)
+	{
+		AppStateTime = SimTime;
+	}
+}
+
+static void Sim_AppStartMode(void)
+{
+	ServerPayloads = 0;
+
+	if(AppMode == SIM_MODE_TCP_PER_PUSH)
+	{
+		AppNextPushTime = SimTime;
+		AppState = SIM_APP_IDLE_STATE;
+	}
+	else if(AppMode == SIM_MODE_TCP_PERSISTENT)
+	{
+		(void)Esp8266_ConnectToTcpServer((uint8_t *)SIM_SERVER_ADDRESS, SIM_SERVER_PORT, Sim_AppLinkCallback);
+		AppState = SIM_APP_WAIT_LINK_STATE;
+	}
+	else if(AppMode == SIM_MODE_UDP)
+	{
+		(void)Esp8266_OpenUdpSocket(SIM_UDP_LINK, (uint8_t *)SIM_SERVER_ADDRESS, SIM_SERVER_PORT, SIM_LOCAL_PORT, Sim_AppLinkCallback);
+		AppState = SIM_APP_WAIT_LINK_STATE;
+	}
+	else
+	{
+		AppState = SIM_APP_DONE_STATE;
+	}
+}
+
+static void Sim_AppStartPush(void)
+{
+	esp8266_status_t Status = ESP8266_SUCCESS;
+
+	/* everything on the UART since the previous push belongs to it, SEND OK and close included */
+	if(AppStats[AppMode].Pushes > 0)
+	{
+		AppStats[AppMode].UartBytes += AppUartBytes - AppUartBytesAtPush;
+	}
+
+	AppPushTime = SimTime;
+	AppNextPushTime = SimTime + SIM_MS_TO_NS(SIM_PUSH_PERIOD);
+	AppUartBytesAtPush = AppUartBytes;
+	isAppBusyRecorded = false;
+
+	if(AppStats[AppMode].Pushes == SimPushesPerMode)
+	{
+		/* links kept open are closed once the mode is done */
+		if(AppMode == SIM_MODE_TCP_PER_PUSH)
+		{
+			AppMode++;
+			Sim_AppStartMode();
+		}
+		else
+		{
+			(void)Esp8266_TcpClose((AppMode == SIM_MODE_UDP) ? SIM_UDP_LINK : SIM_TCP_LINK);
+			AppState = SIM_APP_WAIT_MODE_CLOSE_STATE;
+		}
+	}
+	else if(AppMode == SIM_MODE_TCP_PER_PUSH)
+	{
+		Status = Esp8266_ConnectToTcpServer((uint8_t *)SIM_SERVER_ADDRESS, SIM_SERVER_PORT, Sim_AppLinkCallback);
+		AppState = SIM_APP_WAIT_CONNECT_STATE;
+	}
+	else if(AppMode == SIM_MODE_TCP_PERSISTENT)
+	{
+		isAppDataSent = false;
+		Status = Esp8266_TcpSendData(SIM_TCP_LINK, (uint8_t *)&SimTelemetry[0], sizeof(SimTelemetry) - 1);
+		AppState = SIM_APP_WAIT_SENT_STATE;
+	}
+	else
+	{
+		/* fire and forget, the application is free as soon as the datagram is queued */
+		Status = Esp8266_UdpSendData(SIM_UDP_LINK, (uint8_t *)&SimTelemetry[0], sizeof(SimTelemetry) - 1);
+		isAppBusyRecorded = true;
+		AppState = SIM_APP_WAIT_DELIVERY_STATE;
+	}
+
+	if(Status != ESP8266_SUCCESS)
+	{
+		printf("push refused with %u on %s\n", Status, SimModeNames[AppMode]);
+		SimErrors++;
+	}
+}
+
+static void Sim_AppPushDelivered(void)
+{
+	sim_mode_stats_t * Stats = &AppStats[AppMode];
+	uint64_t Delivery = ServerLastTime - AppPushTime;
+
+	if((Stats->Pushes == 0) || (Delivery < Stats->DeliveryMin))
+	{
+		Stats->DeliveryMin = Delivery;
+	}
+
+	if(Delivery > Stats->DeliveryMax)
+	{
+		Stats->DeliveryMax = Delivery;
+	}
+
+	Stats->DeliveryTotal += Delivery;
+	Stats->Pushes++;
+
+	AppState = SIM_APP_IDLE_STATE;
+}
+
+static void Sim_AppCallback(esp8266_events_t Event, esp8266_event_status_t Status)
+{
+	if(Event == ESP8266_CONFIG_DONE_EVENT)
+	{
+		isAppConfigured = true;
+	}
+	else if(Event == ESP8266_NETWORK_CONNECTED_EVENT)
+	{
+		isAppNetworkConnected = true;
+	}
+	else if((Event == ESP8266_ERROR_EVENT) || (Status != ESP8266_EVENT_OK_STATUS))
+	{
+		printf("driver error event %u status %u\n", Event, Status);
+		SimErrors++;
+	}
+}
+
+static void Sim_AppLinkCallback(esp8266_tcp_events_t Event, uint16_t Link, uint8_t * Data, uint16_t DataSize)
+{
+	(void)Link;
+	(void)Data;
+	(void)DataSize;
+
+	if(Event == ESP8266_TCP_SERVER_NEW_CONNECTION_EVENT)
+	{
+		isAppLinkOpen = true;
+	}
+	else if(Event == ESP8266_TCP_SERVER_CONNECTION_CLOSED_EVENT)
+	{
+		isAppLinkOpen = false;
+	}
+	else if(Event == ESP8266_TCP_SERVER_DATA_SENT_EVENT)
+	{
+		isAppDataSent = true;
+	}
+}
+
+/* SW timers on simulated time */
+swtimer_t SWTimer_AllocateChannel(uint32_t Counter, void (* pTimerCallback)(void*), void * Args)
+{
+	swtimer_t Timer = 0xFF;
+
+	if(SimTimersAllocated < SIM_TIMERS_MAX)
+	{
+		Timer = SimTimersAllocated++;
+
+		SimTimers[Timer].CounterReload = (Counter >= SWTIMER_BASE_TIME) ? (Counter / SWTIMER_BASE_TIME) : 1;
+		SimTimers[Timer].Counter = SimTimers[Timer].CounterReload;
+		SimTimers[Timer].Callback = pTimerCallback;
+		SimTimers[Timer].Args = Args;
+	}
+
+	return Timer;
+}
+
+void SWTimer_EnableTimer(swtimer_t TimerToEnable)
+{
+	if(TimerToEnable < SimTimersAllocated)
+	{
+		SimTimers[TimerToEnable].isEnabled = true;
+	}
+}
+
+void SWTimer_DisableTimer(swtimer_t TimerToDisable)
+{
+	if(TimerToDisable < SimTimersAllocated)
+	{
+		SimTimers[TimerToDisable].isEnabled = false;
+		SimTimers[TimerToDisable].Counter = SimTimers[TimerToDisable].CounterReload;
+	}
+}
+
+uint32_t SWTimer_GetTickCount(void)
+{
+	return SimTickCount;
+}
+
+/* AT commands platform on the simulated UART */
+void AtCommands_PlatformUartInit(uint32_t BaudRate, AtCommandsPlatformCallback_t Callback)
+{
+	(void)BaudRate;
+
+	SimUartCallback = Callback;
+}
+
+void AtCommands_PlatformUartSend(uint8_t * CommandBuffer, uint16_t BufferSize)
+{
+	Sim_UartQueuePush(&SimToModule, CommandBuffer, BufferSize);
+}
+
+void AtCommands_PlatformUartEnableTx(bool isEnabled)
+{
+	(void)isEnabled;
+}
+
+void AtCommands_PlatformUartEnableRx(bool isEnabled)
+{
+	isSimRxEnabled = isEnabled;
+}
+
+void AtCommands_PlatformAssertReset(void)
+{
+	isModuleInReset = true;
+}
+
+void AtCommands_PlatformDeassertReset(void)
+{
+	isModuleInReset = false;
+	isModuleEchoEnabled = true;
+	ModuleLineSize = 0;
+	ModulePayloadExpected = 0;
+
+	/* the boot banner comes on the same frame as ready */
+	Sim_ModuleReply(SIM_MODULE_BOOT_TIME, "\r\nsimulated boot\r\n\r\nready\r\n");
+}
+
+void AtCommand_PlatformCharacterTimeoutInit(AtCommandsPlatformTimeoutCallback_t Callback, uint32_t Timeout)
+{
+	SimCharacterTimeoutCallback = Callback;
+	SimCharacterTimeout = SIM_MS_TO_NS(Timeout);
+}
+
+void AtCommand_PlatformCharacterTimeoutStart(void)
+{
+	SimCharacterTimeoutDeadline = SimTime + SimCharacterTimeout;
+	isSimCharacterTimeoutRunning = true;
+}
+
+void AtCommand_PlatformCharacterTimeoutStop(void)
+{
+	isSimCharacterTimeoutRunning = false;
+}
+
+void AtCommand_PlatformCharacterTimeoutRefresh(void)
+{
+	AtCommand_PlatformCharacterTimeoutStart();
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
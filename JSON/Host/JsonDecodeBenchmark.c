@@ -0,0 +1,404 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Cost of the typed value decoders against the C library conversions doing
+ * the same checks: the whole token has to be consumed and the value has to
+ * fit the target type. Both sides get the value tokens of the same parsed
+ * message, so only the conversion is timed, and their results have to agree
+ * before anything is timed. Fixed point values are q FractionBits, the C
+ * library side scales and rounds the double.
+ *
+ * usage: JsonDecodeBenchmark [passes]
+ *
+ * gcc -O2 -I. -I.. -I../jsmn -I../../MiscFunctions JsonDecodeBenchmark.c ../JsonParser.c \
+ *     ../jsmn/jsmn.c ../../MiscFunctions/MiscFunctions.c -lm -o JsonDecodeBenchmark
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include "fsl_common.h"
+#include "JsonParser.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define JSON_DECODE_BENCHMARK_PASSES_DEFAULT	(200000)
+
+#define JSON_DECODE_BENCHMARK_VALUES			(64)
+
+#define JSON_DECODE_BENCHMARK_MESSAGE_SIZE		(4096)
+
+#define JSON_DECODE_BENCHMARK_POOL_SIZE			(8192)
+
+#define JSON_DECODE_BENCHMARK_FRACTION_BITS		(8)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+	JSON_DECODE_BENCHMARK_UNSIGNED = 0,
+	JSON_DECODE_BENCHMARK_SIGNED,
+	JSON_DECODE_BENCHMARK_FIXED_POINT,
+	JSON_DECODE_BENCHMARK_KINDS
+}json_decode_benchmark_kind_t;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static double JsonDecodeBenchmark_GetTime(void);
+
+static uint16_t JsonDecodeBenchmark_BuildMessage(void);
+
+static status_t JsonDecodeBenchmark_Decoder(json_decode_benchmark_kind_t Kind, int32_t TokenIndex, int64_t * Value);
+
+static status_t JsonDecodeBenchmark_Library(json_decode_benchmark_kind_t Kind, int32_t TokenIndex, int64_t * Value);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const char * const JsonDecodeBenchmarkNames[JSON_DECODE_BENCHMARK_KINDS] =
+{
+	"unsigned", "signed", "fixed"
+};
+
+static const char * const JsonDecodeBenchmarkLibraryNames[JSON_DECODE_BENCHMARK_KINDS] =
+{
+	"strtoul", "strtol", "strtod"
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint8_t JsonDecodeBenchmarkMessage[JSON_DECODE_BENCHMARK_MESSAGE_SIZE];
+
+static uint8_t JsonDecodeBenchmarkMemory[JSON_DECODE_BENCHMARK_POOL_SIZE] __attribute__((aligned(4)));
+
+static jsonparser_pool_t JsonDecodeBenchmarkPool;
+
+static jsonparser_t JsonDecodeBenchmarkParser;
+
+static int32_t JsonDecodeBenchmarkTokens[JSON_DECODE_BENCHMARK_KINDS][JSON_DECODE_BENCHMARK_VALUES];
+
+/* the result of every conversion goes here so the loops aren't optimized away */
+static volatile int64_t JsonDecodeBenchmarkSink;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char ** argv)
+{
+	uint32_t Passes = JSON_DECODE_BENCHMARK_PASSES_DEFAULT;
+	uint32_t Pass;
+	uint32_t Kind;
+	uint32_t ValueIndex;
+	uint32_t Mismatches = 0;
+	uint16_t MessageSize;
+	int32_t TokenIndex;
+	int64_t DecoderValue;
+	int64_t LibraryValue;
+	status_t DecoderStatus;
+	status_t LibraryStatus;
+	double StartTime;
+	double DecoderTime;
+	double LibraryTime;
+	double Conversions;
+
+	if(argc > 1)
+	{
+		Passes = (uint32_t)strtoul(argv[1], NULL, 10);
+	}
+
+	MessageSize = JsonDecodeBenchmark_BuildMessage();
+
+	JsonParser_PoolInit(&JsonDecodeBenchmarkPool, &JsonDecodeBenchmarkMemory[0], sizeof(JsonDecodeBenchmarkMemory));
+	JsonParser_Init(&JsonDecodeBenchmarkParser, &JsonDecodeBenchmarkPool);
+
+	if(JsonParser_Parse(&JsonDecodeBenchmarkParser, &JsonDecodeBenchmarkMessage[0], MessageSize) != kStatus_Success)
+	{
+		printf("the message doesn't parse\n");
+		return EXIT_FAILURE;
+	}
+
+	for(Kind = 0; Kind < JSON_DECODE_BENCHMARK_KINDS; Kind++)
+	{
+		TokenIndex = JsonParser_GetValueIndex(&JsonDecodeBenchmarkParser, 0, (uint8_t *)JsonDecodeBenchmarkNames[Kind]);
+		TokenIndex = JsonParser_GetFirstElement(&JsonDecodeBenchmarkParser, TokenIndex);
+
+		for(ValueIndex = 0; ValueIndex < JSON_DECODE_BENCHMARK_VALUES; ValueIndex++)
+		{
+			JsonDecodeBenchmarkTokens[Kind][ValueIndex] = TokenIndex;
+
+			TokenIndex = JsonParser_GetNextElement(&JsonDecodeBenchmarkParser, TokenIndex);
+		}
+	}
+
+	/* same status and value on every token, including the ones out of range */
+	for(Kind = 0; Kind < JSON_DECODE_BENCHMARK_KINDS; Kind++)
+	{
+		for(ValueIndex = 0; ValueIndex < JSON_DECODE_BENCHMARK_VALUES; ValueIndex++)
+		{
+			TokenIndex = JsonDecodeBenchmarkTokens[Kind][ValueIndex];
+
+			DecoderValue = 0;
+			LibraryValue = 0;
+
+			DecoderStatus = JsonDecodeBenchmark_Decoder((json_decode_benchmark_kind_t)Kind, TokenIndex, &DecoderValue);
+			LibraryStatus = JsonDecodeBenchmark_Library((json_decode_benchmark_kind_t)Kind, TokenIndex, &LibraryValue);
+
+			if((DecoderStatus != LibraryStatus) || (DecoderValue != LibraryValue))
+			{
+				if(Mismatches < 10)
+				{
+					printf("%s %.*s: decoder %lld, library %lld\n", JsonDecodeBenchmarkNames[Kind], \
+							JsonDecodeBenchmarkParser.ParsedJson[TokenIndex].end - \
+							JsonDecodeBenchmarkParser.ParsedJson[TokenIndex].start, \
+							&JsonDecodeBenchmarkMessage[JsonDecodeBenchmarkParser.ParsedJson[TokenIndex].start], \
+							(long long)DecoderValue, (long long)LibraryValue);
+				}
+
+				Mismatches++;
+			}
+		}
+	}
+
+	printf("%u values of each kind, ns per value\n", JSON_DECODE_BENCHMARK_VALUES);
+
+	Conversions = (double)Passes * JSON_DECODE_BENCHMARK_VALUES;
+
+	for(Kind = 0; Kind < JSON_DECODE_BENCHMARK_KINDS; Kind++)
+	{
+		StartTime = JsonDecodeBenchmark_GetTime();
+
+		for(Pass = 0; Pass < Passes; Pass++)
+		{
+			for(ValueIndex = 0; ValueIndex < JSON_DECODE_BENCHMARK_VALUES; ValueIndex++)
+			{
+				JsonDecodeBenchmark_Decoder((json_decode_benchmark_kind_t)Kind, \
+						JsonDecodeBenchmarkTokens[Kind][ValueIndex], &DecoderValue);
+				JsonDecodeBenchmarkSink = DecoderValue;
+			}
+		}
+
+		DecoderTime = JsonDecodeBenchmark_GetTime() - StartTime;
+
+		StartTime = JsonDecodeBenchmark_GetTime();
+
+		for(Pass = 0; Pass < Passes; Pass++)
+		{
+			for(ValueIndex = 0; ValueIndex < JSON_DECODE_BENCHMARK_VALUES; ValueIndex++)
+			{
+				JsonDecodeBenchmark_Library((json_decode_benchmark_kind_t)Kind, \
+						JsonDecodeBenchmarkTokens[Kind][ValueIndex], &LibraryValue);
+				JsonDecodeBenchmarkSink = LibraryValue;
+			}
+		}
+
+		LibraryTime = JsonDecodeBenchmark_GetTime() - StartTime;
+
+		printf("%-9s decoder %6.1f, %-7s %6.1f\n", JsonDecodeBenchmarkNames[Kind], (DecoderTime * 1e9) / Conversions, \
+				JsonDecodeBenchmarkLibraryNames[Kind], (LibraryTime * 1e9) / Conversions);
+	}
+
+	printf("%u mismatches\n", Mismatches);
+
+	return (Mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static uint16_t JsonDecodeBenchmark_BuildMessage(void)
+{
+	uint16_t MessageSize;
+	uint32_t Kind;
+	uint32_t ValueIndex;
+	uint32_t Digits;
+	uint32_t DigitIndex;
+
+	MessageSize = (uint16_t)sprintf((char *)&JsonDecodeBenchmarkMessage[0], "{");
+
+	/* 1 to 10 digits, so a few of the 10 digit ones don't fit */
+	for(Kind = 0; Kind < JSON_DECODE_BENCHMARK_KINDS; Kind++)
+	{
+		MessageSize += (uint16_t)sprintf((char *)&JsonDecodeBenchmarkMessage[MessageSize], "%s\"%s\":[", \
+				(Kind != 0) ? "," : "", JsonDecodeBenchmarkNames[Kind]);
+
+		for(ValueIndex = 0; ValueIndex < JSON_DECODE_BENCHMARK_VALUES; ValueIndex++)
+		{
+			if(ValueIndex != 0)
+			{
+				JsonDecodeBenchmarkMessage[MessageSize++] = ',';
+			}
+
+			if((Kind != JSON_DECODE_BENCHMARK_UNSIGNED) && (rand() % 2))
+			{
+				JsonDecodeBenchmarkMessage[MessageSize++] = '-';
+			}
+
+			/* fixed point keeps to the 23 bit integer part of q8 and up to 3 decimals */
+			Digits = (Kind == JSON_DECODE_BENCHMARK_FIXED_POINT) ? (1 + (rand() % 6)) : (1 + (rand() % 10));
+
+			JsonDecodeBenchmarkMessage[MessageSize++] = (uint8_t)('1' + (rand() % 9));
+
+			for(DigitIndex = 1; DigitIndex < Digits; DigitIndex++)
+			{
+				JsonDecodeBenchmarkMessage[MessageSize++] = (uint8_t)('0' + (rand() % 10));
+			}
+
+			if(Kind == JSON_DECODE_BENCHMARK_FIXED_POINT)
+			{
+				MessageSize += (uint16_t)sprintf((char *)&JsonDecodeBenchmarkMessage[MessageSize], ".%0*d", \
+						1 + (rand() % 3), rand() % 1000);
+			}
+		}
+
+		JsonDecodeBenchmarkMessage[MessageSize++] = ']';
+	}
+
+	MessageSize += (uint16_t)sprintf((char *)&JsonDecodeBenchmarkMessage[MessageSize], "}");
+
+	return MessageSize;
+}
+
+static status_t JsonDecodeBenchmark_Decoder(json_decode_benchmark_kind_t Kind, int32_t TokenIndex, int64_t * Value)
+{
+	status_t Status;
+	uint32_t Unsigned;
+	int32_t Signed;
+
+	if(Kind == JSON_DECODE_BENCHMARK_UNSIGNED)
+	{
+		Status = JsonParser_GetUnsigned(&JsonDecodeBenchmarkParser, TokenIndex, &Unsigned);
+		*Value = (Status == kStatus_Success) ? Unsigned : 0;
+	}
+	else if(Kind == JSON_DECODE_BENCHMARK_SIGNED)
+	{
+		Status = JsonParser_GetSigned(&JsonDecodeBenchmarkParser, TokenIndex, &Signed);
+		*Value = (Status == kStatus_Success) ? Signed : 0;
+	}
+	else
+	{
+		Status = JsonParser_GetFixedPoint(&JsonDecodeBenchmarkParser, TokenIndex, JSON_DECODE_BENCHMARK_FRACTION_BITS, &Signed);
+		*Value = (Status == kStatus_Success) ? Signed : 0;
+	}
+
+	return Status;
+}
+
+/* what the decoders save the application from writing, end and range checks included */
+static status_t JsonDecodeBenchmark_Library(json_decode_benchmark_kind_t Kind, int32_t TokenIndex, int64_t * Value)
+{
+	status_t Status = kStatus_Fail;
+	jsmntok_t * Token = &JsonDecodeBenchmarkParser.ParsedJson[TokenIndex];
+	const char * Data = (const char *)&JsonDecodeBenchmarkMessage[Token->start];
+	char * End;
+	unsigned long Unsigned;
+	long Signed;
+	double Real;
+
+	errno = 0;
+	*Value = 0;
+
+	if(Kind == JSON_DECODE_BENCHMARK_UNSIGNED)
+	{
+		Unsigned = strtoul(Data, &End, 10);
+
+		if((Data[0] != '-') && (errno == 0) && (Unsigned <= UINT32_MAX) && (End == &Data[Token->end - Token->start]))
+		{
+			*Value = (int64_t)Unsigned;
+			Status = kStatus_Success;
+		}
+	}
+	else if(Kind == JSON_DECODE_BENCHMARK_SIGNED)
+	{
+		Signed = strtol(Data, &End, 10);
+
+		if((errno == 0) && (Signed >= INT32_MIN) && (Signed <= INT32_MAX) && (End == &Data[Token->end - Token->start]))
+		{
+			*Value = Signed;
+			Status = kStatus_Success;
+		}
+	}
+	else
+	{
+		Real = strtod(Data, &End);
+
+		if((errno == 0) && (End == &Data[Token->end - Token->start]))
+		{
+			Real = round(Real * (double)(1UL << JSON_DECODE_BENCHMARK_FRACTION_BITS));
+
+			if((Real >= (double)INT32_MIN) && (Real <= (double)INT32_MAX))
+			{
+				*Value = (int64_t)Real;
+				Status = kStatus_Success;
+			}
+		}
+	}
+
+	return Status;
+}
+
+static double JsonDecodeBenchmark_GetTime(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (double)Now.tv_sec + ((double)Now.tv_nsec / 1000000000.0);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,331 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Key lookup cost on a 2 KB message of 31 keys, 20 lookups per message, the
+ * key index built by JsonParser_Parse against the linear sweep it replaced.
+ * The key name is formatted on every lookup in both, like an application
+ * walking its own table of names would. The parse is timed against a single
+ * jsmn_parse, it runs jsmn twice, once to count and once to fill the tokens,
+ * and then builds the index.
+ *
+ * usage: JsonIndexBenchmark [messages]
+ *
+ * gcc -O2 -I. -I.. -I../jsmn -I../../MiscFunctions JsonIndexBenchmark.c ../JsonParser.c \
+ *     ../jsmn/jsmn.c ../../MiscFunctions/MiscFunctions.c -o JsonIndexBenchmark
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fsl_common.h"
+#include "MiscFunctions.h"
+#include "JsonParser.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define JSON_INDEX_BENCHMARK_MESSAGES_DEFAULT	(200000)
+
+#define JSON_INDEX_BENCHMARK_KEYS				(31)
+
+#define JSON_INDEX_BENCHMARK_QUERIES			(20)
+
+#define JSON_INDEX_BENCHMARK_VALUE_SIZE			(56)
+
+#define JSON_INDEX_BENCHMARK_MESSAGE_SIZE		(2048)
+
+#define JSON_INDEX_BENCHMARK_POOL_SIZE			(4096)
+
+#define JSON_INDEX_BENCHMARK_KEY_SIZE			(16)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static double JsonIndexBenchmark_GetTime(void);
+
+static uint16_t JsonIndexBenchmark_BuildMessage(void);
+
+static int32_t JsonIndexBenchmark_LinearSweep(jsonparser_t * Instance, uint8_t * const TokenToFind);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint8_t JsonIndexBenchmarkMessage[JSON_INDEX_BENCHMARK_MESSAGE_SIZE + 256];
+
+static uint8_t JsonIndexBenchmarkMemory[JSON_INDEX_BENCHMARK_POOL_SIZE] __attribute__((aligned(4)));
+
+static jsonparser_pool_t JsonIndexBenchmarkPool;
+
+static jsonparser_t JsonIndexBenchmarkParser;
+
+/* the keys each message asks for, the same for both lookups */
+static uint8_t JsonIndexBenchmarkQueries[JSON_INDEX_BENCHMARK_QUERIES];
+
+/* the result of every lookup goes here so the loops aren't optimized away */
+static volatile int32_t JsonIndexBenchmarkSink;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char ** argv)
+{
+	uint32_t Messages = JSON_INDEX_BENCHMARK_MESSAGES_DEFAULT;
+	uint32_t Message;
+	uint32_t Query;
+	uint32_t Mismatches = 0;
+	uint16_t MessageSize;
+	uint8_t Key[JSON_INDEX_BENCHMARK_KEY_SIZE];
+	jsmn_parser JsmnParser;
+	jsmntok_t * JsmnTokens;
+	double StartTime;
+	double JsmnTime;
+	double ParseTime;
+	double SweepTime;
+	double IndexTime;
+	double ValueTime;
+	double Lookups;
+
+	if(argc > 1)
+	{
+		Messages = (uint32_t)strtoul(argv[1], NULL, 10);
+	}
+
+	MessageSize = JsonIndexBenchmark_BuildMessage();
+
+	for(Query = 0; Query < JSON_INDEX_BENCHMARK_QUERIES; Query++)
+	{
+		JsonIndexBenchmarkQueries[Query] = (uint8_t)(rand() % JSON_INDEX_BENCHMARK_KEYS);
+	}
+
+	JsonParser_PoolInit(&JsonIndexBenchmarkPool, &JsonIndexBenchmarkMemory[0], sizeof(JsonIndexBenchmarkMemory));
+	JsonParser_Init(&JsonIndexBenchmarkParser, &JsonIndexBenchmarkPool);
+
+	if(JsonParser_Parse(&JsonIndexBenchmarkParser, &JsonIndexBenchmarkMessage[0], MessageSize) != kStatus_Success)
+	{
+		printf("the message doesn't parse\n");
+		return EXIT_FAILURE;
+	}
+
+	/* both lookups have to agree before any of them is timed */
+	for(Query = 0; Query < JSON_INDEX_BENCHMARK_KEYS; Query++)
+	{
+		snprintf((char *)Key, sizeof(Key), "key%02u", Query);
+
+		if((JsonParser_GetTokenIndex(&JsonIndexBenchmarkParser, Key) != \
+				JsonIndexBenchmark_LinearSweep(&JsonIndexBenchmarkParser, Key)) || \
+				(JsonParser_GetValueIndex(&JsonIndexBenchmarkParser, 0, Key) != \
+				(JsonParser_GetTokenIndex(&JsonIndexBenchmarkParser, Key) + 1)))
+		{
+			printf("key %s: lookups differ\n", Key);
+			Mismatches++;
+		}
+	}
+
+	/* jsmn alone on a separate token array, then the parse with the index */
+	JsmnTokens = malloc(JsonIndexBenchmarkParser.MaxTokens * sizeof(jsmntok_t));
+
+	if(JsmnTokens == NULL)
+	{
+		return EXIT_FAILURE;
+	}
+
+	StartTime = JsonIndexBenchmark_GetTime();
+
+	for(Message = 0; Message < Messages; Message++)
+	{
+		jsmn_init(&JsmnParser);
+		JsonIndexBenchmarkSink = jsmn_parse(&JsmnParser, (char *)&JsonIndexBenchmarkMessage[0], MessageSize, \
+				JsmnTokens, JsonIndexBenchmarkParser.MaxTokens);
+	}
+
+	JsmnTime = JsonIndexBenchmark_GetTime() - StartTime;
+
+	StartTime = JsonIndexBenchmark_GetTime();
+
+	for(Message = 0; Message < Messages; Message++)
+	{
+		JsonIndexBenchmarkSink = JsonParser_Parse(&JsonIndexBenchmarkParser, &JsonIndexBenchmarkMessage[0], MessageSize);
+	}
+
+	ParseTime = JsonIndexBenchmark_GetTime() - StartTime;
+
+	StartTime = JsonIndexBenchmark_GetTime();
+
+	for(Message = 0; Message < Messages; Message++)
+	{
+		for(Query = 0; Query < JSON_INDEX_BENCHMARK_QUERIES; Query++)
+		{
+			snprintf((char *)Key, sizeof(Key), "key%02u", JsonIndexBenchmarkQueries[Query]);
+			JsonIndexBenchmarkSink = JsonIndexBenchmark_LinearSweep(&JsonIndexBenchmarkParser, Key);
+		}
+	}
+
+	SweepTime = JsonIndexBenchmark_GetTime() - StartTime;
+
+	StartTime = JsonIndexBenchmark_GetTime();
+
+	for(Message = 0; Message < Messages; Message++)
+	{
+		for(Query = 0; Query < JSON_INDEX_BENCHMARK_QUERIES; Query++)
+		{
+			snprintf((char *)Key, sizeof(Key), "key%02u", JsonIndexBenchmarkQueries[Query]);
+			JsonIndexBenchmarkSink = JsonParser_GetTokenIndex(&JsonIndexBenchmarkParser, Key);
+		}
+	}
+
+	IndexTime = JsonIndexBenchmark_GetTime() - StartTime;
+
+	StartTime = JsonIndexBenchmark_GetTime();
+
+	for(Message = 0; Message < Messages; Message++)
+	{
+		for(Query = 0; Query < JSON_INDEX_BENCHMARK_QUERIES; Query++)
+		{
+			snprintf((char *)Key, sizeof(Key), "key%02u", JsonIndexBenchmarkQueries[Query]);
+			JsonIndexBenchmarkSink = JsonParser_GetValueIndex(&JsonIndexBenchmarkParser, 0, Key);
+		}
+	}
+
+	ValueTime = JsonIndexBenchmark_GetTime() - StartTime;
+
+	Lookups = (double)Messages * JSON_INDEX_BENCHMARK_QUERIES;
+
+	printf("%u bytes, %d tokens, %u keys, %u lookups per message\n", MessageSize, JsonIndexBenchmarkParser.Tokens, \
+			JSON_INDEX_BENCHMARK_KEYS, JSON_INDEX_BENCHMARK_QUERIES);
+	printf("jsmn_parse               %8.0f ns per message\n", (JsmnTime * 1e9) / Messages);
+	printf("JsonParser_Parse         %8.0f ns per message\n", (ParseTime * 1e9) / Messages);
+	printf("linear sweep             %8.1f ns per lookup\n", (SweepTime * 1e9) / Lookups);
+	printf("JsonParser_GetTokenIndex %8.1f ns per lookup\n", (IndexTime * 1e9) / Lookups);
+	printf("JsonParser_GetValueIndex %8.1f ns per lookup\n", (ValueTime * 1e9) / Lookups);
+	printf("%u mismatches\n", Mismatches);
+
+	free(JsmnTokens);
+
+	return (Mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static uint16_t JsonIndexBenchmark_BuildMessage(void)
+{
+	uint16_t MessageSize;
+	uint32_t KeyIndex;
+	uint32_t CharacterIndex;
+
+	MessageSize = (uint16_t)sprintf((char *)&JsonIndexBenchmarkMessage[0], "{");
+
+	/* short keys, longer string values, what a config or telemetry message looks like */
+	for(KeyIndex = 0; KeyIndex < JSON_INDEX_BENCHMARK_KEYS; KeyIndex++)
+	{
+		MessageSize += (uint16_t)sprintf((char *)&JsonIndexBenchmarkMessage[MessageSize], "%s\"key%02u\":\"", \
+				(KeyIndex != 0) ? "," : "", KeyIndex);
+
+		for(CharacterIndex = 0; CharacterIndex < JSON_INDEX_BENCHMARK_VALUE_SIZE; CharacterIndex++)
+		{
+			JsonIndexBenchmarkMessage[MessageSize++] = (uint8_t)('a' + (rand() % 26));
+		}
+
+		JsonIndexBenchmarkMessage[MessageSize++] = '"';
+	}
+
+	MessageSize += (uint16_t)sprintf((char *)&JsonIndexBenchmarkMessage[MessageSize], "}");
+
+	return MessageSize;
+}
+
+/* the lookup before the index, every string token compared up to the key size */
+static int32_t JsonIndexBenchmark_LinearSweep(jsonparser_t * Instance, uint8_t * const TokenToFind)
+{
+	int32_t FoundToken = -1;
+	int32_t TokenOffset = 0;
+	uint16_t TokenSize;
+
+	TokenSize = strlen((char*)TokenToFind);
+
+	while(TokenOffset < Instance->Tokens)
+	{
+		if(Instance->ParsedJson[TokenOffset].type == JSMN_STRING)
+		{
+			if(MiscFunction_StringCompare(TokenToFind, &Instance->JsonBuffer[Instance->ParsedJson[TokenOffset].start], \
+					TokenSize) == STRING_OK)
+			{
+				FoundToken = TokenOffset;
+				break;
+			}
+		}
+
+		TokenOffset++;
+	}
+
+	return FoundToken;
+}
+
+static double JsonIndexBenchmark_GetTime(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (double)Now.tv_sec + ((double)Now.tv_nsec / 1000000000.0);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
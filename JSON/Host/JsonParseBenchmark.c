@@ -0,0 +1,248 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Parse and query cost with the token layout the build selects, run it
+ * built with and without -DJSMN_PACKED_TOKENS to compare the two. The
+ * document is a small config message, parsed by jsmn alone, by
+ * JsonParser_Parse, and then queried by path. The query results have to be
+ * the expected ones before anything is timed.
+ *
+ * usage: JsonParseBenchmark [messages per round]
+ *
+ * gcc -O2 [-DJSMN_PACKED_TOKENS] -I. -I.. -I../jsmn -I../../MiscFunctions JsonParseBenchmark.c \
+ *     ../JsonParser.c ../jsmn/jsmn.c ../../MiscFunctions/MiscFunctions.c -o JsonParseBenchmark
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fsl_common.h"
+#include "JsonParser.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define JSON_PARSE_BENCHMARK_MESSAGES_DEFAULT	(200000)
+
+#define JSON_PARSE_BENCHMARK_ROUNDS				(7)
+
+#define JSON_PARSE_BENCHMARK_POOL_SIZE			(2048)
+
+#define JSON_PARSE_BENCHMARK_TOKENS_MAX			(64)
+
+#define JSON_PARSE_BENCHMARK_QUERIES			(sizeof(JsonParseBenchmarkQueries) / sizeof(JsonParseBenchmarkQueries[0]))
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	const char * Path;
+	const char * Value;
+}json_parse_benchmark_query_t;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static double JsonParseBenchmark_GetTime(void);
+
+static double JsonParseBenchmark_Best(double Best, double StartTime, uint32_t Round);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const char JsonParseBenchmarkDocument[] =
+{
+	"{\"config\":{\"period\":12345,\"name\":\"sensor one\",\"on\":true,\"list\":[1,-2.5e3,null],"
+	"\"sensors\":[{\"id\":1,\"t\":21.5},{\"id\":2,\"t\":22.5},{\"id\":3,\"t\":23.5}]}}"
+};
+
+static const json_parse_benchmark_query_t JsonParseBenchmarkQueries[] =
+{
+	{"config.period", "12345"},
+	{"config.name", "sensor one"},
+	{"config.list[1]", "-2.5e3"},
+	{"config.sensors[2].t", "23.5"},
+	{"config.sensors[0].id", "1"},
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint8_t JsonParseBenchmarkMemory[JSON_PARSE_BENCHMARK_POOL_SIZE] __attribute__((aligned(4)));
+
+static jsonparser_pool_t JsonParseBenchmarkPool;
+
+static jsonparser_t JsonParseBenchmarkParser;
+
+static jsmntok_t JsonParseBenchmarkTokens[JSON_PARSE_BENCHMARK_TOKENS_MAX];
+
+/* results go here so the loops aren't optimized away */
+static volatile int32_t JsonParseBenchmarkSink;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char ** argv)
+{
+	uint32_t Messages = JSON_PARSE_BENCHMARK_MESSAGES_DEFAULT;
+	uint32_t Message;
+	uint32_t Round;
+	uint32_t Query;
+	uint32_t Mismatches = 0;
+	uint16_t DocumentSize = sizeof(JsonParseBenchmarkDocument) - 1;
+	jsmn_parser JsmnParser;
+	jsonparser_value_t Value;
+	double StartTime;
+	double JsmnTime = 0;
+	double ParseTime = 0;
+	double QueryTime = 0;
+
+	if(argc > 1)
+	{
+		Messages = (uint32_t)strtoul(argv[1], NULL, 10);
+	}
+
+	JsonParser_PoolInit(&JsonParseBenchmarkPool, &JsonParseBenchmarkMemory[0], sizeof(JsonParseBenchmarkMemory));
+	JsonParser_Init(&JsonParseBenchmarkParser, &JsonParseBenchmarkPool);
+
+	if(JsonParser_Parse(&JsonParseBenchmarkParser, (uint8_t *)JsonParseBenchmarkDocument, DocumentSize) != kStatus_Success)
+	{
+		printf("the document doesn't parse\n");
+		return EXIT_FAILURE;
+	}
+
+	for(Query = 0; Query < JSON_PARSE_BENCHMARK_QUERIES; Query++)
+	{
+		if((JsonParser_Query(&JsonParseBenchmarkParser, (uint8_t *)JsonParseBenchmarkQueries[Query].Path, &Value) != \
+				kStatus_Success) || (Value.Size != strlen(JsonParseBenchmarkQueries[Query].Value)) || \
+				(memcmp(Value.Data, JsonParseBenchmarkQueries[Query].Value, Value.Size) != 0))
+		{
+			printf("%s: wrong value\n", JsonParseBenchmarkQueries[Query].Path);
+			Mismatches++;
+		}
+	}
+
+	/* interleaved rounds, the best of each is kept to leave out the noise of a shared machine */
+	for(Round = 0; Round < JSON_PARSE_BENCHMARK_ROUNDS; Round++)
+	{
+		StartTime = JsonParseBenchmark_GetTime();
+
+		for(Message = 0; Message < Messages; Message++)
+		{
+			jsmn_init(&JsmnParser);
+			JsonParseBenchmarkSink = jsmn_parse(&JsmnParser, JsonParseBenchmarkDocument, DocumentSize, \
+					&JsonParseBenchmarkTokens[0], JSON_PARSE_BENCHMARK_TOKENS_MAX);
+		}
+
+		JsmnTime = JsonParseBenchmark_Best(JsmnTime, StartTime, Round);
+
+		StartTime = JsonParseBenchmark_GetTime();
+
+		for(Message = 0; Message < Messages; Message++)
+		{
+			JsonParseBenchmarkSink = JsonParser_Parse(&JsonParseBenchmarkParser, (uint8_t *)JsonParseBenchmarkDocument, \
+					DocumentSize);
+		}
+
+		ParseTime = JsonParseBenchmark_Best(ParseTime, StartTime, Round);
+
+		StartTime = JsonParseBenchmark_GetTime();
+
+		for(Message = 0; Message < Messages; Message++)
+		{
+			for(Query = 0; Query < JSON_PARSE_BENCHMARK_QUERIES; Query++)
+			{
+				JsonParser_Query(&JsonParseBenchmarkParser, (uint8_t *)JsonParseBenchmarkQueries[Query].Path, &Value);
+				JsonParseBenchmarkSink = Value.TokenIndex;
+			}
+		}
+
+		QueryTime = JsonParseBenchmark_Best(QueryTime, StartTime, Round);
+	}
+
+#ifdef JSMN_PACKED_TOKENS
+	printf("packed tokens, ");
+#else
+	printf("unpacked tokens, ");
+#endif
+	printf("%u bytes each, %d tokens, %u of the pool used\n", (uint32_t)sizeof(jsmntok_t), \
+			JsonParseBenchmarkParser.Tokens, JsonParseBenchmarkPool.Used);
+	printf("jsmn_parse        %7.1f ns per message\n", (JsmnTime * 1e9) / Messages);
+	printf("JsonParser_Parse  %7.1f ns per message\n", (ParseTime * 1e9) / Messages);
+	printf("JsonParser_Query  %7.1f ns per query\n", (QueryTime * 1e9) / ((double)Messages * JSON_PARSE_BENCHMARK_QUERIES));
+	printf("%u mismatches\n", Mismatches);
+
+	return (Mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static double JsonParseBenchmark_Best(double Best, double StartTime, uint32_t Round)
+{
+	double ElapsedTime = JsonParseBenchmark_GetTime() - StartTime;
+
+	return ((Round == 0) || (ElapsedTime < Best)) ? ElapsedTime : Best;
+}
+
+static double JsonParseBenchmark_GetTime(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (double)Now.tv_sec + ((double)Now.tv_nsec / 1000000000.0);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
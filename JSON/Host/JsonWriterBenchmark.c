@@ -0,0 +1,274 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Cost of building a small telemetry object with the writer against
+ * snprintf, once with the fixed point value split by hand into integer and
+ * decimals and once as a double with %f. The values are quarters so every
+ * way of printing them gives the same text, and the three outputs have to
+ * match on every sample before anything is timed.
+ *
+ * usage: JsonWriterBenchmark [objects per round]
+ *
+ * gcc -O2 -I. -I.. -I../../RingBuffer -I../../MiscFunctions JsonWriterBenchmark.c \
+ *     ../JsonWriter.c ../../RingBuffer/RingBuffer.c ../../MiscFunctions/MiscFunctions.c \
+ *     -o JsonWriterBenchmark
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fsl_common.h"
+#include "JsonWriter.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define JSON_WRITER_BENCHMARK_OBJECTS_DEFAULT	(500000)
+
+#define JSON_WRITER_BENCHMARK_ROUNDS			(7)
+
+#define JSON_WRITER_BENCHMARK_SAMPLES			(256)
+
+#define JSON_WRITER_BENCHMARK_BUFFER_SIZE		(96)
+
+#define JSON_WRITER_BENCHMARK_FRACTION_BITS		(8)
+
+#define JSON_WRITER_BENCHMARK_DECIMALS			(2)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	uint32_t Id;
+	/* q8 */
+	int32_t Temperature;
+	const char * Name;
+}json_writer_benchmark_sample_t;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static double JsonWriterBenchmark_GetTime(void);
+
+static uint16_t JsonWriterBenchmark_Writer(const json_writer_benchmark_sample_t * Sample, uint8_t * Buffer);
+
+static uint16_t JsonWriterBenchmark_Integer(const json_writer_benchmark_sample_t * Sample, uint8_t * Buffer);
+
+static uint16_t JsonWriterBenchmark_Double(const json_writer_benchmark_sample_t * Sample, uint8_t * Buffer);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const char * const JsonWriterBenchmarkNames[] =
+{
+	"pump", "sensor one", "valve left", "heater"
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static json_writer_benchmark_sample_t JsonWriterBenchmarkSamples[JSON_WRITER_BENCHMARK_SAMPLES];
+
+/* the size of every object goes here so the loops aren't optimized away */
+static volatile uint16_t JsonWriterBenchmarkSink;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char ** argv)
+{
+	uint32_t Objects = JSON_WRITER_BENCHMARK_OBJECTS_DEFAULT;
+	uint32_t Object;
+	uint32_t Round;
+	uint32_t Mismatches = 0;
+	uint8_t WriterBuffer[JSON_WRITER_BENCHMARK_BUFFER_SIZE];
+	uint8_t IntegerBuffer[JSON_WRITER_BENCHMARK_BUFFER_SIZE];
+	uint8_t DoubleBuffer[JSON_WRITER_BENCHMARK_BUFFER_SIZE];
+	uint16_t Size = 0;
+	double StartTime;
+	double ElapsedTime;
+	double WriterTime = 0;
+	double IntegerTime = 0;
+	double DoubleTime = 0;
+
+	if(argc > 1)
+	{
+		Objects = (uint32_t)strtoul(argv[1], NULL, 10);
+	}
+
+	/* quarters from -100 to 100 degrees print the same however they are rounded */
+	for(Object = 0; Object < JSON_WRITER_BENCHMARK_SAMPLES; Object++)
+	{
+		JsonWriterBenchmarkSamples[Object].Id = (uint32_t)rand();
+		JsonWriterBenchmarkSamples[Object].Temperature = ((rand() % 801) - 400) * (1 << (JSON_WRITER_BENCHMARK_FRACTION_BITS - 2));
+		JsonWriterBenchmarkSamples[Object].Name = JsonWriterBenchmarkNames[rand() % 4];
+	}
+
+	for(Object = 0; Object < JSON_WRITER_BENCHMARK_SAMPLES; Object++)
+	{
+		JsonWriterBenchmark_Writer(&JsonWriterBenchmarkSamples[Object], &WriterBuffer[0]);
+		JsonWriterBenchmark_Integer(&JsonWriterBenchmarkSamples[Object], &IntegerBuffer[0]);
+		JsonWriterBenchmark_Double(&JsonWriterBenchmarkSamples[Object], &DoubleBuffer[0]);
+
+		if((strcmp((char *)WriterBuffer, (char *)IntegerBuffer) != 0) || (strcmp((char *)WriterBuffer, (char *)DoubleBuffer) != 0))
+		{
+			if(Mismatches < 10)
+			{
+				printf("writer %s\ninteger %s\ndouble %s\n", WriterBuffer, IntegerBuffer, DoubleBuffer);
+			}
+
+			Mismatches++;
+		}
+	}
+
+	/* interleaved rounds, the best of each is kept to leave out the noise of a shared machine */
+	for(Round = 0; Round < JSON_WRITER_BENCHMARK_ROUNDS; Round++)
+	{
+		StartTime = JsonWriterBenchmark_GetTime();
+
+		for(Object = 0; Object < Objects; Object++)
+		{
+			JsonWriterBenchmarkSink = JsonWriterBenchmark_Writer(&JsonWriterBenchmarkSamples[Object % JSON_WRITER_BENCHMARK_SAMPLES], \
+					&WriterBuffer[0]);
+		}
+
+		ElapsedTime = JsonWriterBenchmark_GetTime() - StartTime;
+		WriterTime = ((Round == 0) || (ElapsedTime < WriterTime)) ? ElapsedTime : WriterTime;
+
+		StartTime = JsonWriterBenchmark_GetTime();
+
+		for(Object = 0; Object < Objects; Object++)
+		{
+			JsonWriterBenchmarkSink = JsonWriterBenchmark_Integer(&JsonWriterBenchmarkSamples[Object % JSON_WRITER_BENCHMARK_SAMPLES], \
+					&IntegerBuffer[0]);
+		}
+
+		ElapsedTime = JsonWriterBenchmark_GetTime() - StartTime;
+		IntegerTime = ((Round == 0) || (ElapsedTime < IntegerTime)) ? ElapsedTime : IntegerTime;
+
+		StartTime = JsonWriterBenchmark_GetTime();
+
+		for(Object = 0; Object < Objects; Object++)
+		{
+			JsonWriterBenchmarkSink = JsonWriterBenchmark_Double(&JsonWriterBenchmarkSamples[Object % JSON_WRITER_BENCHMARK_SAMPLES], \
+					&DoubleBuffer[0]);
+		}
+
+		ElapsedTime = JsonWriterBenchmark_GetTime() - StartTime;
+		DoubleTime = ((Round == 0) || (ElapsedTime < DoubleTime)) ? ElapsedTime : DoubleTime;
+	}
+
+	Size = JsonWriterBenchmark_Writer(&JsonWriterBenchmarkSamples[0], &WriterBuffer[0]);
+
+	printf("%s (%u bytes), ns per object\n", WriterBuffer, Size);
+	printf("JsonWriter        %6.1f\n", (WriterTime * 1e9) / Objects);
+	printf("snprintf integer  %6.1f\n", (IntegerTime * 1e9) / Objects);
+	printf("snprintf double   %6.1f\n", (DoubleTime * 1e9) / Objects);
+	printf("%u mismatches\n", Mismatches);
+
+	return (Mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static uint16_t JsonWriterBenchmark_Writer(const json_writer_benchmark_sample_t * Sample, uint8_t * Buffer)
+{
+	jsonwriter_t Writer;
+
+	JsonWriter_Init(&Writer, Buffer, JSON_WRITER_BENCHMARK_BUFFER_SIZE);
+
+	JsonWriter_BeginObject(&Writer);
+	JsonWriter_Key(&Writer, (const uint8_t *)"id");
+	JsonWriter_Unsigned(&Writer, Sample->Id);
+	JsonWriter_Key(&Writer, (const uint8_t *)"temp");
+	JsonWriter_FixedPoint(&Writer, Sample->Temperature, JSON_WRITER_BENCHMARK_FRACTION_BITS, JSON_WRITER_BENCHMARK_DECIMALS);
+	JsonWriter_Key(&Writer, (const uint8_t *)"name");
+	JsonWriter_String(&Writer, (const uint8_t *)Sample->Name);
+	JsonWriter_EndObject(&Writer);
+	JsonWriter_Finish(&Writer);
+
+	return JsonWriter_GetSize(&Writer);
+}
+
+/* what a careful application does without the writer and without floating point */
+static uint16_t JsonWriterBenchmark_Integer(const json_writer_benchmark_sample_t * Sample, uint8_t * Buffer)
+{
+	uint32_t Magnitude;
+
+	Magnitude = (Sample->Temperature < 0) ? (0 - (uint32_t)Sample->Temperature) : (uint32_t)Sample->Temperature;
+
+	return (uint16_t)snprintf((char *)Buffer, JSON_WRITER_BENCHMARK_BUFFER_SIZE, \
+			"{\"id\":%u,\"temp\":%s%u.%02u,\"name\":\"%s\"}", Sample->Id, (Sample->Temperature < 0) ? "-" : "", \
+			Magnitude >> JSON_WRITER_BENCHMARK_FRACTION_BITS, \
+			((Magnitude & ((1U << JSON_WRITER_BENCHMARK_FRACTION_BITS) - 1)) * 100U) >> JSON_WRITER_BENCHMARK_FRACTION_BITS, \
+			Sample->Name);
+}
+
+static uint16_t JsonWriterBenchmark_Double(const json_writer_benchmark_sample_t * Sample, uint8_t * Buffer)
+{
+	return (uint16_t)snprintf((char *)Buffer, JSON_WRITER_BENCHMARK_BUFFER_SIZE, "{\"id\":%u,\"temp\":%.2f,\"name\":\"%s\"}", \
+			Sample->Id, (double)Sample->Temperature / (double)(1U << JSON_WRITER_BENCHMARK_FRACTION_BITS), Sample->Name);
+}
+
+static double JsonWriterBenchmark_GetTime(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (double)Now.tv_sec + ((double)Now.tv_nsec / 1000000000.0);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
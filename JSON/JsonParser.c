@@ -33,7 +33,6 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //                                      Includes Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-#include <stdlib.h>
 #include <string.h>
 #include "fsl_common.h"
 #include "MiscFunctions.h"
@@ -43,6 +42,35 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //                                   Defines & Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+#define JSON_PARSER_EMPTY_SLOT	(-1)
+
+#define JSON_PARSER_FNV_OFFSET	(2166136261UL)
+
+#define JSON_PARSER_FNV_PRIME	(16777619UL)
+
+#define JSON_PARSER_PATH_SEPARATOR	('.')
+
+#define JSON_PARSER_PATH_INDEX_START	('[')
+
+#define JSON_PARSER_PATH_INDEX_END	(']')
+
+/* fraction digits kept for fixed point values, the rest are below any q format resolution */
+#define JSON_PARSER_FRACTION_DIGITS_MAX	(9)
+
+#define JSON_PARSER_FRACTION_BITS_MAX	(30)
+
+/* pool blocks are word aligned */
+#define JSON_PARSER_POOL_ALIGNMENT	(4)
+
+/* keeps the key index size within a uint16_t, packed tokens count up to 8191 children */
+#ifdef JSMN_PACKED_TOKENS
+#define JSON_PARSER_TOKENS_MAX	(8192)
+#else
+#define JSON_PARSER_TOKENS_MAX	(16384)
+#endif
+
+/* worst case per token when the size isn't known, the index rounds up to less than four slots */
+#define JSON_PARSER_TOKEN_COST	(sizeof(jsmntok_t) + (4 * sizeof(int16_t)))
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                       Typedef Section
@@ -53,6 +81,31 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //                                  Function Prototypes Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+static void JsonParser_Release(jsonparser_t * Instance);
+
+static status_t JsonParser_Allocate(jsonparser_t * Instance, uint32_t TokenCount);
+
+static uint32_t JsonParser_Hash(const uint8_t * Key, uint16_t KeySize);
+
+static void JsonParser_BuildKeyIndex(jsonparser_t * Instance);
+
+static bool JsonParser_IsUnquotedCharacter(uint8_t Character);
+
+static int32_t JsonParser_FindKey(jsonparser_t * Instance, int32_t ParentIndex, const uint8_t * Key, uint16_t KeySize);
+
+static int32_t JsonParser_SkipToken(jsonparser_t * Instance, int32_t TokenIndex);
+
+static bool JsonParser_GetPrimitive(jsonparser_t * Instance, int32_t TokenIndex, const uint8_t ** Data, uint16_t * DataSize);
+
+static status_t JsonParser_DecodeInteger(jsonparser_t * Instance, int32_t TokenIndex, uint64_t Limit, bool isSigned, \
+		uint64_t * Magnitude, bool * isNegative);
+
+static status_t JsonParser_BindField(jsonparser_t * Instance, int32_t TokenIndex, const jsonparser_field_t * Field, \
+		uint8_t * Destination);
+
+static int32_t JsonParser_QueryKey(jsonparser_t * Instance, int32_t TokenIndex, const uint8_t ** Path);
+
+static int32_t JsonParser_QueryElement(jsonparser_t * Instance, int32_t TokenIndex, const uint8_t ** Path);
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                   Global Constants Section
@@ -77,13 +130,38 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //                                      Functions Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-status_t JsonParser_Init(jsonparser_t * InitInstance)
+status_t JsonParser_PoolInit(jsonparser_pool_t * Pool, uint8_t * Buffer, uint32_t BufferSize)
+{
+	assert(Pool);
+	assert(Buffer);
+
+	Pool->Buffer = Buffer;
+	Pool->Size = BufferSize;
+	Pool->Used = 0;
+
+	return kStatus_Success;
+}
+
+/* give back every block, only once no parser sharing the pool is in use */
+status_t JsonParser_PoolReset(jsonparser_pool_t * Pool)
+{
+	assert(Pool);
+
+	Pool->Used = 0;
+
+	return kStatus_Success;
+}
+
+status_t JsonParser_Init(jsonparser_t * InitInstance, jsonparser_pool_t * Pool)
 {
 	assert(InitInstance);
+	assert(Pool);
+
+	MiscFunctions_MemClear(InitInstance, sizeof(jsonparser_t));
 
 	jsmn_init(&InitInstance->Parser);
 
-	MiscFunctions_MemClear(&InitInstance->ParsedJson[0],JSON_PARSER_MAX_TOKENS * sizeof(InitInstance->ParsedJson[0]));
+	InitInstance->Pool = Pool;
 
 	return kStatus_Success;
 }
@@ -96,68 +174,256 @@ status_t JsonParser_Parse(jsonparser_t * Instance, uint8_t * InputBuffer, uint16
 	assert(Instance);
 	assert(InputBuffer);
 
-	/* just parse the received json */
+	/* just parse the received json, always as a new document */
 
 	if(BufferSize)
 	{
-		TokenCount = jsmn_parse(&Instance->Parser, (char*)InputBuffer, BufferSize, &Instance->ParsedJson[0], \
-				SIZE_OF_ARRAY(Instance->ParsedJson));
+		Instance->Tokens = 0;
+
+		/* first pass only counts, the pool gives exactly that many tokens */
+		jsmn_init(&Instance->Parser);
+
+		TokenCount = jsmn_parse(&Instance->Parser, (char*)InputBuffer, BufferSize, NULL, 0);
+
+		if(TokenCount > 0)
+		{
+			Status = JsonParser_Allocate(Instance, TokenCount);
+		}
+
+		if(Status == kStatus_Success)
+		{
+			jsmn_init(&Instance->Parser);
+
+			TokenCount = jsmn_parse(&Instance->Parser, (char*)InputBuffer, BufferSize, &Instance->ParsedJson[0], \
+					Instance->MaxTokens);
+
+			if(TokenCount > 0)
+			{
+				Instance->Tokens = TokenCount;
+				Instance->JsonBuffer = InputBuffer;
+
+				/* hashed once here, every query after this is a couple of probes */
+				JsonParser_BuildKeyIndex(Instance);
+			}
+			else
+			{
+				Status = kStatus_Fail;
+			}
+		}
+	}
+
+	return Status;
+}
+
+/* start a document that comes in chunks, they are stored in StreamBuffer since tokens point into it,
+ * its size isn't known so the rest of the pool is borrowed */
+status_t JsonParser_StreamStart(jsonparser_t * Instance, uint8_t * StreamBuffer, uint16_t StreamBufferSize)
+{
+	status_t Status = kStatus_Fail;
+	uint32_t TokenCount;
+
+	assert(Instance);
+	assert(StreamBuffer);
+
+	if(StreamBufferSize)
+	{
+		jsmn_init(&Instance->Parser);
+
+		Instance->Tokens = 0;
+		Instance->JsonBuffer = StreamBuffer;
+		Instance->StreamSize = 0;
+		Instance->StreamBufferSize = StreamBufferSize;
+
+		JsonParser_Release(Instance);
+
+		TokenCount = (Instance->Pool->Size - Instance->Pool->Used) / JSON_PARSER_TOKEN_COST;
+
+		if(TokenCount > 0)
+		{
+			Status = JsonParser_Allocate(Instance, TokenCount);
+		}
+		else
+		{
+			Status = kStatus_JsonParser_NoMemory;
+		}
+	}
+
+	return Status;
+}
+
+/* add the next chunk and resume parsing where the previous one stopped */
+status_t JsonParser_StreamParse(jsonparser_t * Instance, uint8_t * Chunk, uint16_t ChunkSize)
+{
+	status_t Status = kStatus_Fail;
+	int32_t TokenCount;
+	uint16_t ParseSize;
+
+	assert(Instance);
+	assert(Chunk);
+
+	if((Instance->StreamBufferSize - Instance->StreamSize) >= ChunkSize)
+	{
+		MiscFunctions_MemCopy(Chunk, &Instance->JsonBuffer[Instance->StreamSize], ChunkSize);
+
+		Instance->StreamSize += ChunkSize;
+
+		/* jsmn closes an unquoted value at the end of its input, it may go on in the next chunk */
+		ParseSize = Instance->StreamSize;
+
+		while((ParseSize > Instance->Parser.pos) && \
+				(JsonParser_IsUnquotedCharacter(Instance->JsonBuffer[ParseSize - 1]) == true))
+		{
+			ParseSize--;
+		}
+
+		TokenCount = jsmn_parse(&Instance->Parser, (char*)Instance->JsonBuffer, ParseSize, &Instance->ParsedJson[0], \
+				Instance->MaxTokens);
 
 		if(TokenCount > 0)
 		{
 			Instance->Tokens = TokenCount;
-			Instance->JsonBuffer = InputBuffer;
+
+			JsonParser_BuildKeyIndex(Instance);
+
 			Status = kStatus_Success;
 		}
+		else if((TokenCount == 0) || (TokenCount == JSMN_ERROR_PART))
+		{
+			Status = kStatus_JsonParser_Incomplete;
+		}
 	}
 
 	return Status;
 }
 
-/* get token index */
+/* get the index of the first key named TokenToFind, in any object */
 int32_t JsonParser_GetTokenIndex(jsonparser_t * Instance, uint8_t * const TokenToFind)
 {
 	int32_t FoundToken = -1;
-	uint16_t TokenOffset = 0;
-	uint16_t TokenStart;
 	uint16_t TokenSize;
-	uint8_t StringStatus;
 
 	assert(Instance);
 	assert(TokenToFind);
 
-	/* sweep the string tokens until the requested one is found */
-
-	/* only sweep when there are tokens */
+	/* only look when there are tokens */
 	if(Instance->Tokens)
 	{
 		TokenSize = strlen((char*)TokenToFind);
 
 		if(TokenSize > 0)
 		{
+			FoundToken = JsonParser_FindKey(Instance, JSON_PARSER_ANY_PARENT, TokenToFind, TokenSize);
+		}
+	}
+
+	return FoundToken;
+}
+
+/* get the index of the value of key KeyToFind in object ParentIndex, 0 being the root object */
+int32_t JsonParser_GetValueIndex(jsonparser_t * Instance, int32_t ParentIndex, uint8_t * const KeyToFind)
+{
+	int32_t FoundValue = -1;
+	int32_t FoundKey;
+	uint16_t KeySize;
+
+	assert(Instance);
+	assert(KeyToFind);
+
+	if(Instance->Tokens)
+	{
+		KeySize = strlen((char*)KeyToFind);
+
+		if(KeySize > 0)
+		{
+			FoundKey = JsonParser_FindKey(Instance, ParentIndex, KeyToFind, KeySize);
 
-			while(TokenOffset < Instance->Tokens)
+			/* the value always follows its key */
+			if((FoundKey >= 0) && ((FoundKey + 1) < Instance->Tokens))
 			{
+				FoundValue = FoundKey + 1;
+			}
+		}
+	}
 
-				if(Instance->ParsedJson[TokenOffset].type == JSMN_STRING)
-				{
-					TokenStart = Instance->ParsedJson[TokenOffset].start;
+	return FoundValue;
+}
 
-					StringStatus = MiscFunction_StringCompare(TokenToFind,&Instance->JsonBuffer[TokenStart],TokenSize);
+/* get a value by path, keys split by '.' and array elements as [n], i.e. "config.sensors[2].period" */
+status_t JsonParser_Query(jsonparser_t * Instance, uint8_t * const Path, jsonparser_value_t * Value)
+{
+	status_t Status = kStatus_Fail;
+	const uint8_t * PathOffset = Path;
+	int32_t TokenIndex = 0;
+	jsmntok_t * Token;
 
-					if(StringStatus == STRING_OK)
-					{
-						FoundToken = TokenOffset;
-						break;
-					}
+	assert(Instance);
+	assert(Path);
+	assert(Value);
+
+	if(Instance->Tokens)
+	{
+		/* every segment moves one level down, object keys go through the index */
+		while((*PathOffset != '\0') && (TokenIndex >= 0))
+		{
+			if(*PathOffset == JSON_PARSER_PATH_INDEX_START)
+			{
+				TokenIndex = JsonParser_QueryElement(Instance, TokenIndex, &PathOffset);
+			}
+			else
+			{
+				TokenIndex = JsonParser_QueryKey(Instance, TokenIndex, &PathOffset);
+			}
+
+			/* a separator must be followed by a key */
+			if(*PathOffset == JSON_PARSER_PATH_SEPARATOR)
+			{
+				PathOffset++;
+
+				if((*PathOffset == '\0') || (*PathOffset == JSON_PARSER_PATH_INDEX_START))
+				{
+					TokenIndex = -1;
 				}
+			}
+		}
+
+		if(TokenIndex >= 0)
+		{
+			Token = &Instance->ParsedJson[TokenIndex];
+
+			Value->TokenIndex = TokenIndex;
+			Value->Data = &Instance->JsonBuffer[Token->start];
+			Value->Size = Token->end - Token->start;
 
-				TokenOffset++;
+			if(Token->type == JSMN_OBJECT)
+			{
+				Value->Type = JSON_PARSER_TYPE_OBJECT;
+			}
+			else if(Token->type == JSMN_ARRAY)
+			{
+				Value->Type = JSON_PARSER_TYPE_ARRAY;
 			}
+			else if(Token->type == JSMN_STRING)
+			{
+				Value->Type = JSON_PARSER_TYPE_STRING;
+			}
+			else if((Value->Data[0] == 't') || (Value->Data[0] == 'f'))
+			{
+				Value->Type = JSON_PARSER_TYPE_BOOLEAN;
+			}
+			else if(Value->Data[0] == 'n')
+			{
+				Value->Type = JSON_PARSER_TYPE_NULL;
+			}
+			else
+			{
+				Value->Type = JSON_PARSER_TYPE_NUMBER;
+			}
+
+			Status = kStatus_Success;
 		}
 	}
 
-	return FoundToken;
+	return Status;
 }
 
 status_t JasonParser_GetStringToken(jsonparser_t * Instance, int32_t TokenIndex, uint8_t * Buffer)
@@ -169,7 +435,7 @@ status_t JasonParser_GetStringToken(jsonparser_t * Instance, int32_t TokenIndex,
 	assert(Instance);
 	assert(Buffer);
 
-	if(TokenIndex > 0)
+	if((TokenIndex >= 0) && (TokenIndex < Instance->Tokens))
 	{
 		if(Instance->ParsedJson[TokenIndex].type == JSMN_STRING)
 		{
@@ -190,29 +456,720 @@ status_t JasonParser_GetStringToken(jsonparser_t * Instance, int32_t TokenIndex,
 }
 
 status_t JasonParser_GetIntegerToken(jsonparser_t * Instance, int32_t TokenIndex, uint32_t * TokenDataBuffer)
+{
+	assert(Instance);
+	assert(TokenDataBuffer);
+
+	return JsonParser_GetUnsigned(Instance, TokenIndex, TokenDataBuffer);
+}
+
+status_t JsonParser_GetUnsigned(jsonparser_t * Instance, int32_t TokenIndex, uint32_t * Value)
+{
+	status_t Status;
+	uint64_t Magnitude;
+	bool isNegative;
+
+	assert(Instance);
+	assert(Value);
+
+	Status = JsonParser_DecodeInteger(Instance, TokenIndex, UINT32_MAX, false, &Magnitude, &isNegative);
+
+	if(Status == kStatus_Success)
+	{
+		*Value = (uint32_t)Magnitude;
+	}
+
+	return Status;
+}
+
+status_t JsonParser_GetSigned(jsonparser_t * Instance, int32_t TokenIndex, int32_t * Value)
+{
+	status_t Status;
+	uint64_t Magnitude;
+	bool isNegative;
+
+	assert(Instance);
+	assert(Value);
+
+	Status = JsonParser_DecodeInteger(Instance, TokenIndex, INT32_MAX, true, &Magnitude, &isNegative);
+
+	if(Status == kStatus_Success)
+	{
+		/* through uint32_t, -2147483648 has no positive counterpart */
+		*Value = (isNegative == true) ? (int32_t)(0 - (uint32_t)Magnitude) : (int32_t)Magnitude;
+	}
+
+	return Status;
+}
+
+status_t JsonParser_GetUnsigned64(jsonparser_t * Instance, int32_t TokenIndex, uint64_t * Value)
+{
+	status_t Status;
+	uint64_t Magnitude;
+	bool isNegative;
+
+	assert(Instance);
+	assert(Value);
+
+	Status = JsonParser_DecodeInteger(Instance, TokenIndex, UINT64_MAX, false, &Magnitude, &isNegative);
+
+	if(Status == kStatus_Success)
+	{
+		*Value = Magnitude;
+	}
+
+	return Status;
+}
+
+status_t JsonParser_GetSigned64(jsonparser_t * Instance, int32_t TokenIndex, int64_t * Value)
+{
+	status_t Status;
+	uint64_t Magnitude;
+	bool isNegative;
+
+	assert(Instance);
+	assert(Value);
+
+	Status = JsonParser_DecodeInteger(Instance, TokenIndex, INT64_MAX, true, &Magnitude, &isNegative);
+
+	if(Status == kStatus_Success)
+	{
+		*Value = (isNegative == true) ? (int64_t)(0 - Magnitude) : (int64_t)Magnitude;
+	}
+
+	return Status;
+}
+
+/* decimal number to a q format with FractionBits, i.e. q8_t, exponents are not supported */
+status_t JsonParser_GetFixedPoint(jsonparser_t * Instance, int32_t TokenIndex, uint8_t FractionBits, int32_t * Value)
 {
 	status_t Status = kStatus_Fail;
-	uint8_t * StringRemainder;
-	uint16_t TokenOffset;
+	const uint8_t * Data;
+	uint16_t DataSize;
+	uint16_t DataOffset = 0;
+	uint64_t Integer = 0;
+	uint32_t Fraction = 0;
+	uint32_t Denominator = 1;
+	uint8_t FractionDigits = 0;
+	uint64_t Magnitude;
+	uint64_t Limit;
+	bool isNegative = false;
+	bool isValid = false;
 
 	assert(Instance);
-	assert(TokenDataBuffer);
+	assert(Value);
 
-	if(TokenIndex > 0)
+	if((FractionBits <= JSON_PARSER_FRACTION_BITS_MAX) && \
+			(JsonParser_GetPrimitive(Instance, TokenIndex, &Data, &DataSize) == true))
 	{
-		if(Instance->ParsedJson[TokenIndex].type == JSMN_PRIMITIVE)
+		if(Data[0] == '-')
 		{
+			isNegative = true;
+			DataOffset++;
+		}
 
-			TokenOffset = Instance->ParsedJson[TokenIndex].start;
+		/* the integer part has 31 - FractionBits bits, one more count for negatives */
+		Limit = (uint64_t)(INT32_MAX >> FractionBits) + 1;
+
+		while((DataOffset < DataSize) && (Data[DataOffset] >= '0') && (Data[DataOffset] <= '9') && (Integer <= Limit))
+		{
+			Integer = (Integer * 10) + (Data[DataOffset] - '0');
+			DataOffset++;
+			isValid = true;
+		}
+
+		if((DataOffset < DataSize) && (Data[DataOffset] == '.'))
+		{
+			DataOffset++;
+			isValid = false;
+
+			while((DataOffset < DataSize) && (Data[DataOffset] >= '0') && (Data[DataOffset] <= '9'))
+			{
+				if(FractionDigits < JSON_PARSER_FRACTION_DIGITS_MAX)
+				{
+					Fraction = (Fraction * 10) + (Data[DataOffset] - '0');
+					Denominator *= 10;
+					FractionDigits++;
+				}
+
+				DataOffset++;
+				isValid = true;
+			}
+		}
+
+		if((isValid == true) && (DataOffset == DataSize) && (Integer <= Limit))
+		{
+			/* the only division, rounded to the nearest q step */
+			Magnitude = (Integer << FractionBits) + \
+					((((uint64_t)Fraction << FractionBits) + (Denominator / 2)) / Denominator);
+
+			if(Magnitude <= ((uint64_t)INT32_MAX + ((isNegative == true) ? 1 : 0)))
+			{
+				*Value = (isNegative == true) ? (int32_t)(0 - (uint32_t)Magnitude) : (int32_t)Magnitude;
+
+				Status = kStatus_Success;
+			}
+		}
+	}
+
+	return Status;
+}
+
+status_t JsonParser_GetBoolean(jsonparser_t * Instance, int32_t TokenIndex, bool * Value)
+{
+	status_t Status = kStatus_Fail;
+	const uint8_t * Data;
+	uint16_t DataSize;
+
+	assert(Instance);
+	assert(Value);
+
+	if(JsonParser_GetPrimitive(Instance, TokenIndex, &Data, &DataSize) == true)
+	{
+		if((DataSize == 4) && (MiscFunction_StringCompare((const uint8_t *)"true", Data, DataSize) == STRING_OK))
+		{
+			*Value = true;
+			Status = kStatus_Success;
+		}
+		else if((DataSize == 5) && (MiscFunction_StringCompare((const uint8_t *)"false", Data, DataSize) == STRING_OK))
+		{
+			*Value = false;
+			Status = kStatus_Success;
+		}
+	}
+
+	return Status;
+}
+
+/* copy a string value NUL terminated, fails when it doesn't fit instead of truncating it */
+status_t JsonParser_GetString(jsonparser_t * Instance, int32_t TokenIndex, uint8_t * Buffer, uint16_t BufferSize)
+{
+	status_t Status = kStatus_Fail;
+	jsmntok_t * Token;
+	uint16_t StringSize;
+
+	assert(Instance);
+	assert(Buffer);
+
+	if((TokenIndex >= 0) && (TokenIndex < Instance->Tokens))
+	{
+		Token = &Instance->ParsedJson[TokenIndex];
+
+		StringSize = Token->end - Token->start;
+
+		if((Token->type == JSMN_STRING) && (StringSize < BufferSize))
+		{
+			MiscFunctions_MemCopy(&Instance->JsonBuffer[Token->start], Buffer, StringSize);
+
+			Buffer[StringSize] = '\0';
+
+			Status = kStatus_Success;
+		}
+	}
+
+	return Status;
+}
+
+/* first element of an array, -1 when empty */
+int32_t JsonParser_GetFirstElement(jsonparser_t * Instance, int32_t ArrayIndex)
+{
+	int32_t FirstElement = -1;
+
+	assert(Instance);
+
+	if((ArrayIndex >= 0) && (ArrayIndex < Instance->Tokens))
+	{
+		if((Instance->ParsedJson[ArrayIndex].type == JSMN_ARRAY) && (Instance->ParsedJson[ArrayIndex].size > 0))
+		{
+			FirstElement = ArrayIndex + 1;
+		}
+	}
+
+	return FirstElement;
+}
+
+/* element after ElementIndex skipping its children, -1 after the last one */
+int32_t JsonParser_GetNextElement(jsonparser_t * Instance, int32_t ElementIndex)
+{
+	int32_t NextElement = -1;
+	int32_t TokenIndex;
+
+	assert(Instance);
+
+	if((ElementIndex > 0) && (ElementIndex < Instance->Tokens))
+	{
+		TokenIndex = JsonParser_SkipToken(Instance, ElementIndex);
+
+		/* siblings share the parent, anything else is past the end of the array */
+		if((TokenIndex < Instance->Tokens) && \
+				(Instance->ParsedJson[TokenIndex].parent == Instance->ParsedJson[ElementIndex].parent))
+		{
+			NextElement = TokenIndex;
+		}
+	}
+
+	return NextElement;
+}
+
+/* the previous block goes back to the pool when nothing was taken after it */
+static void JsonParser_Release(jsonparser_t * Instance)
+{
+	if((Instance->PoolSize > 0) && (Instance->Pool->Used == (Instance->PoolOffset + Instance->PoolSize)))
+	{
+		Instance->Pool->Used = Instance->PoolOffset;
+	}
+
+	Instance->ParsedJson = NULL;
+	Instance->MaxTokens = 0;
+	Instance->KeyIndex = NULL;
+	Instance->KeyIndexSize = 0;
+	Instance->PoolSize = 0;
+}
+
+/* tokens and their key index in one block */
+static status_t JsonParser_Allocate(jsonparser_t * Instance, uint32_t TokenCount)
+{
+	status_t Status = kStatus_JsonParser_NoMemory;
+	jsonparser_pool_t * Pool = Instance->Pool;
+	uint32_t KeyIndexSize = 1;
+	uint32_t BlockOffset;
+	uint32_t BlockSize;
+
+	JsonParser_Release(Instance);
+
+	if(TokenCount > JSON_PARSER_TOKENS_MAX)
+	{
+		TokenCount = JSON_PARSER_TOKENS_MAX;
+	}
+
+	while(KeyIndexSize < (TokenCount * 2))
+	{
+		KeyIndexSize <<= 1;
+	}
+
+	BlockOffset = (Pool->Used + (JSON_PARSER_POOL_ALIGNMENT - 1)) & ~(JSON_PARSER_POOL_ALIGNMENT - 1);
+	BlockSize = (TokenCount * sizeof(jsmntok_t)) + (KeyIndexSize * sizeof(int16_t));
+
+	if((BlockOffset <= Pool->Size) && (BlockSize <= (Pool->Size - BlockOffset)))
+	{
+		Instance->ParsedJson = (jsmntok_t *)&Pool->Buffer[BlockOffset];
+		Instance->MaxTokens = (uint16_t)TokenCount;
+		Instance->KeyIndex = (int16_t *)&Pool->Buffer[BlockOffset + (TokenCount * sizeof(jsmntok_t))];
+		Instance->KeyIndexSize = (uint16_t)KeyIndexSize;
+
+		Instance->PoolOffset = BlockOffset;
+		Instance->PoolSize = BlockSize;
+		Pool->Used = BlockOffset + BlockSize;
+
+		Status = kStatus_Success;
+	}
+
+	return Status;
+}
+
+static uint32_t JsonParser_Hash(const uint8_t * Key, uint16_t KeySize)
+{
+	uint32_t Hash = JSON_PARSER_FNV_OFFSET;
+
+	/* FNV-1a, good enough spread for short key names */
+	while(KeySize--)
+	{
+		Hash ^= *Key;
+		Hash *= JSON_PARSER_FNV_PRIME;
+		Key++;
+	}
+
+	return Hash;
+}
+
+static void JsonParser_BuildKeyIndex(jsonparser_t * Instance)
+{
+	jsmntok_t * Token;
+	int32_t TokenOffset;
+	int32_t Parent;
+	uint32_t Slot;
+
+	for(Slot = 0; Slot < Instance->KeyIndexSize; Slot++)
+	{
+		Instance->KeyIndex[Slot] = JSON_PARSER_EMPTY_SLOT;
+	}
+
+	for(TokenOffset = 0; TokenOffset < Instance->Tokens; TokenOffset++)
+	{
+		Token = &Instance->ParsedJson[TokenOffset];
+		Parent = Token->parent;
+
+		/* only keys go in, strings whose parent is an object, values hang from their key */
+		if((Token->type == JSMN_STRING) && (Parent >= 0) && (Instance->ParsedJson[Parent].type == JSMN_OBJECT))
+		{
+			Slot = JsonParser_Hash(&Instance->JsonBuffer[Token->start], Token->end - Token->start);
+
+			/* linear probing, keys with the same name stay in document order */
+			while(Instance->KeyIndex[Slot & (Instance->KeyIndexSize - 1)] != JSON_PARSER_EMPTY_SLOT)
+			{
+				Slot++;
+			}
+
+			Instance->KeyIndex[Slot & (Instance->KeyIndexSize - 1)] = (int16_t)TokenOffset;
+		}
+	}
+}
+
+static int32_t JsonParser_FindKey(jsonparser_t * Instance, int32_t ParentIndex, const uint8_t * Key, uint16_t KeySize)
+{
+	jsmntok_t * Token;
+	int32_t FoundKey = -1;
+	int32_t TokenIndex;
+	uint32_t Slot;
+	uint16_t Probes = 0;
+
+	Slot = JsonParser_Hash(Key, KeySize);
+
+	TokenIndex = Instance->KeyIndex[Slot & (Instance->KeyIndexSize - 1)];
+
+	/* an empty slot ends the chain, a full table ends after one lap */
+	while((TokenIndex != JSON_PARSER_EMPTY_SLOT) && (Probes < Instance->KeyIndexSize))
+	{
+		Token = &Instance->ParsedJson[TokenIndex];
+
+		if(((Token->end - Token->start) == KeySize) && \
+			((ParentIndex == JSON_PARSER_ANY_PARENT) || (Token->parent == ParentIndex)))
+		{
+			if(MiscFunction_StringCompare(Key,&Instance->JsonBuffer[Token->start],KeySize) == STRING_OK)
+			{
+				FoundKey = TokenIndex;
+				break;
+			}
+		}
+
+		Slot++;
+		Probes++;
+
+		TokenIndex = Instance->KeyIndex[Slot & (Instance->KeyIndexSize - 1)];
+	}
+
+	return FoundKey;
+}
+
+/* fill Destination from the object at ObjectIndex walking its keys once, members of invalid values are left as they were */
+status_t JsonParser_Bind(jsonparser_t * Instance, int32_t ObjectIndex, const jsonparser_field_t * Fields, uint8_t FieldCount, \
+		void * Destination, jsonparser_bind_result_t * Result)
+{
+	status_t Status = kStatus_Fail;
+	int32_t KeyIndex;
+	int32_t KeyCount;
+	uint16_t KeySize;
+	uint8_t FieldIndex;
+	uint32_t FoundFields = 0;
+	uint32_t FieldsMask;
+	jsmntok_t * Key;
+
+	assert(Instance);
+	assert(Fields);
+	assert(Destination);
+	assert(Result);
+	assert(FieldCount <= JSON_PARSER_BIND_FIELDS_MAX);
+
+	MiscFunctions_MemClear(Result, sizeof(jsonparser_bind_result_t));
+
+	FieldsMask = (FieldCount < JSON_PARSER_BIND_FIELDS_MAX) ? ((1UL << FieldCount) - 1) : 0xFFFFFFFFUL;
+
+	if((ObjectIndex >= 0) && (ObjectIndex < Instance->Tokens))
+	{
+		if(Instance->ParsedJson[ObjectIndex].type == JSMN_OBJECT)
+		{
+			KeyIndex = ObjectIndex + 1;
+
+			for(KeyCount = Instance->ParsedJson[ObjectIndex].size; KeyCount > 0; KeyCount--)
+			{
+				Key = &Instance->ParsedJson[KeyIndex];
+				KeySize = Key->end - Key->start;
+
+				FieldIndex = 0;
+
+				/* same size and characters, the descriptor key ending right there */
+				while((FieldIndex < FieldCount) && \
+						((MiscFunction_StringCompare((const uint8_t *)Fields[FieldIndex].Key, &Instance->JsonBuffer[Key->start], KeySize) != STRING_OK) || \
+						(Fields[FieldIndex].Key[KeySize] != '\0')))
+				{
+					FieldIndex++;
+				}
+
+				if(FieldIndex < FieldCount)
+				{
+					FoundFields |= (1UL << FieldIndex);
+
+					if(JsonParser_BindField(Instance, KeyIndex + 1, &Fields[FieldIndex], (uint8_t *)Destination) != kStatus_Success)
+					{
+						Result->InvalidFields |= (1UL << FieldIndex);
+					}
+				}
+				else
+				{
+					Result->UnknownKeys++;
+				}
+
+				/* over the key and its whole value */
+				KeyIndex = JsonParser_SkipToken(Instance, KeyIndex);
+			}
+
+			Result->MissingFields = (~FoundFields) & FieldsMask;
+
+			if((Result->MissingFields == 0) && (Result->InvalidFields == 0) && (Result->UnknownKeys == 0))
+			{
+				Status = kStatus_Success;
+			}
+		}
+	}
+
+	return Status;
+}
+
+/* anything that isn't whitespace, a string or structure can be part of a number or literal */
+static bool JsonParser_IsUnquotedCharacter(uint8_t Character)
+{
+	bool isUnquoted = true;
+
+	if((Character == ' ') || (Character == '\t') || (Character == '\r') || (Character == '\n') || \
+		(Character == ',') || (Character == ':') || (Character == '"') || \
+		(Character == '{') || (Character == '}') || (Character == '[') || (Character == ']'))
+	{
+		isUnquoted = false;
+	}
+
+	return isUnquoted;
+}
+
+/* index of the token after TokenIndex and all its children */
+static int32_t JsonParser_SkipToken(jsonparser_t * Instance, int32_t TokenIndex)
+{
+	int32_t Pending = 1;
+
+	/* keys have size 1 for their value, so sizes add up for objects too */
+	while((Pending > 0) && (TokenIndex < Instance->Tokens))
+	{
+		Pending += Instance->ParsedJson[TokenIndex].size - 1;
+		TokenIndex++;
+	}
+
+	return TokenIndex;
+}
+
+static bool JsonParser_GetPrimitive(jsonparser_t * Instance, int32_t TokenIndex, const uint8_t ** Data, uint16_t * DataSize)
+{
+	bool isPrimitive = false;
+	jsmntok_t * Token;
+
+	if((TokenIndex >= 0) && (TokenIndex < Instance->Tokens))
+	{
+		Token = &Instance->ParsedJson[TokenIndex];
+
+		if((Token->type == JSMN_PRIMITIVE) && (Token->end > Token->start))
+		{
+			*Data = &Instance->JsonBuffer[Token->start];
+			*DataSize = Token->end - Token->start;
+			isPrimitive = true;
+		}
+	}
+
+	return isPrimitive;
+}
+
+/* single pass over the token digits, fails on anything but digits or when over Limit (+1 if negative) */
+static status_t JsonParser_DecodeInteger(jsonparser_t * Instance, int32_t TokenIndex, uint64_t Limit, bool isSigned, \
+		uint64_t * Magnitude, bool * isNegative)
+{
+	status_t Status = kStatus_Fail;
+	const uint8_t * Data;
+	uint16_t DataSize;
+	uint16_t DataOffset = 0;
+	uint64_t Value = 0;
+	uint64_t LimitTens;
+	uint8_t LimitUnits;
+	uint8_t Digit;
 
-			*TokenDataBuffer = strtoul((char*)&Instance->JsonBuffer[TokenOffset], (char**)&StringRemainder, 10);
+	*isNegative = false;
+
+	if(JsonParser_GetPrimitive(Instance, TokenIndex, &Data, &DataSize) == true)
+	{
+		if((isSigned == true) && (Data[0] == '-'))
+		{
+			*isNegative = true;
+			Limit++;
+			DataOffset++;
+		}
 
+		/* split once so each digit is checked without dividing */
+		LimitTens = Limit / 10;
+		LimitUnits = (uint8_t)(Limit - (LimitTens * 10));
+
+		if(DataOffset < DataSize)
+		{
 			Status = kStatus_Success;
 		}
+
+		while((DataOffset < DataSize) && (Status == kStatus_Success))
+		{
+			Digit = Data[DataOffset] - '0';
+
+			if((Digit > 9) || (Value > LimitTens) || ((Value == LimitTens) && (Digit > LimitUnits)))
+			{
+				Status = kStatus_Fail;
+			}
+			else
+			{
+				Value = (Value * 10) + Digit;
+			}
+
+			DataOffset++;
+		}
+
+		*Magnitude = Value;
 	}
 
 	return Status;
+}
+
+/* decode a value into its member, only written when the type matches and it is within bounds */
+static status_t JsonParser_BindField(jsonparser_t * Instance, int32_t TokenIndex, const jsonparser_field_t * Field, \
+		uint8_t * Destination)
+{
+	status_t Status = kStatus_Fail;
+	bool isBounded;
+	uint32_t UnsignedValue;
+	int32_t SignedValue;
+	bool BooleanValue;
+
+	isBounded = ((Field->Minimum != 0) || (Field->Maximum != 0)) ? true : false;
+
+	switch(Field->Type)
+	{
+		case JSON_PARSER_FIELD_UNSIGNED:
+			assert(Field->Size == sizeof(uint32_t));
+
+			if(JsonParser_GetUnsigned(Instance, TokenIndex, &UnsignedValue) == kStatus_Success)
+			{
+				if((isBounded == false) || \
+						((UnsignedValue >= (uint32_t)Field->Minimum) && (UnsignedValue <= (uint32_t)Field->Maximum)))
+				{
+					*(uint32_t *)&Destination[Field->Offset] = UnsignedValue;
+					Status = kStatus_Success;
+				}
+			}
+			break;
+		case JSON_PARSER_FIELD_SIGNED:
+		case JSON_PARSER_FIELD_FIXED_POINT:
+			assert(Field->Size == sizeof(int32_t));
+
+			if(Field->Type == JSON_PARSER_FIELD_SIGNED)
+			{
+				Status = JsonParser_GetSigned(Instance, TokenIndex, &SignedValue);
+			}
+			else
+			{
+				Status = JsonParser_GetFixedPoint(Instance, TokenIndex, Field->FractionBits, &SignedValue);
+			}
+
+			if(Status == kStatus_Success)
+			{
+				if((isBounded == false) || ((SignedValue >= Field->Minimum) && (SignedValue <= Field->Maximum)))
+				{
+					*(int32_t *)&Destination[Field->Offset] = SignedValue;
+				}
+				else
+				{
+					Status = kStatus_Fail;
+				}
+			}
+			break;
+		case JSON_PARSER_FIELD_BOOLEAN:
+			assert(Field->Size == sizeof(bool));
+
+			Status = JsonParser_GetBoolean(Instance, TokenIndex, &BooleanValue);
+
+			if(Status == kStatus_Success)
+			{
+				*(bool *)&Destination[Field->Offset] = BooleanValue;
+			}
+			break;
+		case JSON_PARSER_FIELD_STRING:
+			Status = JsonParser_GetString(Instance, TokenIndex, &Destination[Field->Offset], Field->Size);
+			break;
+		default:
+			break;
+	}
+
+	return Status;
+}
+
+static int32_t JsonParser_QueryKey(jsonparser_t * Instance, int32_t TokenIndex, const uint8_t ** Path)
+{
+	const uint8_t * Key = *Path;
+	uint16_t KeySize = 0;
+	int32_t FoundValue = -1;
+	int32_t FoundKey;
+
+	while((Key[KeySize] != '\0') && (Key[KeySize] != JSON_PARSER_PATH_SEPARATOR) && \
+			(Key[KeySize] != JSON_PARSER_PATH_INDEX_START))
+	{
+		KeySize++;
+	}
+
+	if((KeySize > 0) && (Instance->ParsedJson[TokenIndex].type == JSMN_OBJECT))
+	{
+		FoundKey = JsonParser_FindKey(Instance, TokenIndex, Key, KeySize);
+
+		if((FoundKey >= 0) && ((FoundKey + 1) < Instance->Tokens))
+		{
+			FoundValue = FoundKey + 1;
+		}
+	}
+
+	*Path = &Key[KeySize];
+
+	return FoundValue;
+}
+
+static int32_t JsonParser_QueryElement(jsonparser_t * Instance, int32_t TokenIndex, const uint8_t ** Path)
+{
+	const uint8_t * Index = *Path + 1;
+	int32_t Element = 0;
+	int32_t FoundElement = -1;
+	bool isValidIndex = false;
+
+	while((*Index >= '0') && (*Index <= '9') && (Element < Instance->Tokens))
+	{
+		Element = (Element * 10) + (*Index - '0');
+		Index++;
+		isValidIndex = true;
+	}
+
+	if((isValidIndex == true) && (*Index == JSON_PARSER_PATH_INDEX_END))
+	{
+		Index++;
+
+		/* the element ends the segment, a key can't follow without a separator */
+		if((*Index != '\0') && (*Index != JSON_PARSER_PATH_SEPARATOR) && (*Index != JSON_PARSER_PATH_INDEX_START))
+		{
+			isValidIndex = false;
+		}
+
+		if((isValidIndex == true) && (Instance->ParsedJson[TokenIndex].type == JSMN_ARRAY) && \
+				(Element < Instance->ParsedJson[TokenIndex].size))
+		{
+			/* whole elements are skipped by their child count */
+			FoundElement = TokenIndex + 1;
+
+			while(Element--)
+			{
+				FoundElement = JsonParser_SkipToken(Instance, FoundElement);
+			}
+		}
+	}
+
+	*Path = Index;
 
+	return FoundElement;
 }
 
 /* EOF */
@@ -37,30 +37,120 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include "jsmn.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                  Defines & Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-#define JSON_PARSER_MAX_TOKENS	(64)
+/* ParentIndex to look for a key in any object */
+#define JSON_PARSER_ANY_PARENT	(-1)
+
+/* one bit per field in jsonparser_bind_result_t */
+#define JSON_PARSER_BIND_FIELDS_MAX	(32)
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                      Typedef Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+enum _jsonparser_status
+{
+	/* the streamed document isn't complete yet, feed the next chunk */
+	kStatus_JsonParser_Incomplete = MAKE_STATUS(kStatusGroup_ApplicationRangeStart, 0),
+	/* the pool can't hold the tokens of the document */
+	kStatus_JsonParser_NoMemory = MAKE_STATUS(kStatusGroup_ApplicationRangeStart, 2),
+};
+
+/* caller memory the parsers borrow their tokens from, allocations are released by resetting it */
+typedef struct
+{
+	uint8_t * Buffer;
+	uint32_t Size;
+	uint32_t Used;
+}jsonparser_pool_t;
+
 typedef struct
 {
 	jsmn_parser Parser;
-	jsmntok_t ParsedJson[JSON_PARSER_MAX_TOKENS];
+	jsmntok_t * ParsedJson;
+	uint16_t MaxTokens;
 	uint8_t * JsonBuffer;
 	int32_t Tokens;
+	/* bytes in JsonBuffer and its size when streaming */
+	uint16_t StreamSize;
+	uint16_t StreamBufferSize;
+	/* key tokens hashed by name, -1 on empty slots, a power of two at least twice the tokens */
+	int16_t * KeyIndex;
+	uint16_t KeyIndexSize;
+	/* the block taken from the pool, given back when this instance parses again while it is the last one */
+	jsonparser_pool_t * Pool;
+	uint32_t PoolOffset;
+	uint32_t PoolSize;
 }jsonparser_t;
 
+typedef enum
+{
+	JSON_PARSER_TYPE_OBJECT = 0,
+	JSON_PARSER_TYPE_ARRAY,
+	JSON_PARSER_TYPE_STRING,
+	JSON_PARSER_TYPE_NUMBER,
+	JSON_PARSER_TYPE_BOOLEAN,
+	JSON_PARSER_TYPE_NULL,
+}jsonparser_type_t;
+
+/* a value in place, Data points into the JSON buffer and isn't NUL terminated */
+typedef struct
+{
+	jsonparser_type_t Type;
+	const uint8_t * Data;
+	uint16_t Size;
+	int32_t TokenIndex;
+}jsonparser_value_t;
+
+typedef enum
+{
+	JSON_PARSER_FIELD_UNSIGNED = 0,
+	JSON_PARSER_FIELD_SIGNED,
+	JSON_PARSER_FIELD_FIXED_POINT,
+	JSON_PARSER_FIELD_BOOLEAN,
+	JSON_PARSER_FIELD_STRING,
+}jsonparser_field_type_t;
+
+/* a struct member bound to a key, Minimum and Maximum both 0 leave it unbounded */
+typedef struct
+{
+	const char * Key;
+	uint16_t Offset;
+	/* member size, the buffer size for strings */
+	uint16_t Size;
+	jsonparser_field_type_t Type;
+	uint8_t FractionBits;
+	/* read as uint32_t for unsigned fields */
+	int32_t Minimum;
+	int32_t Maximum;
+}jsonparser_field_t;
+
+/* field bits follow the order of the descriptor table */
+typedef struct
+{
+	uint32_t MissingFields;
+	uint32_t InvalidFields;
+	uint16_t UnknownKeys;
+}jsonparser_bind_result_t;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                Function-like Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+#define JSON_PARSER_FIELD(Key, Struct, Member, Type, Minimum, Maximum)	\
+	{(Key), offsetof(Struct, Member), sizeof(((Struct *)0)->Member), (Type), 0, (Minimum), (Maximum)}
+
+#define JSON_PARSER_FIXED_POINT_FIELD(Key, Struct, Member, FractionBits, Minimum, Maximum)	\
+	{(Key), offsetof(Struct, Member), sizeof(((Struct *)0)->Member), JSON_PARSER_FIELD_FIXED_POINT, \
+		(FractionBits), (Minimum), (Maximum)}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                  Extern Constants Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -77,16 +167,49 @@ typedef struct
 extern "C" {
 #endif // __cplusplus
 
-status_t JsonParser_Init(jsonparser_t * InitInstance);
+status_t JsonParser_PoolInit(jsonparser_pool_t * Pool, uint8_t * Buffer, uint32_t BufferSize);
+
+status_t JsonParser_PoolReset(jsonparser_pool_t * Pool);
+
+status_t JsonParser_Init(jsonparser_t * InitInstance, jsonparser_pool_t * Pool);
 
 status_t JsonParser_Parse(jsonparser_t * Instance, uint8_t * InputBuffer, uint16_t BufferSize);
 
+status_t JsonParser_StreamStart(jsonparser_t * Instance, uint8_t * StreamBuffer, uint16_t StreamBufferSize);
+
+status_t JsonParser_StreamParse(jsonparser_t * Instance, uint8_t * Chunk, uint16_t ChunkSize);
+
 int32_t JsonParser_GetTokenIndex(jsonparser_t * Instance, uint8_t * const TokenToFind);
 
+int32_t JsonParser_GetValueIndex(jsonparser_t * Instance, int32_t ParentIndex, uint8_t * const KeyToFind);
+
+status_t JsonParser_Query(jsonparser_t * Instance, uint8_t * const Path, jsonparser_value_t * Value);
+
 status_t JasonParser_GetStringToken(jsonparser_t * Instance, int32_t TokenIndex, uint8_t * Buffer);
 
 status_t JasonParser_GetIntegerToken(jsonparser_t * Instance, int32_t TokenIndex, uint32_t * TokenDataBuffer);
 
+status_t JsonParser_GetUnsigned(jsonparser_t * Instance, int32_t TokenIndex, uint32_t * Value);
+
+status_t JsonParser_GetSigned(jsonparser_t * Instance, int32_t TokenIndex, int32_t * Value);
+
+status_t JsonParser_GetUnsigned64(jsonparser_t * Instance, int32_t TokenIndex, uint64_t * Value);
+
+status_t JsonParser_GetSigned64(jsonparser_t * Instance, int32_t TokenIndex, int64_t * Value);
+
+status_t JsonParser_GetFixedPoint(jsonparser_t * Instance, int32_t TokenIndex, uint8_t FractionBits, int32_t * Value);
+
+status_t JsonParser_GetBoolean(jsonparser_t * Instance, int32_t TokenIndex, bool * Value);
+
+status_t JsonParser_GetString(jsonparser_t * Instance, int32_t TokenIndex, uint8_t * Buffer, uint16_t BufferSize);
+
+int32_t JsonParser_GetFirstElement(jsonparser_t * Instance, int32_t ArrayIndex);
+
+int32_t JsonParser_GetNextElement(jsonparser_t * Instance, int32_t ElementIndex);
+
+status_t JsonParser_Bind(jsonparser_t * Instance, int32_t ObjectIndex, const jsonparser_field_t * Fields, uint8_t FieldCount, \
+		void * Destination, jsonparser_bind_result_t * Result);
+
 #if defined(__cplusplus)
 }
 #endif // __cplusplus
@@ -0,0 +1,586 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "fsl_common.h"
+#include "MiscFunctions.h"
+#include "RingBuffer.h"
+#include "JsonWriter.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* ten digits for 32 bits */
+#define JSON_WRITER_NUMBER_SIZE		(10)
+
+#define JSON_WRITER_DECIMALS_MAX	(9)
+
+#define JSON_WRITER_FRACTION_BITS_MAX	(31)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void JsonWriter_Put(jsonwriter_t * Writer, const uint8_t * Data, uint16_t DataSize);
+
+static bool JsonWriter_BeginValue(jsonwriter_t * Writer);
+
+static void JsonWriter_PutString(jsonwriter_t * Writer, const uint8_t * String);
+
+static void JsonWriter_PutUnsigned(jsonwriter_t * Writer, uint32_t Value);
+
+static status_t JsonWriter_Begin(jsonwriter_t * Writer, uint8_t Opening, bool isObject);
+
+static status_t JsonWriter_End(jsonwriter_t * Writer, uint8_t Closing, bool isObject);
+
+static status_t JsonWriter_GetStatus(jsonwriter_t * Writer, bool isValid);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const uint8_t JsonWriter_HexDigits[] = "0123456789abcdef";
+
+static const uint32_t JsonWriter_DecimalScale[JSON_WRITER_DECIMALS_MAX + 1] =
+{
+	1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+status_t JsonWriter_Init(jsonwriter_t * Writer, uint8_t * Buffer, uint16_t BufferSize)
+{
+	status_t Status = kStatus_Fail;
+
+	assert(Writer);
+	assert(Buffer);
+
+	MiscFunctions_MemClear(Writer, sizeof(jsonwriter_t));
+
+	/* one byte is kept for the terminator */
+	if(BufferSize > 0)
+	{
+		Writer->Buffer = Buffer;
+		Writer->BufferSize = BufferSize - 1;
+		Writer->Buffer[0] = '\0';
+
+		Status = kStatus_Success;
+	}
+
+	return Status;
+}
+
+status_t JsonWriter_InitRingBuffer(jsonwriter_t * Writer, RingBuffer_t * RingBuffer)
+{
+	assert(Writer);
+	assert(RingBuffer);
+
+	MiscFunctions_MemClear(Writer, sizeof(jsonwriter_t));
+
+	Writer->RingBuffer = RingBuffer;
+
+	return kStatus_Success;
+}
+
+status_t JsonWriter_BeginObject(jsonwriter_t * Writer)
+{
+	assert(Writer);
+
+	return JsonWriter_Begin(Writer, '{', true);
+}
+
+status_t JsonWriter_EndObject(jsonwriter_t * Writer)
+{
+	assert(Writer);
+
+	return JsonWriter_End(Writer, '}', true);
+}
+
+status_t JsonWriter_BeginArray(jsonwriter_t * Writer)
+{
+	assert(Writer);
+
+	return JsonWriter_Begin(Writer, '[', false);
+}
+
+status_t JsonWriter_EndArray(jsonwriter_t * Writer)
+{
+	assert(Writer);
+
+	return JsonWriter_End(Writer, ']', false);
+}
+
+status_t JsonWriter_Key(jsonwriter_t * Writer, const uint8_t * Key)
+{
+	bool isValid = false;
+
+	assert(Writer);
+	assert(Key);
+
+	/* keys only go in objects, and not twice in a row */
+	if((Writer->Depth > 0) && (Writer->isKeyWritten == false) && \
+			CHECK_FLAG(Writer->ObjectLevels, (Writer->Depth - 1)))
+	{
+		if(CHECK_FLAG(Writer->FilledLevels, (Writer->Depth - 1)))
+		{
+			JsonWriter_Put(Writer, (const uint8_t *)",", 1);
+		}
+
+		SET_FLAG(Writer->FilledLevels, (Writer->Depth - 1));
+
+		JsonWriter_PutString(Writer, Key);
+		JsonWriter_Put(Writer, (const uint8_t *)":", 1);
+
+		Writer->isKeyWritten = true;
+		isValid = true;
+	}
+
+	return JsonWriter_GetStatus(Writer, isValid);
+}
+
+status_t JsonWriter_String(jsonwriter_t * Writer, const uint8_t * String)
+{
+	bool isValid;
+
+	assert(Writer);
+	assert(String);
+
+	isValid = JsonWriter_BeginValue(Writer);
+
+	if(isValid == true)
+	{
+		JsonWriter_PutString(Writer, String);
+	}
+
+	return JsonWriter_GetStatus(Writer, isValid);
+}
+
+status_t JsonWriter_Unsigned(jsonwriter_t * Writer, uint32_t Value)
+{
+	bool isValid;
+
+	assert(Writer);
+
+	isValid = JsonWriter_BeginValue(Writer);
+
+	if(isValid == true)
+	{
+		JsonWriter_PutUnsigned(Writer, Value);
+	}
+
+	return JsonWriter_GetStatus(Writer, isValid);
+}
+
+status_t JsonWriter_Signed(jsonwriter_t * Writer, int32_t Value)
+{
+	uint32_t Magnitude = (uint32_t)Value;
+	bool isValid;
+
+	assert(Writer);
+
+	isValid = JsonWriter_BeginValue(Writer);
+
+	if(isValid == true)
+	{
+		if(Value < 0)
+		{
+			Magnitude = 0 - Magnitude;
+			JsonWriter_Put(Writer, (const uint8_t *)"-", 1);
+		}
+
+		JsonWriter_PutUnsigned(Writer, Magnitude);
+	}
+
+	return JsonWriter_GetStatus(Writer, isValid);
+}
+
+/* q format value with FractionBits, i.e. q8_t, printed rounded to Decimals digits */
+status_t JsonWriter_FixedPoint(jsonwriter_t * Writer, int32_t Value, uint8_t FractionBits, uint8_t Decimals)
+{
+	uint8_t Number[JSON_WRITER_DECIMALS_MAX + 1];
+	uint32_t Magnitude = (uint32_t)Value;
+	uint32_t Integer;
+	uint32_t Fraction;
+	uint64_t Scaled;
+	uint8_t DigitIndex;
+	bool isValid = false;
+
+	assert(Writer);
+
+	if((FractionBits <= JSON_WRITER_FRACTION_BITS_MAX) && (Decimals <= JSON_WRITER_DECIMALS_MAX))
+	{
+		isValid = JsonWriter_BeginValue(Writer);
+	}
+
+	if(isValid == true)
+	{
+		if(Value < 0)
+		{
+			Magnitude = 0 - Magnitude;
+			JsonWriter_Put(Writer, (const uint8_t *)"-", 1);
+		}
+
+		Integer = Magnitude >> FractionBits;
+
+		/* scale the fraction to the decimals and round half up, a carry goes to the integer */
+		Scaled = (uint64_t)(Magnitude - (Integer << FractionBits)) * JsonWriter_DecimalScale[Decimals];
+
+		if(FractionBits > 0)
+		{
+			Scaled += (1ULL << (FractionBits - 1));
+		}
+
+		Fraction = (uint32_t)(Scaled >> FractionBits);
+
+		if(Fraction >= JsonWriter_DecimalScale[Decimals])
+		{
+			Fraction -= JsonWriter_DecimalScale[Decimals];
+			Integer++;
+		}
+
+		JsonWriter_PutUnsigned(Writer, Integer);
+
+		if(Decimals > 0)
+		{
+			Number[0] = '.';
+
+			/* leading zeros of the fraction are kept */
+			for(DigitIndex = Decimals; DigitIndex > 0; DigitIndex--)
+			{
+				Number[DigitIndex] = '0' + (Fraction % 10);
+				Fraction /= 10;
+			}
+
+			JsonWriter_Put(Writer, &Number[0], Decimals + 1);
+		}
+	}
+
+	return JsonWriter_GetStatus(Writer, isValid);
+}
+
+status_t JsonWriter_Boolean(jsonwriter_t * Writer, bool Value)
+{
+	bool isValid;
+
+	assert(Writer);
+
+	isValid = JsonWriter_BeginValue(Writer);
+
+	if(isValid == true)
+	{
+		if(Value == true)
+		{
+			JsonWriter_Put(Writer, (const uint8_t *)"true", 4);
+		}
+		else
+		{
+			JsonWriter_Put(Writer, (const uint8_t *)"false", 5);
+		}
+	}
+
+	return JsonWriter_GetStatus(Writer, isValid);
+}
+
+status_t JsonWriter_Null(jsonwriter_t * Writer)
+{
+	bool isValid;
+
+	assert(Writer);
+
+	isValid = JsonWriter_BeginValue(Writer);
+
+	if(isValid == true)
+	{
+		JsonWriter_Put(Writer, (const uint8_t *)"null", 4);
+	}
+
+	return JsonWriter_GetStatus(Writer, isValid);
+}
+
+/* success only when every container was closed and nothing was dropped */
+status_t JsonWriter_Finish(jsonwriter_t * Writer)
+{
+	assert(Writer);
+
+	return JsonWriter_GetStatus(Writer, ((Writer->Depth == 0) && (Writer->isKeyWritten == false)));
+}
+
+uint16_t JsonWriter_GetSize(jsonwriter_t * Writer)
+{
+	assert(Writer);
+
+	return Writer->Size;
+}
+
+/* nothing is written after the first piece that doesn't fit. The flat buffer drops the	*/
+/* partial value too, the ring buffer can't as the reader may already have taken it		*/
+static void JsonWriter_Put(jsonwriter_t * Writer, const uint8_t * Data, uint16_t DataSize)
+{
+	if(Writer->isTruncated == false)
+	{
+		if(Writer->RingBuffer != NULL)
+		{
+			if(RingBuffer_SpaceAvailable(Writer->RingBuffer) >= DataSize)
+			{
+				RingBuffer_WriteBuffer(Writer->RingBuffer, (uint8_t *)Data, DataSize);
+				Writer->Size += DataSize;
+			}
+			else
+			{
+				Writer->isTruncated = true;
+			}
+		}
+		else
+		{
+			if((Writer->BufferSize - Writer->Size) >= DataSize)
+			{
+				MiscFunctions_MemCopy(Data, &Writer->Buffer[Writer->Size], DataSize);
+				Writer->Size += DataSize;
+				Writer->Buffer[Writer->Size] = '\0';
+			}
+			else
+			{
+				Writer->Size = Writer->CommittedSize;
+				Writer->Buffer[Writer->Size] = '\0';
+				Writer->isTruncated = true;
+			}
+		}
+	}
+}
+
+/* checks a value is expected here and writes the separator */
+static bool JsonWriter_BeginValue(jsonwriter_t * Writer)
+{
+	bool isValid = false;
+
+	if(Writer->Depth == 0)
+	{
+		/* a single value at the top */
+		isValid = (Writer->Size == 0) ? true : false;
+	}
+	else if(CHECK_FLAG(Writer->ObjectLevels, (Writer->Depth - 1)))
+	{
+		/* the key already wrote the separator */
+		isValid = Writer->isKeyWritten;
+		Writer->isKeyWritten = false;
+	}
+	else
+	{
+		if(CHECK_FLAG(Writer->FilledLevels, (Writer->Depth - 1)))
+		{
+			JsonWriter_Put(Writer, (const uint8_t *)",", 1);
+		}
+
+		SET_FLAG(Writer->FilledLevels, (Writer->Depth - 1));
+		isValid = true;
+	}
+
+	return isValid;
+}
+
+/* quoted and escaped, runs of plain characters are copied at once */
+static void JsonWriter_PutString(jsonwriter_t * Writer, const uint8_t * String)
+{
+	uint8_t Escape[6] = {'\\', 'u', '0', '0', 0, 0};
+	uint8_t EscapeSize;
+	uint16_t RunSize = 0;
+
+	JsonWriter_Put(Writer, (const uint8_t *)"\"", 1);
+
+	while(String[RunSize] != '\0')
+	{
+		if((String[RunSize] < ' ') || (String[RunSize] == '"') || (String[RunSize] == '\\'))
+		{
+			JsonWriter_Put(Writer, String, RunSize);
+
+			EscapeSize = 2;
+
+			switch(String[RunSize])
+			{
+				case '"':
+				case '\\':
+					Escape[1] = String[RunSize];
+					break;
+				case '\b':
+					Escape[1] = 'b';
+					break;
+				case '\f':
+					Escape[1] = 'f';
+					break;
+				case '\n':
+					Escape[1] = 'n';
+					break;
+				case '\r':
+					Escape[1] = 'r';
+					break;
+				case '\t':
+					Escape[1] = 't';
+					break;
+				default:
+					Escape[1] = 'u';
+					Escape[4] = JsonWriter_HexDigits[String[RunSize] >> 4];
+					Escape[5] = JsonWriter_HexDigits[String[RunSize] & 0x0F];
+					EscapeSize = 6;
+					break;
+			}
+
+			JsonWriter_Put(Writer, &Escape[0], EscapeSize);
+
+			String = &String[RunSize + 1];
+			RunSize = 0;
+		}
+		else
+		{
+			RunSize++;
+		}
+	}
+
+	JsonWriter_Put(Writer, String, RunSize);
+	JsonWriter_Put(Writer, (const uint8_t *)"\"", 1);
+}
+
+/* digits are filled from the right so nothing needs reversing */
+static void JsonWriter_PutUnsigned(jsonwriter_t * Writer, uint32_t Value)
+{
+	uint8_t Number[JSON_WRITER_NUMBER_SIZE];
+	uint8_t DigitIndex = JSON_WRITER_NUMBER_SIZE;
+
+	do
+	{
+		DigitIndex--;
+		Number[DigitIndex] = '0' + (Value % 10);
+		Value /= 10;
+	}while(Value > 0);
+
+	JsonWriter_Put(Writer, &Number[DigitIndex], JSON_WRITER_NUMBER_SIZE - DigitIndex);
+}
+
+static status_t JsonWriter_Begin(jsonwriter_t * Writer, uint8_t Opening, bool isObject)
+{
+	bool isValid = false;
+
+	if(Writer->Depth < JSON_WRITER_DEPTH_MAX)
+	{
+		isValid = JsonWriter_BeginValue(Writer);
+	}
+
+	if(isValid == true)
+	{
+		JsonWriter_Put(Writer, &Opening, 1);
+
+		Writer->Depth++;
+
+		CLEAR_FLAG(Writer->FilledLevels, (Writer->Depth - 1));
+
+		if(isObject == true)
+		{
+			SET_FLAG(Writer->ObjectLevels, (Writer->Depth - 1));
+		}
+		else
+		{
+			CLEAR_FLAG(Writer->ObjectLevels, (Writer->Depth - 1));
+		}
+	}
+
+	return JsonWriter_GetStatus(Writer, isValid);
+}
+
+static status_t JsonWriter_End(jsonwriter_t * Writer, uint8_t Closing, bool isObject)
+{
+	bool isValid = false;
+	bool isObjectLevel;
+
+	if((Writer->Depth > 0) && (Writer->isKeyWritten == false))
+	{
+		isObjectLevel = CHECK_FLAG(Writer->ObjectLevels, (Writer->Depth - 1)) ? true : false;
+
+		if(isObjectLevel == isObject)
+		{
+			JsonWriter_Put(Writer, &Closing, 1);
+
+			Writer->Depth--;
+			isValid = true;
+		}
+	}
+
+	return JsonWriter_GetStatus(Writer, isValid);
+}
+
+static status_t JsonWriter_GetStatus(jsonwriter_t * Writer, bool isValid)
+{
+	status_t Status = kStatus_Success;
+
+	if(Writer->isTruncated == true)
+	{
+		Status = kStatus_JsonWriter_Truncated;
+	}
+	else if(isValid == false)
+	{
+		Status = kStatus_Fail;
+	}
+	else if(Writer->isKeyWritten == false)
+	{
+		/* a key alone is not a complete value, it goes with the one after it */
+		Writer->CommittedSize = Writer->Size;
+	}
+
+	return Status;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,136 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+#ifndef JSON_WRITER_H_
+#define JSON_WRITER_H_
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "RingBuffer.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* one bit per level in ObjectLevels and FilledLevels */
+#define JSON_WRITER_DEPTH_MAX	(16)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+enum _jsonwriter_status
+{
+	/* the sink ran out of space. A flat buffer is rolled back to the last complete value,	*/
+	/* a ring buffer keeps what was written up to the first piece that didn't fit			*/
+	kStatus_JsonWriter_Truncated = MAKE_STATUS(kStatusGroup_ApplicationRangeStart, 1),
+};
+
+typedef struct
+{
+	/* either a flat buffer, kept NUL terminated, or a ring buffer */
+	uint8_t * Buffer;
+	RingBuffer_t * RingBuffer;
+	uint16_t BufferSize;
+	uint16_t Size;
+	/* size at the end of the last complete value, where a truncated flat buffer ends */
+	uint16_t CommittedSize;
+	uint8_t Depth;
+	/* levels that are objects and levels that already hold a value */
+	uint32_t ObjectLevels;
+	uint32_t FilledLevels;
+	bool isKeyWritten;
+	bool isTruncated;
+}jsonwriter_t;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                Function-like Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Extern Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Extern Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+status_t JsonWriter_Init(jsonwriter_t * Writer, uint8_t * Buffer, uint16_t BufferSize);
+
+status_t JsonWriter_InitRingBuffer(jsonwriter_t * Writer, RingBuffer_t * RingBuffer);
+
+status_t JsonWriter_BeginObject(jsonwriter_t * Writer);
+
+status_t JsonWriter_EndObject(jsonwriter_t * Writer);
+
+status_t JsonWriter_BeginArray(jsonwriter_t * Writer);
+
+status_t JsonWriter_EndArray(jsonwriter_t * Writer);
+
+status_t JsonWriter_Key(jsonwriter_t * Writer, const uint8_t * Key);
+
+status_t JsonWriter_String(jsonwriter_t * Writer, const uint8_t * String);
+
+status_t JsonWriter_Unsigned(jsonwriter_t * Writer, uint32_t Value);
+
+status_t JsonWriter_Signed(jsonwriter_t * Writer, int32_t Value);
+
+status_t JsonWriter_FixedPoint(jsonwriter_t * Writer, int32_t Value, uint8_t FractionBits, uint8_t Decimals);
+
+status_t JsonWriter_Boolean(jsonwriter_t * Writer, bool Value);
+
+status_t JsonWriter_Null(jsonwriter_t * Writer);
+
+status_t JsonWriter_Finish(jsonwriter_t * Writer);
+
+uint16_t JsonWriter_GetSize(jsonwriter_t * Writer);
+
+#if defined(__cplusplus)
+}
+#endif // __cplusplus
+
+
+#endif /* JSON_WRITER_H_ */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
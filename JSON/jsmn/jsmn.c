@@ -10,7 +10,7 @@ static jsmntok_t *jsmn_alloc_token(jsmn_parser *parser,
         return NULL;
     }
     tok = &tokens[parser->toknext++];
-    tok->start = tok->end = -1;
+    tok->start = tok->end = JSMN_NO_POSITION;
     tok->size = 0;
 #ifdef JSMN_PARENT_LINKS
     tok->parent = -1;
@@ -22,7 +22,7 @@ static jsmntok_t *jsmn_alloc_token(jsmn_parser *parser,
  * Fills token type and boundaries.
  */
 static void jsmn_fill_token(jsmntok_t *token, jsmntype_t type,
-                            int start, int end) {
+                            unsigned int start, unsigned int end) {
     token->type = type;
     token->start = start;
     token->end = end;
@@ -155,6 +155,13 @@ int jsmn_parse(jsmn_parser *parser, const char *js, size_t len,
     jsmntok_t *token;
     int count = parser->toknext;
 
+#ifdef JSMN_PACKED_TOKENS
+    /* The last position is the unset marker */
+    if (len >= JSMN_NO_POSITION) {
+        return JSMN_ERROR_INVAL;
+    }
+#endif
+
     for (; parser->pos < len && js[parser->pos] != '\0'; parser->pos++) {
         char c;
         jsmntype_t type;
@@ -189,7 +196,7 @@ int jsmn_parse(jsmn_parser *parser, const char *js, size_t len,
                 }
                 token = &tokens[parser->toknext - 1];
                 for (;;) {
-                    if (token->start != -1 && token->end == -1) {
+                    if (token->start != JSMN_NO_POSITION && token->end == JSMN_NO_POSITION) {
                         if (token->type != type) {
                             return JSMN_ERROR_INVAL;
                         }
@@ -208,7 +215,7 @@ int jsmn_parse(jsmn_parser *parser, const char *js, size_t len,
 #else
                 for (i = parser->toknext - 1; i >= 0; i--) {
                     token = &tokens[i];
-                    if (token->start != -1 && token->end == -1) {
+                    if (token->start != JSMN_NO_POSITION && token->end == JSMN_NO_POSITION) {
                         if (token->type != type) {
                             return JSMN_ERROR_INVAL;
                         }
@@ -221,7 +228,7 @@ int jsmn_parse(jsmn_parser *parser, const char *js, size_t len,
                 if (i == -1) return JSMN_ERROR_INVAL;
                 for (; i >= 0; i--) {
                     token = &tokens[i];
-                    if (token->start != -1 && token->end == -1) {
+                    if (token->start != JSMN_NO_POSITION && token->end == JSMN_NO_POSITION) {
                         parser->toksuper = i;
                         break;
                     }
@@ -249,7 +256,7 @@ int jsmn_parse(jsmn_parser *parser, const char *js, size_t len,
 #else
                     for (i = parser->toknext - 1; i >= 0; i--) {
                         if (tokens[i].type == JSMN_ARRAY || tokens[i].type == JSMN_OBJECT) {
-                            if (tokens[i].start != -1 && tokens[i].end == -1) {
+                            if (tokens[i].start != JSMN_NO_POSITION && tokens[i].end == JSMN_NO_POSITION) {
                                 parser->toksuper = i;
                                 break;
                             }
@@ -293,7 +300,7 @@ int jsmn_parse(jsmn_parser *parser, const char *js, size_t len,
     if (tokens != NULL) {
         for (i = parser->toknext - 1; i >= 0; i--) {
             /* Unmatched opened object or array */
-            if (tokens[i].start != -1 && tokens[i].end == -1) {
+            if (tokens[i].start != JSMN_NO_POSITION && tokens[i].end == JSMN_NO_POSITION) {
                 return JSMN_ERROR_PART;
             }
         }
@@ -24,10 +24,21 @@
 #define __JSMN_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 /* Include the parent links so we can more easily traverse the JSON structure. */
 #define JSMN_PARENT_LINKS
 
+/* Define JSMN_PACKED_TOKENS for 8 byte tokens instead of 20: 16 bit positions, up to
+ * 64 KB - 2 of JSON, and the type packed with a 13 bit size, up to 8191 children. */
+#ifdef JSMN_PACKED_TOKENS
+typedef uint16_t jsmnpos_t;
+#define JSMN_NO_POSITION	((jsmnpos_t)0xFFFF)
+#else
+typedef int jsmnpos_t;
+#define JSMN_NO_POSITION	(-1)
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -62,6 +73,17 @@ enum jsmnerr {
  * start	start position in JSON data string
  * end		end position in JSON data string
  */
+#ifdef JSMN_PACKED_TOKENS
+typedef struct {
+    jsmnpos_t start;
+    jsmnpos_t end;
+    uint16_t type : 3;
+    uint16_t size : 13;
+#ifdef JSMN_PARENT_LINKS
+    int16_t parent;
+#endif
+} jsmntok_t;
+#else
 typedef struct {
     jsmntype_t type;
     int start;
@@ -71,6 +93,7 @@ typedef struct {
     int parent;
 #endif
 } jsmntok_t;
+#endif
 
 /**
  * JSON parser. Contains an array of token blocks available. Also stores
@@ -0,0 +1,320 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Time of the word at a time string functions against the byte loops they
+ * replaced, at several lengths, with the strings word aligned and then one
+ * byte off. Compare runs over two equal strings, find looks for a token
+ * that isn't there and search finds a pattern at the very end, so each one
+ * walks the whole string. Every result is checked against the byte loop
+ * before it is timed. The host reads 32 bit words like the target does, the
+ * numbers show the ratio, not the Cortex-M time.
+ *
+ * usage: MiscFunctionsBenchmark [characters per round]
+ *
+ * gcc -O2 -I.. MiscFunctionsBenchmark.c ../MiscFunctions.c -o MiscFunctionsBenchmark
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "MiscFunctions.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MISC_BENCHMARK_CHARACTERS_DEFAULT	(20000000)
+
+#define MISC_BENCHMARK_ROUNDS				(5)
+
+#define MISC_BENCHMARK_SIZE_MAX				(512)
+
+/* room for the misaligned start and the terminator */
+#define MISC_BENCHMARK_BUFFER_SIZE			(MISC_BENCHMARK_SIZE_MAX + 8)
+
+#define MISC_BENCHMARK_PATTERN				"OK"
+
+#define MISC_BENCHMARK_PATTERN_SIZE			(sizeof(MISC_BENCHMARK_PATTERN) - 1)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+	MISC_BENCHMARK_COMPARE_WORD = 0,
+	MISC_BENCHMARK_COMPARE_BYTE,
+	MISC_BENCHMARK_FIND_WORD,
+	MISC_BENCHMARK_FIND_BYTE,
+	MISC_BENCHMARK_SEARCH_WORD,
+	MISC_BENCHMARK_SEARCH_BYTE,
+	MISC_BENCHMARK_CASES
+}misc_benchmark_case_t;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static double MiscBenchmark_GetTime(void);
+
+static intptr_t MiscBenchmark_Run(misc_benchmark_case_t Case, uint8_t * StringA, uint8_t * StringB, uint16_t Size);
+
+static uint8_t MiscBenchmark_ByteCompare(const uint8_t * StringBase, const uint8_t * StringToCompare, uint16_t AmountOfCharacters);
+
+static uint8_t * MiscBenchmark_ByteFind(uint8_t * StringToSearch, uint8_t Token);
+
+static int32_t MiscBenchmark_ByteSearch(const uint8_t * Source, uint16_t SourceSize, const uint8_t * StringToSearch, \
+		uint16_t StringToSearchSize);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const uint16_t MiscBenchmarkSizes[] = {8, 32, 128, 512};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint8_t MiscBenchmarkStringA[MISC_BENCHMARK_BUFFER_SIZE] __attribute__((aligned(4)));
+
+static uint8_t MiscBenchmarkStringB[MISC_BENCHMARK_BUFFER_SIZE] __attribute__((aligned(4)));
+
+/* the result of every call goes here so the loops aren't optimized away */
+static volatile intptr_t MiscBenchmarkSink;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char ** argv)
+{
+	uint32_t Characters = MISC_BENCHMARK_CHARACTERS_DEFAULT;
+	uint32_t Mismatches = 0;
+	uint32_t Calls;
+	uint32_t Call;
+	uint32_t Round;
+	uint32_t SizeIndex;
+	uint32_t Case;
+	uint8_t Alignment;
+	uint16_t Size;
+	uint8_t * StringA;
+	uint8_t * StringB;
+	double Times[MISC_BENCHMARK_CASES];
+	double StartTime;
+	double ElapsedTime;
+
+	if(argc > 1)
+	{
+		Characters = (uint32_t)strtoul(argv[1], NULL, 10);
+	}
+
+	for(Alignment = 0; Alignment < 2; Alignment++)
+	{
+		printf("%s, ns per call, word / byte loop\n", (Alignment == 0) ? "aligned" : "one byte off");
+		printf("  size    compare           find              search\n");
+
+		for(SizeIndex = 0; SizeIndex < (sizeof(MiscBenchmarkSizes) / sizeof(MiscBenchmarkSizes[0])); SizeIndex++)
+		{
+			Size = MiscBenchmarkSizes[SizeIndex];
+			StringA = &MiscBenchmarkStringA[Alignment];
+			StringB = &MiscBenchmarkStringB[Alignment];
+
+			/* the pattern closes the string, the token looked for is never in it */
+			memset(StringA, 'x', Size);
+			memcpy(&StringA[Size - MISC_BENCHMARK_PATTERN_SIZE], MISC_BENCHMARK_PATTERN, MISC_BENCHMARK_PATTERN_SIZE);
+			StringA[Size] = '\0';
+			memcpy(StringB, StringA, Size + 1);
+
+			for(Case = 0; Case < MISC_BENCHMARK_CASES; Case += 2)
+			{
+				if(MiscBenchmark_Run((misc_benchmark_case_t)Case, StringA, StringB, Size) != \
+						MiscBenchmark_Run((misc_benchmark_case_t)(Case + 1), StringA, StringB, Size))
+				{
+					printf("size %u, case %u: word and byte loop differ\n", Size, Case);
+					Mismatches++;
+				}
+			}
+
+			Calls = Characters / Size;
+
+			/* interleaved rounds, the best of each is kept to leave out the noise of a shared machine */
+			for(Round = 0; Round < MISC_BENCHMARK_ROUNDS; Round++)
+			{
+				for(Case = 0; Case < MISC_BENCHMARK_CASES; Case++)
+				{
+					StartTime = MiscBenchmark_GetTime();
+
+					for(Call = 0; Call < Calls; Call++)
+					{
+						MiscBenchmarkSink = MiscBenchmark_Run((misc_benchmark_case_t)Case, StringA, StringB, Size);
+					}
+
+					ElapsedTime = MiscBenchmark_GetTime() - StartTime;
+					Times[Case] = ((Round == 0) || (ElapsedTime < Times[Case])) ? ElapsedTime : Times[Case];
+				}
+			}
+
+			printf("  %4u", Size);
+
+			for(Case = 0; Case < MISC_BENCHMARK_CASES; Case += 2)
+			{
+				printf("  %6.1f / %6.1f", (Times[Case] * 1e9) / Calls, (Times[Case + 1] * 1e9) / Calls);
+			}
+
+			printf("\n");
+		}
+	}
+
+	printf("%u mismatches\n", Mismatches);
+
+	return (Mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static intptr_t MiscBenchmark_Run(misc_benchmark_case_t Case, uint8_t * StringA, uint8_t * StringB, uint16_t Size)
+{
+	intptr_t Result;
+
+	switch(Case)
+	{
+		case MISC_BENCHMARK_COMPARE_WORD:
+			Result = MiscFunction_StringCompare(StringA, StringB, Size);
+			break;
+		case MISC_BENCHMARK_COMPARE_BYTE:
+			Result = MiscBenchmark_ByteCompare(StringA, StringB, Size);
+			break;
+		case MISC_BENCHMARK_FIND_WORD:
+			Result = (intptr_t)MiscFunctions_FindTokenInString(StringA, 'y');
+			break;
+		case MISC_BENCHMARK_FIND_BYTE:
+			Result = (intptr_t)MiscBenchmark_ByteFind(StringA, 'y');
+			break;
+		case MISC_BENCHMARK_SEARCH_WORD:
+			Result = MiscFunctions_SearchInString(StringA, Size, (const uint8_t *)MISC_BENCHMARK_PATTERN, \
+					MISC_BENCHMARK_PATTERN_SIZE);
+			break;
+		default:
+			Result = MiscBenchmark_ByteSearch(StringA, Size, (const uint8_t *)MISC_BENCHMARK_PATTERN, \
+					MISC_BENCHMARK_PATTERN_SIZE);
+			break;
+	}
+
+	return Result;
+}
+
+/* the byte loops the word versions replaced, with offsets wide enough for 512 characters */
+static uint8_t MiscBenchmark_ByteCompare(const uint8_t * StringBase, const uint8_t * StringToCompare, uint16_t AmountOfCharacters)
+{
+	uint8_t Status = STRING_OK;
+	uint16_t StringOffset = 0;
+
+	while(AmountOfCharacters--)
+	{
+		if(StringBase[StringOffset] != StringToCompare[StringOffset])
+		{
+			Status = STRING_ERROR;
+			AmountOfCharacters = 0;
+		}
+
+		StringOffset++;
+	}
+
+	return Status;
+}
+
+static uint8_t * MiscBenchmark_ByteFind(uint8_t * StringToSearch, uint8_t Token)
+{
+	uint16_t StringOffset = 0;
+	uint8_t * StringAtToken = NULL;
+
+	while(StringToSearch[StringOffset] != '\0')
+	{
+		if(StringToSearch[StringOffset] == Token)
+		{
+			StringAtToken = &StringToSearch[StringOffset + 1];
+			break;
+		}
+
+		StringOffset++;
+	}
+
+	return StringAtToken;
+}
+
+static int32_t MiscBenchmark_ByteSearch(const uint8_t * Source, uint16_t SourceSize, const uint8_t * StringToSearch, \
+		uint16_t StringToSearchSize)
+{
+	int32_t Position = MISC_FUNCTIONS_NOT_FOUND;
+	uint32_t SourceOffset;
+
+	/* every start position, restarted after a partial match */
+	for(SourceOffset = 0; (SourceOffset + StringToSearchSize) <= SourceSize; SourceOffset++)
+	{
+		if(MiscBenchmark_ByteCompare(&Source[SourceOffset], StringToSearch, StringToSearchSize) == STRING_OK)
+		{
+			Position = (int32_t)SourceOffset;
+			break;
+		}
+	}
+
+	return Position;
+}
+
+static double MiscBenchmark_GetTime(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (double)Now.tv_sec + ((double)Now.tv_nsec / 1000000000.0);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,291 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Host check of the word at a time string functions against plain byte
+ * loops, on every alignment. Built with the alignment sanitizer so any
+ * unaligned word read aborts the run, like a HardFault on Cortex-M0+.
+ *
+ * gcc -O2 -fsanitize=alignment -fno-sanitize-recover=all -I.. \
+ *     MiscFunctionsTest.c ../MiscFunctions.c -o MiscFunctionsTest
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MiscFunctions.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define MISC_TEST_ITERATIONS			(200000)
+
+#define MISC_TEST_STRING_SIZE_MAX		(300)
+
+/* room for any alignment on both sides */
+#define MISC_TEST_BUFFER_SIZE			(MISC_TEST_STRING_SIZE_MAX + 16)
+
+#define MISC_TEST_PATTERN_SIZE_MAX		(6)
+
+#define MISC_TEST_CHECK(Condition, Name)	MiscTest_Check((Condition), (Name), __LINE__)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void MiscTest_Check(bool isPassed, const char * Name, int Line);
+
+static void MiscTest_FixedCases(void);
+
+static void MiscTest_RandomCases(void);
+
+static uint8_t MiscTest_ByteCompare(const uint8_t * StringBase, const uint8_t * StringToCompare, uint16_t AmountOfCharacters);
+
+static uint8_t * MiscTest_ByteFindToken(uint8_t * StringToSearch, uint8_t Token);
+
+static int32_t MiscTest_ByteSearch(const uint8_t * Source, uint16_t SourceSize, const uint8_t * StringToSearch, uint16_t StringToSearchSize);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t MiscTestFailures = 0;
+
+static uint32_t MiscTestChecks = 0;
+
+/* word aligned, the offsets used on top set the alignment of each string */
+static uint32_t MiscTestBufferA[MISC_TEST_BUFFER_SIZE / sizeof(uint32_t)];
+
+static uint32_t MiscTestBufferB[MISC_TEST_BUFFER_SIZE / sizeof(uint32_t)];
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	MiscTest_FixedCases();
+
+	MiscTest_RandomCases();
+
+	printf("%u checks, %u failures\n", MiscTestChecks, MiscTestFailures);
+
+	return (MiscTestFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void MiscTest_Check(bool isPassed, const char * Name, int Line)
+{
+	MiscTestChecks++;
+
+	if(isPassed == false)
+	{
+		/* only the first ones, a broken function fails on every iteration */
+		if(MiscTestFailures < 10)
+		{
+			printf("line %d: %s failed\n", Line, Name);
+		}
+
+		MiscTestFailures++;
+	}
+}
+
+static void MiscTest_FixedCases(void)
+{
+	uint8_t * StringA = (uint8_t *)&MiscTestBufferA[0];
+	uint8_t * StringB = (uint8_t *)&MiscTestBufferB[0];
+
+	/* mismatch on the first byte, both strings one byte past a word boundary */
+	memcpy(&StringA[1], "xbcdefghijkl", 13);
+	memcpy(&StringB[1], "ybcdefghijkl", 13);
+	MISC_TEST_CHECK(MiscFunction_StringCompare(&StringA[1], &StringB[1], 12) == STRING_ERROR, "early unaligned mismatch");
+
+	/* mismatch right before the boundary, the word loop must not start there */
+	memcpy(&StringB[1], "xbYdefghijkl", 13);
+	MISC_TEST_CHECK(MiscFunction_StringCompare(&StringA[1], &StringB[1], 12) == STRING_ERROR, "mismatch before the boundary");
+
+	/* mismatch past the first words */
+	memcpy(&StringB[1], "xbcdefghijkL", 13);
+	MISC_TEST_CHECK(MiscFunction_StringCompare(&StringA[1], &StringB[1], 12) == STRING_ERROR, "late mismatch");
+	MISC_TEST_CHECK(MiscFunction_StringCompare(&StringA[1], &StringB[1], 11) == STRING_OK, "match up to the mismatch");
+
+	MISC_TEST_CHECK(MiscFunction_StringCompare(&StringA[1], &StringB[1], 0) == STRING_OK, "empty compare");
+
+	memcpy(&StringA[3], "a,b:c", 6);
+	MISC_TEST_CHECK(MiscFunctions_FindTokenInString(&StringA[3], ':') == &StringA[7], "token found");
+	MISC_TEST_CHECK(MiscFunctions_FindTokenInString(&StringA[3], '#') == NULL, "token not found");
+
+	/* a partial match right before the real one */
+	MISC_TEST_CHECK(MiscFunctions_SearchInString((const uint8_t *)"aaab", 4, (const uint8_t *)"aab", 3) == 1, "search after a partial match");
+	MISC_TEST_CHECK(MiscFunctions_SearchInString((const uint8_t *)"0,CONNECT", 9, (const uint8_t *)"CONNECT", 7) == 2, "search at the end");
+	MISC_TEST_CHECK(MiscFunctions_SearchInString((const uint8_t *)"0,CLOSED", 8, (const uint8_t *)"CONNECT", 7) == MISC_FUNCTIONS_NOT_FOUND, "search without match");
+}
+
+static void MiscTest_RandomCases(void)
+{
+	uint8_t * StringA;
+	uint8_t * StringB;
+	uint8_t Pattern[MISC_TEST_PATTERN_SIZE_MAX + 1];
+	uint32_t Iteration;
+	uint16_t StringSize;
+	uint16_t CompareSize;
+	uint16_t PatternSize;
+	uint16_t ByteOffset;
+	uint8_t Token;
+
+	srand(1);
+
+	for(Iteration = 0; Iteration < MISC_TEST_ITERATIONS; Iteration++)
+	{
+		StringA = (uint8_t *)&MiscTestBufferA[0] + (rand() % sizeof(uint32_t));
+		StringB = (uint8_t *)&MiscTestBufferB[0] + (rand() % sizeof(uint32_t));
+
+		StringSize = (uint16_t)(rand() % MISC_TEST_STRING_SIZE_MAX);
+
+		/* a small alphabet so partial matches are common */
+		for(ByteOffset = 0; ByteOffset < StringSize; ByteOffset++)
+		{
+			StringA[ByteOffset] = (uint8_t)('a' + (rand() % 3));
+		}
+
+		StringA[StringSize] = '\0';
+
+		memcpy(StringB, StringA, StringSize + 1);
+
+		if(StringSize && (rand() % 2))
+		{
+			StringB[rand() % StringSize] ^= 1;
+		}
+
+		CompareSize = StringSize ? (uint16_t)(rand() % (StringSize + 1)) : 0;
+
+		MISC_TEST_CHECK(MiscFunction_StringCompare(StringA, StringB, CompareSize) == \
+				MiscTest_ByteCompare(StringA, StringB, CompareSize), "random compare");
+
+		Token = (uint8_t)("abcd"[rand() % 4]);
+
+		MISC_TEST_CHECK(MiscFunctions_FindTokenInString(StringA, Token) == MiscTest_ByteFindToken(StringA, Token), "random find");
+
+		PatternSize = (uint16_t)(1 + (rand() % MISC_TEST_PATTERN_SIZE_MAX));
+
+		for(ByteOffset = 0; ByteOffset < PatternSize; ByteOffset++)
+		{
+			Pattern[ByteOffset] = (uint8_t)('a' + (rand() % 3));
+		}
+
+		Pattern[PatternSize] = '\0';
+
+		MISC_TEST_CHECK(MiscFunctions_SearchInString(StringA, StringSize, Pattern, PatternSize) == \
+				MiscTest_ByteSearch(StringA, StringSize, Pattern, PatternSize), "random search");
+	}
+}
+
+static uint8_t MiscTest_ByteCompare(const uint8_t * StringBase, const uint8_t * StringToCompare, uint16_t AmountOfCharacters)
+{
+	uint8_t Status = STRING_OK;
+	uint16_t ByteOffset;
+
+	for(ByteOffset = 0; ByteOffset < AmountOfCharacters; ByteOffset++)
+	{
+		if(StringBase[ByteOffset] != StringToCompare[ByteOffset])
+		{
+			Status = STRING_ERROR;
+		}
+	}
+
+	return Status;
+}
+
+/* same contract as MiscFunctions_FindTokenInString, points past the token */
+static uint8_t * MiscTest_ByteFindToken(uint8_t * StringToSearch, uint8_t Token)
+{
+	uint8_t * TokenPosition = NULL;
+
+	while((*StringToSearch != '\0') && (TokenPosition == NULL))
+	{
+		if(*StringToSearch == Token)
+		{
+			TokenPosition = StringToSearch + 1;
+		}
+
+		StringToSearch++;
+	}
+
+	return TokenPosition;
+}
+
+static int32_t MiscTest_ByteSearch(const uint8_t * Source, uint16_t SourceSize, const uint8_t * StringToSearch, uint16_t StringToSearchSize)
+{
+	int32_t Position = MISC_FUNCTIONS_NOT_FOUND;
+	uint32_t SourceOffset = 0;
+
+	while((Position == MISC_FUNCTIONS_NOT_FOUND) && ((SourceOffset + StringToSearchSize) <= SourceSize))
+	{
+		if(memcmp(&Source[SourceOffset], StringToSearch, StringToSearchSize) == 0)
+		{
+			Position = (int32_t)SourceOffset;
+		}
+
+		SourceOffset++;
+	}
+
+	return Position;
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -39,6 +39,24 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //                                   Defines & Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+#define MISC_FUNCTIONS_WORD_SIZE		(sizeof(uint32_t))
+
+#define MISC_FUNCTIONS_LOW_BITS			(0x01010101UL)
+
+#define MISC_FUNCTIONS_HIGH_BITS		(0x80808080UL)
+
+/* only aligned words are read, a word never crosses past the end of the memory holding its first byte */
+#define MISC_FUNCTIONS_IS_ALIGNED(Address)	((((uintptr_t)(Address)) % MISC_FUNCTIONS_WORD_SIZE) == 0)
+
+/* non zero when any byte of Word is 0 */
+#define MISC_FUNCTIONS_HAS_ZERO(Word)		(((Word) - MISC_FUNCTIONS_LOW_BITS) & ~(Word) & MISC_FUNCTIONS_HIGH_BITS)
+
+/* non zero when any byte of Word is Byte */
+#define MISC_FUNCTIONS_HAS_BYTE(Word,Byte)	MISC_FUNCTIONS_HAS_ZERO((Word) ^ (MISC_FUNCTIONS_LOW_BITS * (Byte)))
+
+/* bad character slots for the search, a power of two */
+#define MISC_FUNCTIONS_SHIFT_TABLE_SIZE		(32)
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                       Typedef Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -69,7 +87,26 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 uint8_t MiscFunction_StringCompare(const uint8_t * StringBase, const uint8_t * StringToCompare, uint16_t AmountOfCharacters)
 {
 	uint8_t bStatus = STRING_OK;
-	uint8_t bStringOffset = 0;
+	uint16_t bStringOffset = 0;
+
+	/* a word at a time when both strings share the alignment, the rest and the mismatching word by bytes */
+	if((((uintptr_t)StringBase ^ (uintptr_t)StringToCompare) % MISC_FUNCTIONS_WORD_SIZE) == 0)
+	{
+		while((AmountOfCharacters > 0) && (MISC_FUNCTIONS_IS_ALIGNED(&StringBase[bStringOffset]) == 0) && \
+				(StringBase[bStringOffset] == StringToCompare[bStringOffset]))
+		{
+			bStringOffset++;
+			AmountOfCharacters--;
+		}
+
+		/* a mismatch can stop the loop above before the alignment, the bytes loop takes it then */
+		while((AmountOfCharacters >= MISC_FUNCTIONS_WORD_SIZE) && MISC_FUNCTIONS_IS_ALIGNED(&StringBase[bStringOffset]) && \
+				(*(const uint32_t *)&StringBase[bStringOffset] == *(const uint32_t *)&StringToCompare[bStringOffset]))
+		{
+			bStringOffset += MISC_FUNCTIONS_WORD_SIZE;
+			AmountOfCharacters -= MISC_FUNCTIONS_WORD_SIZE;
+		}
+	}
 
 	while(AmountOfCharacters--)
 	{
@@ -89,19 +126,18 @@ void MiscFunctions_MemCopy(const void * Source, void * Destination, uint16_t Dat
 {
 	uint8_t * SourceAsByte = (uint8_t*)Source;
 	uint8_t * DestinationAsByte = (uint8_t*)Destination;
-	uint32_t * SourceAsWord = (uint32_t*)Source;
-	uint32_t * DestinationAsWord = (uint32_t*)Destination;
 	uint32_t DataOffset = 0;
 	uint8_t AddressModulo;
 
 	while(DataSize)
 	{
-		AddressModulo = (uint32_t)&DestinationAsByte[DataOffset] % 4;
-		AddressModulo |= (uint32_t)&SourceAsByte[DataOffset] % 4;
+		AddressModulo = (uintptr_t)&DestinationAsByte[DataOffset] % 4;
+		AddressModulo |= (uintptr_t)&SourceAsByte[DataOffset] % 4;
 
 		if((DataSize >= 4)&&(!AddressModulo))
 		{
-			DestinationAsWord[DataOffset/4] = SourceAsWord[DataOffset/4];
+			/* the offset isn't always a multiple of 4 when both become aligned */
+			*(uint32_t*)&DestinationAsByte[DataOffset] = *(uint32_t*)&SourceAsByte[DataOffset];
 			DataOffset += 4;
 			DataSize -= 4;
 		}
@@ -114,34 +150,56 @@ void MiscFunctions_MemCopy(const void * Source, void * Destination, uint16_t Dat
 	}
 }
 
-uint8_t MiscFunctions_SearchInString(const uint8_t * Source, uint16_t SourceSize, const uint8_t * StringToSearch, uint16_t StringToSearchSize)
+/* Horspool, returns the offset of the first match within SourceSize or MISC_FUNCTIONS_NOT_FOUND */
+int32_t MiscFunctions_SearchInString(const uint8_t * Source, uint16_t SourceSize, const uint8_t * StringToSearch, uint16_t StringToSearchSize)
 {
-	uint16_t SourceOffset = 0;
-	uint16_t StringToSearchOffset = 0;
-	uint16_t Status = STRING_ERROR;
-
-	(void)SourceSize;
-	while(Source[SourceOffset] != '\0')
+	uint8_t Shift[MISC_FUNCTIONS_SHIFT_TABLE_SIZE];
+	uint16_t LastIndex;
+	uint16_t StringOffset;
+	uint16_t Distance;
+	uint32_t SourceOffset = 0;
+	int32_t Position = MISC_FUNCTIONS_NOT_FOUND;
+	uint8_t LastCharacter;
+
+	if(StringToSearchSize == 0)
+	{
+		Position = 0;
+	}
+	else if(StringToSearchSize <= SourceSize)
 	{
-		if(Source[SourceOffset] == StringToSearch[StringToSearchOffset])
+		LastIndex = StringToSearchSize - 1;
+
+		/* shifts are capped at 255, a shorter jump never skips a match */
+		for(StringOffset = 0; StringOffset < MISC_FUNCTIONS_SHIFT_TABLE_SIZE; StringOffset++)
 		{
-			StringToSearchOffset++;
+			Shift[StringOffset] = (StringToSearchSize < UINT8_MAX) ? StringToSearchSize : UINT8_MAX;
 		}
-		else
+
+		/* characters share a slot by their low bits, later ones are closer to the end so they keep the smallest shift */
+		for(StringOffset = 0; StringOffset < LastIndex; StringOffset++)
 		{
-			StringToSearchOffset = 0;
+			Distance = LastIndex - StringOffset;
+
+			Shift[StringToSearch[StringOffset] & (MISC_FUNCTIONS_SHIFT_TABLE_SIZE - 1)] = (Distance < UINT8_MAX) ? Distance : UINT8_MAX;
 		}
 
-		if(StringToSearchOffset == StringToSearchSize)
+		while((Position == MISC_FUNCTIONS_NOT_FOUND) && (SourceOffset <= (uint32_t)(SourceSize - StringToSearchSize)))
 		{
-			Status = STRING_OK;
-			break;
+			LastCharacter = Source[SourceOffset + LastIndex];
+
+			if((LastCharacter == StringToSearch[LastIndex]) && \
+					(MiscFunction_StringCompare(&Source[SourceOffset], StringToSearch, LastIndex) == STRING_OK))
+			{
+				Position = (int32_t)SourceOffset;
+			}
+			else
+			{
+				SourceOffset += Shift[LastCharacter & (MISC_FUNCTIONS_SHIFT_TABLE_SIZE - 1)];
+			}
 		}
-
-		SourceOffset++;
 	}
 
-	return(Status);
+	return(Position);
 }
 
 uint8_t MiscFunctions_StringCopyUntilToken(const uint8_t * Source, uint8_t * Destination, uint8_t Token)
@@ -227,20 +285,38 @@ void MiscFunctions_StringReverse(uint8_t * StringToReverse)
 
 uint8_t * MiscFunctions_FindTokenInString(uint8_t * StringToSearch, uint8_t Token)
 {
-	uint8_t StringOffset = 0;
+	uint32_t StringOffset = 0;
+	uint32_t Word;
 	uint8_t * StringAtToken = NULL;
 
-	while(StringToSearch[StringOffset] != '\0')
+	while((MISC_FUNCTIONS_IS_ALIGNED(&StringToSearch[StringOffset]) == 0) && \
+			(StringToSearch[StringOffset] != '\0') && (StringToSearch[StringOffset] != Token))
+	{
+		StringOffset++;
+	}
+
+	/* skip whole words holding neither the terminator nor the token */
+	if(MISC_FUNCTIONS_IS_ALIGNED(&StringToSearch[StringOffset]))
 	{
-		if(StringToSearch[StringOffset] == Token)
+		Word = *(const uint32_t *)&StringToSearch[StringOffset];
+
+		while((MISC_FUNCTIONS_HAS_ZERO(Word) | MISC_FUNCTIONS_HAS_BYTE(Word, Token)) == 0)
 		{
-			StringAtToken = &StringToSearch[StringOffset + 1];
-			break;
+			StringOffset += MISC_FUNCTIONS_WORD_SIZE;
+			Word = *(const uint32_t *)&StringToSearch[StringOffset];
 		}
+	}
 
+	while((StringToSearch[StringOffset] != '\0') && (StringToSearch[StringOffset] != Token))
+	{
 		StringOffset++;
 	}
 
+	if((StringToSearch[StringOffset] == Token) && (Token != '\0'))
+	{
+		StringAtToken = &StringToSearch[StringOffset + 1];
+	}
+
 	return StringAtToken;
 
 }
@@ -270,6 +346,7 @@ uint8_t ReverseBitsInByte(uint8_t DataToReverse)
 	return ReversedBits;
 }
 
+#if defined(__arm__)
 __attribute__((naked))
 void MiscFunctions_BlockingDelay(uint32_t TargetDelay)
 {
@@ -282,3 +359,15 @@ void MiscFunctions_BlockingDelay(uint32_t TargetDelay)
 			"BNE DELAY \n"
 			"BX LR \n");
 }
+#else
+/* host builds (tests and benchmarks), no timing meaning */
+void MiscFunctions_BlockingDelay(uint32_t TargetDelay)
+{
+	volatile uint32_t DelayCounter = TargetDelay;
+
+	while(DelayCounter)
+	{
+		DelayCounter--;
+	}
+}
+#endif
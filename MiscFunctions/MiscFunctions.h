@@ -44,6 +44,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define STRING_OK		(1)
 //! String mismatch status
 #define STRING_ERROR	(0)
+//! No match from MiscFunctions_SearchInString
+#define MISC_FUNCTIONS_NOT_FOUND	(-1)
 
 #define SET_FLAG(Register,Flag)			(Register |= (1<<Flag))
 
@@ -82,7 +84,7 @@ uint8_t MiscFunction_StringCompare(const uint8_t * StringBase, const uint8_t * S
 
 void MiscFunctions_MemCopy(const void * Source, void * Destination, uint16_t DataSize);
 
-uint8_t MiscFunctions_SearchInString(const uint8_t * Source, uint16_t SourceSize, const uint8_t * StringToSearch, uint16_t StringToSearchSize);
+int32_t MiscFunctions_SearchInString(const uint8_t * Source, uint16_t SourceSize, const uint8_t * StringToSearch, uint16_t StringToSearchSize);
 
 void MiscFunctions_MemClear(void * Source, uint16_t DataSize);
 
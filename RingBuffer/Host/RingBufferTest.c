@@ -0,0 +1,188 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Host check of the ring buffer fill level. An empty ring reports no data
+ * and the full size minus one of space, and space plus data stays at the
+ * buffer size minus one across wraps.
+ *
+ * gcc -O2 -Wall -I.. RingBufferTest.c ../RingBuffer.c -o RingBufferTest
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "RingBuffer.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define RING_TEST_SIZE					(16)
+
+#define RING_TEST_ITERATIONS			(100000)
+
+#define RING_TEST_CHECK(Condition, Name)	RingTest_Check((Condition), (Name), __LINE__)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void RingTest_Check(bool isPassed, const char * Name, int Line);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t RingTestFailures = 0;
+
+static uint32_t RingTestChecks = 0;
+
+static uint8_t RingTestStorage[RING_TEST_SIZE];
+
+static RingBuffer_t RingTestBuffer;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	uint8_t Data[RING_TEST_SIZE];
+	uint8_t Readback[RING_TEST_SIZE];
+	uint32_t Expected = 0;
+	uint32_t Iteration;
+	uint32_t Amount;
+	uint8_t Sequence = 0;
+	uint8_t NextRead = 0;
+	uint32_t ByteOffset;
+	bool isInOrder;
+
+	RingBuffer_Init(&RingTestBuffer, &RingTestStorage[0], RING_TEST_SIZE);
+
+	RING_TEST_CHECK(RingBuffer_DataAvailable(&RingTestBuffer) == 0, "empty data");
+	RING_TEST_CHECK(RingBuffer_SpaceAvailable(&RingTestBuffer) == (RING_TEST_SIZE - 1), "empty space");
+
+	srand(1);
+
+	/* random writes and reads, never more than the reported space or data */
+	for(Iteration = 0; Iteration < RING_TEST_ITERATIONS; Iteration++)
+	{
+		if(rand() % 2)
+		{
+			Amount = (uint32_t)(rand() % (RingBuffer_SpaceAvailable(&RingTestBuffer) + 1));
+
+			for(ByteOffset = 0; ByteOffset < Amount; ByteOffset++)
+			{
+				Data[ByteOffset] = Sequence++;
+			}
+
+			RingBuffer_WriteBuffer(&RingTestBuffer, &Data[0], Amount);
+			Expected += Amount;
+		}
+		else
+		{
+			Amount = (uint32_t)(rand() % (RingBuffer_DataAvailable(&RingTestBuffer) + 1));
+
+			RingBuffer_ReadBuffer(&RingTestBuffer, &Readback[0], Amount);
+			Expected -= Amount;
+
+			isInOrder = true;
+
+			for(ByteOffset = 0; ByteOffset < Amount; ByteOffset++)
+			{
+				if(Readback[ByteOffset] != NextRead++)
+				{
+					isInOrder = false;
+				}
+			}
+
+			RING_TEST_CHECK(isInOrder, "read order");
+		}
+
+		RING_TEST_CHECK(RingBuffer_DataAvailable(&RingTestBuffer) == Expected, "data level");
+		RING_TEST_CHECK((RingBuffer_DataAvailable(&RingTestBuffer) + RingBuffer_SpaceAvailable(&RingTestBuffer)) == \
+				(RING_TEST_SIZE - 1), "space plus data");
+	}
+
+	/* drained after wrapping, the pointers are equal again away from the start */
+	RingBuffer_ReadBuffer(&RingTestBuffer, &Readback[0], RingBuffer_DataAvailable(&RingTestBuffer));
+	RING_TEST_CHECK(RingBuffer_DataAvailable(&RingTestBuffer) == 0, "drained data");
+	RING_TEST_CHECK(RingBuffer_SpaceAvailable(&RingTestBuffer) == (RING_TEST_SIZE - 1), "drained space");
+
+	printf("%u checks, %u failures\n", RingTestChecks, RingTestFailures);
+
+	return (RingTestFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void RingTest_Check(bool isPassed, const char * Name, int Line)
+{
+	RingTestChecks++;
+
+	if(isPassed == false)
+	{
+		if(RingTestFailures < 10)
+		{
+			printf("line %d: %s failed\n", Line, Name);
+		}
+
+		RingTestFailures++;
+	}
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -77,8 +77,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *END**************************************************************************/
 void RingBuffer_Init(RingBuffer_t * spRingBuffer, uint8_t * pStartAddress, uint32_t BufferSize)
 {
-	spRingBuffer->StartAddress = (uint32_t)pStartAddress;
-	spRingBuffer->EndAddress   = ((uint32_t)(pStartAddress) + (uint32_t)(BufferSize) - (uint32_t)(1));
+	spRingBuffer->StartAddress = (uintptr_t)pStartAddress;
+	spRingBuffer->EndAddress   = ((uintptr_t)(pStartAddress) + (uintptr_t)(BufferSize) - (uintptr_t)(1));
 	spRingBuffer->BufferSize   = BufferSize;
 	spRingBuffer->pReadPointer = pStartAddress;
 	spRingBuffer->pWritePointer = pStartAddress;
@@ -116,14 +116,14 @@ void RingBuffer_WriteBuffer(RingBuffer_t * psRingBuffer, uint8_t * pOutData, uin
 		SizeOfDataToWrite--;
 
 		/* send to the beginning the pointer */
-		if(((uint32_t)psRingBuffer->pWritePointer) > psRingBuffer->EndAddress)
+		if(((uintptr_t)psRingBuffer->pWritePointer) > psRingBuffer->EndAddress)
 		{
 			psRingBuffer->pWritePointer = ((uint8_t*)psRingBuffer->StartAddress);
 		}
 	}
 
 	/* check for errors */
-	if(((uint32_t)psRingBuffer->pWritePointer) == ((uint32_t)psRingBuffer->pReadPointer))
+	if(((uintptr_t)psRingBuffer->pWritePointer) == ((uintptr_t)psRingBuffer->pReadPointer))
 	{
 		//psRingBuffer->BufferStatus |= (1<<RING_BUFFER_OVERFLOW);
 	}
@@ -142,12 +142,12 @@ void RingBuffer_WriteData(RingBuffer_t * psRingBuffer, uint8_t * pOutData)
 	*(psRingBuffer->pWritePointer) = (*pOutData);
 	psRingBuffer->pWritePointer++;
 	/* send to the beginning the pointer */
-	if(((uint32_t)psRingBuffer->pWritePointer) > psRingBuffer->EndAddress)
+	if(((uintptr_t)psRingBuffer->pWritePointer) > psRingBuffer->EndAddress)
 	{
 		psRingBuffer->pWritePointer = ((uint8_t*)psRingBuffer->StartAddress);
 	}
 	/* check for errors */
-	if(((uint32_t)psRingBuffer->pWritePointer) == ((uint32_t)psRingBuffer->pReadPointer))
+	if(((uintptr_t)psRingBuffer->pWritePointer) == ((uintptr_t)psRingBuffer->pReadPointer))
 	{
 		//psRingBuffer->BufferStatus |= (1<<RING_BUFFER_OVERFLOW);
 	}
@@ -165,12 +165,12 @@ void RingBuffer_ReadData(RingBuffer_t * psRingBuffer, uint8_t * pData)
 	*pData = *(psRingBuffer->pReadPointer);
 	psRingBuffer->pReadPointer++;
 	/* send to the beginning the pointer */
-	if(((uint32_t)psRingBuffer->pReadPointer) > psRingBuffer->EndAddress)
+	if(((uintptr_t)psRingBuffer->pReadPointer) > psRingBuffer->EndAddress)
 	{
 		psRingBuffer->pReadPointer = ((uint8_t*)psRingBuffer->StartAddress);
 	}
 	/* check for errors */
-	if(((uint32_t)psRingBuffer->pWritePointer) == ((uint32_t)psRingBuffer->pReadPointer))
+	if(((uintptr_t)psRingBuffer->pWritePointer) == ((uintptr_t)psRingBuffer->pReadPointer))
 	{
 		//psRingBuffer->BufferStatus |= (1<<RING_BUFFER_OVERFLOW);
 	}
@@ -194,14 +194,14 @@ void RingBuffer_ReadBuffer(RingBuffer_t * psRingBuffer, uint8_t* pDataIn, uint32
 		DataToRead--;
 
 		/* send to the beginning the pointer */
-		if(((uint32_t)psRingBuffer->pReadPointer) > psRingBuffer->EndAddress)
+		if(((uintptr_t)psRingBuffer->pReadPointer) > psRingBuffer->EndAddress)
 		{
 			psRingBuffer->pReadPointer = ((uint8_t*)psRingBuffer->StartAddress);
 		}
 	}
 
 	/* check for errors */
-	if(((uint32_t)psRingBuffer->pWritePointer) == ((uint32_t)psRingBuffer->pReadPointer))
+	if(((uintptr_t)psRingBuffer->pWritePointer) == ((uintptr_t)psRingBuffer->pReadPointer))
 	{
 		//psRingBuffer->BufferStatus |= (1<<RING_BUFFER_OVERFLOW);
 	}
@@ -217,14 +217,14 @@ uint32_t RingBuffer_SpaceAvailable(RingBuffer_t * psRingBuffer)
 {
 	uint32_t SpaceAvailable;
 
-	/* calcualted current available space */
-	if(((uint32_t)psRingBuffer->pWritePointer) > ((uint32_t)psRingBuffer->pReadPointer))
+	/* one byte stays free, equal pointers mean empty */
+	if(((uintptr_t)psRingBuffer->pWritePointer) >= ((uintptr_t)psRingBuffer->pReadPointer))
 	{
-		SpaceAvailable = ((uint32_t)psRingBuffer->pWritePointer - (uint32_t)psRingBuffer->pReadPointer);
+		SpaceAvailable = (psRingBuffer->BufferSize - ((uintptr_t)psRingBuffer->pWritePointer - (uintptr_t)psRingBuffer->pReadPointer) - 1);
 	}
 	else
 	{
-		SpaceAvailable = (psRingBuffer->BufferSize - ((uint32_t)psRingBuffer->pReadPointer - (uint32_t)psRingBuffer->pWritePointer));
+		SpaceAvailable = ((uintptr_t)psRingBuffer->pReadPointer - (uintptr_t)psRingBuffer->pWritePointer - 1);
 	}
 
 	return(SpaceAvailable);
@@ -237,19 +237,19 @@ uint32_t RingBuffer_SpaceAvailable(RingBuffer_t * psRingBuffer)
  *END**************************************************************************/
 uint32_t RingBuffer_DataAvailable(RingBuffer_t * psRingBuffer)
 {
-	uint32_t SpaceAvailable;
+	uint32_t DataAvailable;
 
-	/* calcualted current available space */
-	if(((uint32_t)psRingBuffer->pWritePointer) > ((uint32_t)psRingBuffer->pReadPointer))
+	/* same convention as the space, equal pointers mean empty */
+	if(((uintptr_t)psRingBuffer->pWritePointer) >= ((uintptr_t)psRingBuffer->pReadPointer))
 	{
-		SpaceAvailable = ((uint32_t)psRingBuffer->pWritePointer - (uint32_t)psRingBuffer->pReadPointer);
+		DataAvailable = ((uintptr_t)psRingBuffer->pWritePointer - (uintptr_t)psRingBuffer->pReadPointer);
 	}
 	else
 	{
-		SpaceAvailable = (psRingBuffer->BufferSize - ((uint32_t)psRingBuffer->pReadPointer - (uint32_t)psRingBuffer->pWritePointer));
+		DataAvailable = (psRingBuffer->BufferSize - ((uintptr_t)psRingBuffer->pReadPointer - (uintptr_t)psRingBuffer->pWritePointer));
 	}
 
-	return(SpaceAvailable);
+	return(DataAvailable);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
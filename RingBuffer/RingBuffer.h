@@ -66,8 +66,8 @@ typedef struct
 {
 	uint8_t	*  pWritePointer;
 	uint8_t	*  pReadPointer;
-	uint32_t StartAddress;
-	uint32_t EndAddress;
+	uintptr_t StartAddress;
+	uintptr_t EndAddress;
 	uint32_t BufferSize;
 	uint32_t BufferStatus;
 }RingBuffer_t;
@@ -164,7 +164,12 @@ void RingBuffer_Reset(RingBuffer_t * spRingBuffer);
  */
 uint32_t RingBuffer_SpaceAvailable(RingBuffer_t * psRingBuffer);
 
-
+/*!
+ * @brief Return the amount of data stored, 0 when the read and write pointers are equal.
+ *
+ * @param psRingBuffer pointer to the ring buffer.
+ * @return bytes pending to be read, space plus data is always the buffer size minus one.
+ */
 uint32_t RingBuffer_DataAvailable(RingBuffer_t * psRingBuffer);
 #if defined(__cplusplus)
 }
@@ -0,0 +1,208 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Round trip throughput of the Rpc channel. The command given must echo its
+ * request back, any other answer is counted as a mismatch.
+ *
+ * usage: RpcBenchmark <device> <baud rate> <command id> [calls] [payload size]
+ *
+ * gcc -O2 -DCRC_USE_HARDWARE=0 -I. -I.. -I../../CRC -I../../MiscFunctions \
+ *     RpcBenchmark.c RpcClient.c ../../CRC/CRC.c -o RpcBenchmark
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "RpcClient.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define RPC_BENCHMARK_CALLS_DEFAULT		(1000)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static double RpcBenchmark_GetTime(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static rpc_client_t BenchmarkClient;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char * argv[])
+{
+	int ExitCode = EXIT_FAILURE;
+	uint8_t Request[RPC_CLIENT_REQUEST_SIZE_MAX];
+	uint8_t Response[RPC_CLIENT_RESPONSE_SIZE_MAX];
+	uint16_t ResponseSize;
+	uint16_t PayloadSize = RPC_CLIENT_RESPONSE_SIZE_MAX;
+	uint32_t CallsTotal = RPC_BENCHMARK_CALLS_DEFAULT;
+	uint32_t CallsDone = 0;
+	uint32_t Failures = 0;
+	uint32_t Mismatches = 0;
+	uint32_t ByteOffset;
+	uint8_t CommandId;
+	rpc_status_t CommandStatus;
+	rpc_client_status_t Status;
+	double StartTime;
+	double ElapsedTime;
+
+	if(argc >= 4)
+	{
+		CommandId = (uint8_t)strtoul(argv[3], NULL, 0);
+
+		if(argc >= 5)
+		{
+			CallsTotal = (uint32_t)strtoul(argv[4], NULL, 0);
+		}
+
+		/* the echo can't be larger than what a response carries */
+		if(argc >= 6)
+		{
+			PayloadSize = (uint16_t)strtoul(argv[5], NULL, 0);
+
+			if(PayloadSize > RPC_CLIENT_RESPONSE_SIZE_MAX)
+			{
+				PayloadSize = RPC_CLIENT_RESPONSE_SIZE_MAX;
+			}
+		}
+
+		/* every byte value, END and ESC included, so the escaping is timed too */
+		for(ByteOffset = 0; ByteOffset < PayloadSize; ByteOffset++)
+		{
+			Request[ByteOffset] = (uint8_t)(ByteOffset * 7);
+		}
+
+		Status = RpcClient_Open(&BenchmarkClient, argv[1], (uint32_t)strtoul(argv[2], NULL, 0));
+
+		if(Status == RPC_CLIENT_OK)
+		{
+			StartTime = RpcBenchmark_GetTime();
+
+			while(CallsDone < CallsTotal)
+			{
+				ResponseSize = sizeof(Response);
+
+				Status = RpcClient_Call(&BenchmarkClient, CommandId, &Request[0], PayloadSize, \
+						&Response[0], &ResponseSize, &CommandStatus);
+
+				if((Status != RPC_CLIENT_OK) || (CommandStatus != RPC_OK))
+				{
+					Failures++;
+				}
+				else if((ResponseSize != PayloadSize) || (memcmp(&Request[0], &Response[0], PayloadSize) != 0))
+				{
+					Mismatches++;
+				}
+
+				CallsDone++;
+			}
+
+			ElapsedTime = RpcBenchmark_GetTime() - StartTime;
+
+			printf("calls:           %u in %.3f s\n", CallsDone, ElapsedTime);
+			printf("calls/s:         %.1f\n", CallsDone / ElapsedTime);
+			printf("latency:         %.3f ms\n", (ElapsedTime * 1000.0) / CallsDone);
+			printf("payload:         %u bytes each way\n", PayloadSize);
+			printf("throughput:      %.1f bytes/s each way\n", ((double)CallsDone * PayloadSize) / ElapsedTime);
+			printf("failures:        %u\n", Failures);
+			printf("mismatches:      %u\n", Mismatches);
+			printf("retransmissions: %u\n", BenchmarkClient.Retransmissions);
+			printf("dropped frames:  %u\n", BenchmarkClient.DroppedFrames);
+
+			RpcClient_Close(&BenchmarkClient);
+
+			if((Failures == 0) && (Mismatches == 0))
+			{
+				ExitCode = EXIT_SUCCESS;
+			}
+		}
+		else
+		{
+			printf("can't open %s at %s\n", argv[1], argv[2]);
+		}
+	}
+	else
+	{
+		printf("usage: %s <device> <baud rate> <command id> [calls] [payload size]\n", argv[0]);
+	}
+
+	return ExitCode;
+}
+
+/* in seconds */
+static double RpcBenchmark_GetTime(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return (double)Now.tv_sec + ((double)Now.tv_nsec / 1000000000.0);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
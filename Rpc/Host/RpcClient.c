@@ -0,0 +1,498 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "RpcClient.h"
+#include "CRC.h"
+#include "MiscFunctions.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* same framing as the target side, see Rpc.h */
+#define RPC_CLIENT_SLIP_END				(0xC0)
+
+#define RPC_CLIENT_SLIP_ESC				(0xDB)
+
+#define RPC_CLIENT_SLIP_ESC_END			(0xDC)
+
+#define RPC_CLIENT_SLIP_ESC_ESC			(0xDD)
+
+#define RPC_CLIENT_REQUEST_HEADER_SIZE	(2)
+
+#define RPC_CLIENT_RESPONSE_HEADER_SIZE	(3)
+
+#define RPC_CLIENT_CRC_SIZE				(2)
+
+#define RPC_CLIENT_ENCODED_SIZE_MAX		((RPC_FRAME_SIZE_MAX * 2) + 2)
+
+#define RPC_CLIENT_IN_FRAME_FLAG		(0)
+
+#define RPC_CLIENT_ESCAPE_FLAG			(1)
+
+#define RPC_CLIENT_DROP_FRAME_FLAG		(2)
+
+#define RPC_CLIENT_NO_PORT				(-1)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool RpcClient_BaudRateToSpeed(uint32_t BaudRate, speed_t * Speed);
+
+static rpc_client_status_t RpcClient_SendFrame(rpc_client_t * Client, uint8_t * Frame, uint16_t FrameSize);
+
+static rpc_client_status_t RpcClient_ReceiveFrame(rpc_client_t * Client, int64_t Deadline);
+
+static bool RpcClient_ReceiveByte(rpc_client_t * Client, uint8_t NewReceivedData);
+
+static void RpcClient_StoreByte(rpc_client_t * Client, uint8_t NewByte);
+
+static int64_t RpcClient_GetTime(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+rpc_client_status_t RpcClient_Open(rpc_client_t * Client, const char * Device, uint32_t BaudRate)
+{
+	rpc_client_status_t Status = RPC_CLIENT_WRONG_PARAMETER;
+	struct termios PortSettings;
+	speed_t Speed;
+
+	if((Client != NULL) && (Device != NULL) && RpcClient_BaudRateToSpeed(BaudRate, &Speed))
+	{
+		memset(Client, 0, sizeof(rpc_client_t));
+
+		Client->Timeout = RPC_CLIENT_TIMEOUT_DEFAULT;
+		Client->Retries = RPC_CLIENT_RETRIES_DEFAULT;
+
+		Client->Port = open(Device, O_RDWR | O_NOCTTY);
+
+		Status = RPC_CLIENT_PORT_ERROR;
+
+		if(Client->Port >= 0)
+		{
+			if(tcgetattr(Client->Port, &PortSettings) == 0)
+			{
+				/* raw 8N1, the shell echo and line endings are not ours to translate */
+				cfmakeraw(&PortSettings);
+				cfsetispeed(&PortSettings, Speed);
+				cfsetospeed(&PortSettings, Speed);
+
+				PortSettings.c_cflag |= (CLOCAL | CREAD);
+				PortSettings.c_cc[VMIN] = 0;
+				PortSettings.c_cc[VTIME] = 0;
+
+				if(tcsetattr(Client->Port, TCSANOW, &PortSettings) == 0)
+				{
+					tcflush(Client->Port, TCIOFLUSH);
+
+					Status = RPC_CLIENT_OK;
+				}
+			}
+
+			if(Status != RPC_CLIENT_OK)
+			{
+				RpcClient_Close(Client);
+			}
+		}
+	}
+
+	return Status;
+}
+
+void RpcClient_Close(rpc_client_t * Client)
+{
+	if(Client != NULL)
+	{
+		if(Client->Port >= 0)
+		{
+			close(Client->Port);
+		}
+
+		Client->Port = RPC_CLIENT_NO_PORT;
+	}
+}
+
+rpc_client_status_t RpcClient_Call(rpc_client_t * Client, uint8_t CommandId, const uint8_t * Request, uint16_t RequestSize, \
+		uint8_t * Response, uint16_t * ResponseSize, rpc_status_t * CommandStatus)
+{
+	rpc_client_status_t Status = RPC_CLIENT_WRONG_PARAMETER;
+	uint8_t Frame[RPC_FRAME_SIZE_MAX];
+	uint16_t FrameSize;
+	uint16_t DataSize;
+	uint8_t Attempt = 0;
+	bool isAnswered = false;
+	crc_t FrameCrc;
+
+	if((Client != NULL) && (Client->Port >= 0) && (RequestSize <= RPC_CLIENT_REQUEST_SIZE_MAX) && \
+			((Request != NULL) || (RequestSize == 0)) && (ResponseSize != NULL) && (CommandStatus != NULL) && \
+			((Response != NULL) || (*ResponseSize == 0)))
+	{
+		Frame[0] = Client->NextId++;
+		Frame[1] = CommandId;
+
+		if(RequestSize)
+		{
+			memcpy(&Frame[RPC_CLIENT_REQUEST_HEADER_SIZE], Request, RequestSize);
+		}
+
+		FrameSize = RPC_CLIENT_REQUEST_HEADER_SIZE + RequestSize;
+
+		FrameCrc = Crc_FastCalculation(&Frame[0], FrameSize);
+
+		Frame[FrameSize] = (uint8_t)(FrameCrc & 0xFF);
+		Frame[FrameSize + 1] = (uint8_t)(FrameCrc >> 8);
+
+		FrameSize += RPC_CLIENT_CRC_SIZE;
+
+		/* the same id is kept on retries, a late answer to a previous attempt is as good */
+		do
+		{
+			if(Attempt)
+			{
+				Client->Retransmissions++;
+			}
+
+			Status = RpcClient_SendFrame(Client, &Frame[0], FrameSize);
+
+			if(Status == RPC_CLIENT_OK)
+			{
+				Status = RpcClient_ReceiveFrame(Client, RpcClient_GetTime() + Client->Timeout);
+
+				while((Status == RPC_CLIENT_OK) && (isAnswered == false))
+				{
+					/* answers to calls already given up on are skipped */
+					if(Client->RxBuffer[0] == Frame[0])
+					{
+						isAnswered = true;
+					}
+					else
+					{
+						Status = RpcClient_ReceiveFrame(Client, RpcClient_GetTime() + Client->Timeout);
+					}
+				}
+			}
+
+			Attempt++;
+
+		}while((Status == RPC_CLIENT_TIMEOUT) && (Attempt <= Client->Retries));
+
+		if(isAnswered == true)
+		{
+			DataSize = Client->RxSize - RPC_CLIENT_RESPONSE_HEADER_SIZE - RPC_CLIENT_CRC_SIZE;
+
+			*CommandStatus = (rpc_status_t)Client->RxBuffer[2];
+
+			if(DataSize <= *ResponseSize)
+			{
+				if(DataSize)
+				{
+					memcpy(Response, &Client->RxBuffer[RPC_CLIENT_RESPONSE_HEADER_SIZE], DataSize);
+				}
+			}
+			else
+			{
+				Status = RPC_CLIENT_NO_MEMORY;
+			}
+
+			*ResponseSize = DataSize;
+		}
+	}
+
+	return Status;
+}
+
+static bool RpcClient_BaudRateToSpeed(uint32_t BaudRate, speed_t * Speed)
+{
+	bool isSupported = true;
+
+	switch(BaudRate)
+	{
+		case 9600:		*Speed = B9600;		break;
+		case 19200:		*Speed = B19200;	break;
+		case 38400:		*Speed = B38400;	break;
+		case 57600:		*Speed = B57600;	break;
+		case 115200:	*Speed = B115200;	break;
+		case 230400:	*Speed = B230400;	break;
+		case 460800:	*Speed = B460800;	break;
+		case 921600:	*Speed = B921600;	break;
+		default:		isSupported = false; break;
+	}
+
+	return isSupported;
+}
+
+static rpc_client_status_t RpcClient_SendFrame(rpc_client_t * Client, uint8_t * Frame, uint16_t FrameSize)
+{
+	rpc_client_status_t Status = RPC_CLIENT_OK;
+	uint8_t EncodedFrame[RPC_CLIENT_ENCODED_SIZE_MAX];
+	uint16_t EncodedSize = 0;
+	uint16_t FrameOffset;
+	uint16_t BytesSent = 0;
+	ssize_t BytesWritten;
+
+	EncodedFrame[EncodedSize++] = RPC_CLIENT_SLIP_END;
+
+	for(FrameOffset = 0; FrameOffset < FrameSize; FrameOffset++)
+	{
+		if(Frame[FrameOffset] == RPC_CLIENT_SLIP_END)
+		{
+			EncodedFrame[EncodedSize++] = RPC_CLIENT_SLIP_ESC;
+			EncodedFrame[EncodedSize++] = RPC_CLIENT_SLIP_ESC_END;
+		}
+		else if(Frame[FrameOffset] == RPC_CLIENT_SLIP_ESC)
+		{
+			EncodedFrame[EncodedSize++] = RPC_CLIENT_SLIP_ESC;
+			EncodedFrame[EncodedSize++] = RPC_CLIENT_SLIP_ESC_ESC;
+		}
+		else
+		{
+			EncodedFrame[EncodedSize++] = Frame[FrameOffset];
+		}
+	}
+
+	EncodedFrame[EncodedSize++] = RPC_CLIENT_SLIP_END;
+
+	while((BytesSent < EncodedSize) && (Status == RPC_CLIENT_OK))
+	{
+		BytesWritten = write(Client->Port, &EncodedFrame[BytesSent], EncodedSize - BytesSent);
+
+		if(BytesWritten > 0)
+		{
+			BytesSent += (uint16_t)BytesWritten;
+		}
+		else
+		{
+			Status = RPC_CLIENT_PORT_ERROR;
+		}
+	}
+
+	return Status;
+}
+
+static rpc_client_status_t RpcClient_ReceiveFrame(rpc_client_t * Client, int64_t Deadline)
+{
+	rpc_client_status_t Status = RPC_CLIENT_TIMEOUT;
+	struct pollfd PortEvents;
+	int64_t TimeLeft = 1;
+	ssize_t BytesRead;
+	crc_t ReceivedCrc;
+	uint16_t DataSize;
+
+	while((Status == RPC_CLIENT_TIMEOUT) && (TimeLeft > 0))
+	{
+		if(Client->ReadOffset < Client->ReadSize)
+		{
+			if(RpcClient_ReceiveByte(Client, Client->ReadBuffer[Client->ReadOffset++]))
+			{
+				/* target side answers with the status at least */
+				if(Client->RxSize >= (RPC_CLIENT_RESPONSE_HEADER_SIZE + RPC_CLIENT_CRC_SIZE))
+				{
+					DataSize = Client->RxSize - RPC_CLIENT_CRC_SIZE;
+
+					ReceivedCrc = (crc_t)(Client->RxBuffer[DataSize] | (Client->RxBuffer[DataSize + 1] << 8));
+
+					if(Crc_FastCalculation(&Client->RxBuffer[0], DataSize) == ReceivedCrc)
+					{
+						Status = RPC_CLIENT_OK;
+					}
+					else
+					{
+						Client->DroppedFrames++;
+					}
+				}
+				else
+				{
+					Client->DroppedFrames++;
+				}
+			}
+		}
+		else
+		{
+			TimeLeft = Deadline - RpcClient_GetTime();
+
+			if(TimeLeft > 0)
+			{
+				PortEvents.fd = Client->Port;
+				PortEvents.events = POLLIN;
+				PortEvents.revents = 0;
+
+				if(poll(&PortEvents, 1, (int)TimeLeft) > 0)
+				{
+					BytesRead = read(Client->Port, &Client->ReadBuffer[0], RPC_CLIENT_READ_BUFFER_SIZE);
+
+					if(BytesRead > 0)
+					{
+						Client->ReadOffset = 0;
+						Client->ReadSize = (uint16_t)BytesRead;
+					}
+					else if(BytesRead < 0)
+					{
+						Status = RPC_CLIENT_PORT_ERROR;
+					}
+				}
+			}
+		}
+	}
+
+	return Status;
+}
+
+static bool RpcClient_ReceiveByte(rpc_client_t * Client, uint8_t NewReceivedData)
+{
+	bool isFrameEnd = false;
+
+	if(NewReceivedData == RPC_CLIENT_SLIP_END)
+	{
+		if(!CHECK_FLAG(Client->ReceiveStatus,RPC_CLIENT_IN_FRAME_FLAG))
+		{
+			SET_FLAG(Client->ReceiveStatus,RPC_CLIENT_IN_FRAME_FLAG);
+			CLEAR_FLAG(Client->ReceiveStatus,RPC_CLIENT_ESCAPE_FLAG);
+			CLEAR_FLAG(Client->ReceiveStatus,RPC_CLIENT_DROP_FRAME_FLAG);
+
+			Client->RxSize = 0;
+		}
+		else if((Client->RxSize != 0) || (CHECK_FLAG(Client->ReceiveStatus,RPC_CLIENT_DROP_FRAME_FLAG)))
+		{
+			/* back to back END are skipped, an empty frame doesn't end anything */
+			CLEAR_FLAG(Client->ReceiveStatus,RPC_CLIENT_IN_FRAME_FLAG);
+
+			if(CHECK_FLAG(Client->ReceiveStatus,RPC_CLIENT_DROP_FRAME_FLAG))
+			{
+				Client->DroppedFrames++;
+			}
+			else
+			{
+				isFrameEnd = true;
+			}
+		}
+	}
+	else if(CHECK_FLAG(Client->ReceiveStatus,RPC_CLIENT_IN_FRAME_FLAG))
+	{
+		if(CHECK_FLAG(Client->ReceiveStatus,RPC_CLIENT_ESCAPE_FLAG))
+		{
+			CLEAR_FLAG(Client->ReceiveStatus,RPC_CLIENT_ESCAPE_FLAG);
+
+			if(NewReceivedData == RPC_CLIENT_SLIP_ESC_END)
+			{
+				RpcClient_StoreByte(Client, RPC_CLIENT_SLIP_END);
+			}
+			else if(NewReceivedData == RPC_CLIENT_SLIP_ESC_ESC)
+			{
+				RpcClient_StoreByte(Client, RPC_CLIENT_SLIP_ESC);
+			}
+			else
+			{
+				SET_FLAG(Client->ReceiveStatus,RPC_CLIENT_DROP_FRAME_FLAG);
+			}
+		}
+		else if(NewReceivedData == RPC_CLIENT_SLIP_ESC)
+		{
+			SET_FLAG(Client->ReceiveStatus,RPC_CLIENT_ESCAPE_FLAG);
+		}
+		else
+		{
+			RpcClient_StoreByte(Client, NewReceivedData);
+		}
+	}
+
+	/* anything else is shell text */
+	return isFrameEnd;
+}
+
+static void RpcClient_StoreByte(rpc_client_t * Client, uint8_t NewByte)
+{
+	if(!CHECK_FLAG(Client->ReceiveStatus,RPC_CLIENT_DROP_FRAME_FLAG))
+	{
+		if(Client->RxSize < RPC_FRAME_SIZE_MAX)
+		{
+			Client->RxBuffer[Client->RxSize] = NewByte;
+			Client->RxSize++;
+		}
+		else
+		{
+			SET_FLAG(Client->ReceiveStatus,RPC_CLIENT_DROP_FRAME_FLAG);
+		}
+	}
+}
+
+/* in ms, monotonic so a clock change doesn't fire the timeouts */
+static int64_t RpcClient_GetTime(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+
+	return ((int64_t)Now.tv_sec * 1000) + (Now.tv_nsec / 1000000);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
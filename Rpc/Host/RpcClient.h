@@ -0,0 +1,132 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+#ifndef _RPC_CLIENT_H_
+#define _RPC_CLIENT_H_
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Rpc.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Linux side of the Rpc channel, talks to the shell UART through a tty
+ * (e.g. /dev/ttyACM0). Shell text coming between frames is skipped.
+ * Build it with CRC/CRC.c and CRC_USE_HARDWARE defined to 0.
+ */
+
+/* largest request and response data, the rest of the frame is header and CRC */
+#define RPC_CLIENT_REQUEST_SIZE_MAX		(RPC_FRAME_SIZE_MAX - 2 - 2)
+
+#define RPC_CLIENT_RESPONSE_SIZE_MAX	(RPC_FRAME_SIZE_MAX - 3 - 2)
+
+#define RPC_CLIENT_TIMEOUT_DEFAULT		(100)
+
+#define RPC_CLIENT_RETRIES_DEFAULT		(3)
+
+#define RPC_CLIENT_READ_BUFFER_SIZE		(256)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+	RPC_CLIENT_OK = 0,
+	RPC_CLIENT_WRONG_PARAMETER,
+	RPC_CLIENT_PORT_ERROR,
+	RPC_CLIENT_TIMEOUT,
+	RPC_CLIENT_NO_MEMORY,
+}rpc_client_status_t;
+
+typedef struct
+{
+	int Port;
+	uint8_t NextId;
+	/* per attempt, in ms */
+	uint32_t Timeout;
+	uint8_t Retries;
+	uint16_t ReceiveStatus;
+	uint8_t RxBuffer[RPC_FRAME_SIZE_MAX];
+	uint16_t RxSize;
+	/* bytes read from the tty not decoded yet */
+	uint8_t ReadBuffer[RPC_CLIENT_READ_BUFFER_SIZE];
+	uint16_t ReadOffset;
+	uint16_t ReadSize;
+	uint32_t Retransmissions;
+	uint32_t DroppedFrames;
+}rpc_client_t;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                Function-like Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Extern Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Extern Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+rpc_client_status_t RpcClient_Open(rpc_client_t * Client, const char * Device, uint32_t BaudRate);
+
+void RpcClient_Close(rpc_client_t * Client);
+
+/* ResponseSize comes with the room available and returns the bytes received */
+rpc_client_status_t RpcClient_Call(rpc_client_t * Client, uint8_t CommandId, const uint8_t * Request, uint16_t RequestSize, \
+		uint8_t * Response, uint16_t * ResponseSize, rpc_status_t * CommandStatus);
+
+#if defined(__cplusplus)
+}
+#endif // __cplusplus
+
+
+#endif /* _RPC_CLIENT_H_ */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
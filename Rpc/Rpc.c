@@ -0,0 +1,358 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "Rpc.h"
+#include "Shell.h"
+#include "CRC.h"
+#include "MiscFunctions.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define RPC_SLIP_END				(0xC0)
+
+#define RPC_SLIP_ESC				(0xDB)
+
+#define RPC_SLIP_ESC_END			(0xDC)
+
+#define RPC_SLIP_ESC_ESC			(0xDD)
+
+#define RPC_REQUEST_HEADER_SIZE		(2)
+
+#define RPC_RESPONSE_HEADER_SIZE	(3)
+
+#define RPC_CRC_SIZE				(2)
+
+/* worst case every byte is escaped, plus both END */
+#define RPC_ENCODED_SIZE_MAX		((RPC_FRAME_SIZE_MAX * 2) + 2)
+
+#define RPC_IN_FRAME_FLAG			(0)
+
+#define RPC_ESCAPE_FLAG				(1)
+
+#define RPC_DROP_FRAME_FLAG			(2)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool Rpc_ReceiveCallback(uint8_t NewReceivedData);
+
+static void Rpc_StoreByte(uint8_t NewByte);
+
+static void Rpc_ProcessFrame(void);
+
+static void Rpc_SendFrame(uint16_t FrameSize);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const rpc_command_t * RpcCommands = NULL;
+
+static uint16_t RpcCommandsTotal = 0;
+
+/* only touched by the UART interrupt */
+static uint16_t RpcReceiveStatus = 0;
+
+static uint8_t RpcRxBuffer[RPC_FRAME_SIZE_MAX];
+
+static volatile uint16_t RpcRxSize = 0;
+
+/* set by the interrupt, cleared by the task once the frame is processed */
+static volatile bool isFrameReady = false;
+
+static volatile uint32_t RpcDroppedFrames = 0;
+
+static uint8_t RpcTxBuffer[RPC_FRAME_SIZE_MAX];
+
+static uint8_t RpcEncodedBuffer[RPC_ENCODED_SIZE_MAX];
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+rpc_status_t Rpc_Init(const rpc_command_t * CommandTable, uint16_t CommandTableSize)
+{
+	rpc_status_t Status = RPC_WRONG_PARAMETER;
+
+	if(CommandTable != NULL)
+	{
+		RpcCommands = CommandTable;
+
+		RpcCommandsTotal = CommandTableSize;
+
+		/* the shell UART is shared, frames are taken before they reach the shell */
+		Shell_SetBinaryHandler(Rpc_ReceiveCallback);
+
+		Status = RPC_OK;
+	}
+
+	return Status;
+}
+
+void Rpc_Task(void)
+{
+	if(isFrameReady == true)
+	{
+		Rpc_ProcessFrame();
+
+		isFrameReady = false;
+	}
+}
+
+uint32_t Rpc_GetDroppedFrames(void)
+{
+	return RpcDroppedFrames;
+}
+
+static void Rpc_ProcessFrame(void)
+{
+	crc_t FrameCrc;
+	crc_t ReceivedCrc;
+	uint16_t DataSize;
+	uint16_t ResponseSize;
+	uint16_t CommandOffset = 0;
+	rpc_status_t CommandStatus = RPC_UNKNOWN_COMMAND;
+
+	if(RpcRxSize >= (RPC_REQUEST_HEADER_SIZE + RPC_CRC_SIZE))
+	{
+		DataSize = RpcRxSize - RPC_CRC_SIZE;
+
+		FrameCrc = Crc_FastCalculation(&RpcRxBuffer[0], DataSize);
+
+		ReceivedCrc = (crc_t)(RpcRxBuffer[DataSize] | (RpcRxBuffer[DataSize + 1] << 8));
+
+		/* a corrupted frame can't be trusted, not even its id */
+		if(FrameCrc == ReceivedCrc)
+		{
+			RpcTxBuffer[0] = RpcRxBuffer[0];
+			RpcTxBuffer[1] = RpcRxBuffer[1];
+
+			ResponseSize = 0;
+
+			while(CommandOffset < RpcCommandsTotal)
+			{
+				if(RpcCommands[CommandOffset].CommandId == RpcRxBuffer[1])
+				{
+					ResponseSize = RPC_FRAME_SIZE_MAX - RPC_RESPONSE_HEADER_SIZE - RPC_CRC_SIZE;
+
+					CommandStatus = RpcCommands[CommandOffset].Handler(&RpcRxBuffer[RPC_REQUEST_HEADER_SIZE], \
+							DataSize - RPC_REQUEST_HEADER_SIZE, &RpcTxBuffer[RPC_RESPONSE_HEADER_SIZE], &ResponseSize);
+
+					break;
+				}
+
+				CommandOffset++;
+			}
+
+			/* nothing but the status goes back on errors */
+			if(CommandStatus != RPC_OK)
+			{
+				ResponseSize = 0;
+			}
+
+			RpcTxBuffer[2] = (uint8_t)CommandStatus;
+
+			Rpc_SendFrame(RPC_RESPONSE_HEADER_SIZE + ResponseSize);
+		}
+		else
+		{
+			RpcDroppedFrames++;
+		}
+	}
+	else
+	{
+		RpcDroppedFrames++;
+	}
+}
+
+static void Rpc_SendFrame(uint16_t FrameSize)
+{
+	crc_t FrameCrc;
+	uint16_t FrameOffset;
+	uint16_t EncodedSize = 0;
+
+	FrameCrc = Crc_FastCalculation(&RpcTxBuffer[0], FrameSize);
+
+	RpcTxBuffer[FrameSize] = (uint8_t)(FrameCrc & 0xFF);
+	RpcTxBuffer[FrameSize + 1] = (uint8_t)(FrameCrc >> 8);
+
+	FrameSize += RPC_CRC_SIZE;
+
+	RpcEncodedBuffer[EncodedSize++] = RPC_SLIP_END;
+
+	for(FrameOffset = 0; FrameOffset < FrameSize; FrameOffset++)
+	{
+		if(RpcTxBuffer[FrameOffset] == RPC_SLIP_END)
+		{
+			RpcEncodedBuffer[EncodedSize++] = RPC_SLIP_ESC;
+			RpcEncodedBuffer[EncodedSize++] = RPC_SLIP_ESC_END;
+		}
+		else if(RpcTxBuffer[FrameOffset] == RPC_SLIP_ESC)
+		{
+			RpcEncodedBuffer[EncodedSize++] = RPC_SLIP_ESC;
+			RpcEncodedBuffer[EncodedSize++] = RPC_SLIP_ESC_ESC;
+		}
+		else
+		{
+			RpcEncodedBuffer[EncodedSize++] = RpcTxBuffer[FrameOffset];
+		}
+	}
+
+	RpcEncodedBuffer[EncodedSize++] = RPC_SLIP_END;
+
+	/* same TX ring as the shell text, the frame goes whole or is dropped (never cut) */
+	if(!Shell_WriteFrame(&RpcEncodedBuffer[0], EncodedSize))
+	{
+		RpcDroppedFrames++;
+	}
+}
+
+static bool Rpc_ReceiveCallback(uint8_t NewReceivedData)
+{
+	bool isRpcData = true;
+
+	if(NewReceivedData == RPC_SLIP_END)
+	{
+		if(!CHECK_FLAG(RpcReceiveStatus,RPC_IN_FRAME_FLAG))
+		{
+			/* start of frame, dropped if the previous one is still being processed */
+			SET_FLAG(RpcReceiveStatus,RPC_IN_FRAME_FLAG);
+			CLEAR_FLAG(RpcReceiveStatus,RPC_ESCAPE_FLAG);
+			CLEAR_FLAG(RpcReceiveStatus,RPC_DROP_FRAME_FLAG);
+
+			if(isFrameReady == true)
+			{
+				SET_FLAG(RpcReceiveStatus,RPC_DROP_FRAME_FLAG);
+			}
+			else
+			{
+				RpcRxSize = 0;
+			}
+		}
+		else if((RpcRxSize != 0) || (CHECK_FLAG(RpcReceiveStatus,RPC_DROP_FRAME_FLAG)))
+		{
+			/* back to back END are skipped, an empty frame doesn't end anything */
+			CLEAR_FLAG(RpcReceiveStatus,RPC_IN_FRAME_FLAG);
+
+			if(CHECK_FLAG(RpcReceiveStatus,RPC_DROP_FRAME_FLAG))
+			{
+				RpcDroppedFrames++;
+			}
+			else
+			{
+				isFrameReady = true;
+			}
+		}
+	}
+	else if(CHECK_FLAG(RpcReceiveStatus,RPC_IN_FRAME_FLAG))
+	{
+		if(CHECK_FLAG(RpcReceiveStatus,RPC_ESCAPE_FLAG))
+		{
+			CLEAR_FLAG(RpcReceiveStatus,RPC_ESCAPE_FLAG);
+
+			if(NewReceivedData == RPC_SLIP_ESC_END)
+			{
+				Rpc_StoreByte(RPC_SLIP_END);
+			}
+			else if(NewReceivedData == RPC_SLIP_ESC_ESC)
+			{
+				Rpc_StoreByte(RPC_SLIP_ESC);
+			}
+			else
+			{
+				SET_FLAG(RpcReceiveStatus,RPC_DROP_FRAME_FLAG);
+			}
+		}
+		else if(NewReceivedData == RPC_SLIP_ESC)
+		{
+			SET_FLAG(RpcReceiveStatus,RPC_ESCAPE_FLAG);
+		}
+		else
+		{
+			Rpc_StoreByte(NewReceivedData);
+		}
+	}
+	else
+	{
+		/* not in a frame, belongs to the shell */
+		isRpcData = false;
+	}
+
+	return isRpcData;
+}
+
+static void Rpc_StoreByte(uint8_t NewByte)
+{
+	if(!CHECK_FLAG(RpcReceiveStatus,RPC_DROP_FRAME_FLAG))
+	{
+		if(RpcRxSize < RPC_FRAME_SIZE_MAX)
+		{
+			RpcRxBuffer[RpcRxSize] = NewByte;
+			RpcRxSize++;
+		}
+		else
+		{
+			SET_FLAG(RpcReceiveStatus,RPC_DROP_FRAME_FLAG);
+		}
+	}
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
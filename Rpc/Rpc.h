@@ -0,0 +1,118 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+#ifndef _RPC_H_
+#define _RPC_H_
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Binary channel sharing the shell UART. Frames are SLIP encoded (RFC 1055),
+ * the shell never sees them since text never has the SLIP END byte.
+ *
+ * request:  END | id | command | data ...          | crc16 (LSB first) | END
+ * response: END | id | command | status | data ... | crc16 (LSB first) | END
+ *
+ * crc16 is Crc_FastCalculation over everything before it. Frames with a
+ * wrong CRC are dropped without response, the host retries on timeout.
+ * Responses are queued whole: with a non blocking shell TX policy a response
+ * that doesn't fit the TX ring is dropped and counted like a bad frame.
+ *
+ * Host/ has the Linux client and a round trip throughput benchmark.
+ */
+
+/* largest frame once decoded, CRC included */
+#define RPC_FRAME_SIZE_MAX		(128)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum
+{
+	RPC_OK = 0,
+	RPC_WRONG_PARAMETER,
+	RPC_UNKNOWN_COMMAND,
+	RPC_HANDLER_ERROR,
+}rpc_status_t;
+
+/* ResponseSize comes with the room available and returns the bytes written */
+typedef rpc_status_t (* rpc_handler_t)(uint8_t * Request, uint16_t RequestSize, uint8_t * Response, uint16_t * ResponseSize);
+
+typedef struct
+{
+	uint8_t CommandId;
+	rpc_handler_t Handler;
+}rpc_command_t;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                Function-like Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Extern Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Extern Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // __cplusplus
+
+rpc_status_t Rpc_Init(const rpc_command_t * CommandTable, uint16_t CommandTableSize);
+
+void Rpc_Task(void);
+
+uint32_t Rpc_GetDroppedFrames(void);
+
+#if defined(__cplusplus)
+}
+#endif // __cplusplus
+
+
+#endif /* _RPC_H_ */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -162,6 +162,12 @@ static uint8_t isPlatformTimerEnabled = 0;
 /* Amount of timers allocated */
 static uint16_t SWTimer_Allocated = 0;
 
+/* Base time ticks, only updated by the HW timer interrupt */
+volatile static uint32_t SWTimer_TickCount = 0;
+
+/* Ticks that found the previous one still pending */
+volatile static uint32_t SWTimer_MissedTicks = 0;
+
 #ifndef FSL_RTOS_FREE_RTOS
 /* Flag to signalize a timer ISR */
 volatile static  uint8_t SWTimer_TimerIsrFlag = 0;
@@ -427,6 +433,49 @@ void SWTimer_StartTimers (void)
 {
 	SWTimer_PlatformTimerStart();
 }
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : SWTimer_GetTickCount
+ * Description   : Returns the base time ticks since init
+ *
+ *END**************************************************************************/
+uint32_t SWTimer_GetTickCount(void)
+{
+	return (SWTimer_TickCount);
+}
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : SWTimer_GetTimeLeft
+ * Description   : Returns the milliseconds left on the selected timer
+ *
+ *END**************************************************************************/
+uint32_t SWTimer_GetTimeLeft(swtimer_t TimerToQuery)
+{
+	uint32_t TimeLeft = 0;
+
+	if(SWTIMER_MAX_TIMERS > TimerToQuery)
+	{
+		TimeLeft = SWTimers_gCounters[TimerToQuery].Counter * SWTIMER_BASE_TIME;
+	}
+
+	return (TimeLeft);
+}
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : SWTimer_GetStatistics
+ * Description   : Copies the SW timer service counters
+ *
+ *END**************************************************************************/
+void SWTimer_GetStatistics(swtimer_statistics_t * Statistics)
+{
+	if(Statistics != NULL)
+	{
+		Statistics->Allocated = SWTimer_Allocated;
+		Statistics->Enabled = SWTimer_gTimersEnabled;
+		Statistics->Ticks = SWTimer_TickCount;
+		Statistics->MissedTicks = SWTimer_MissedTicks;
+	}
+}
 /*FUNCTION**********************************************************************
  *
  * Function Name : AudioApp_SWTimerTask
@@ -488,12 +537,26 @@ void TPM0_IRQHandler(void)
 	/* Clear interrupt flag.*/
 	TPM_ClearStatusFlags(TIMER_INSTANCE, kTPM_TimeOverflowFlag);
 
+	SWTimer_TickCount++;
+
 	#ifdef FSL_RTOS_FREE_RTOS
 	if(SWTimer_Event != NULL)
 	{
+		/* the task didn't get to the previous tick, the timers are late */
+		if(xEventGroupGetBitsFromISR(SWTimer_Event) & SWTIMERS_TIMER_EVENT)
+		{
+			SWTimer_MissedTicks++;
+		}
+
 		xEventGroupSetBitsFromISR(SWTimer_Event, SWTIMERS_TIMER_EVENT, &xHigherPriorityTaskWoken);
 	}
 	#else
+	/* the super loop didn't get to the previous tick, the timers are late */
+	if(SWTimer_TimerIsrFlag)
+	{
+		SWTimer_MissedTicks++;
+	}
+
 	SWTimer_TimerIsrFlag = 1;
 	#endif
 }
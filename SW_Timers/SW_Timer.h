@@ -58,6 +58,17 @@ typedef enum
 	SWTIMER_ENABLED = 0,
 	SWTIMER_DISABLED,
 }swtimerstatus_t;
+
+/*!
+ * @brief Counters kept by the SW timer service, used for diagnostics.
+ */
+typedef struct
+{
+	uint16_t Allocated;		/**< One bit per allocated timer */
+	uint16_t Enabled;		/**< One bit per running timer */
+	uint32_t Ticks;			/**< Base time ticks since init */
+	uint32_t MissedTicks;	/**< Ticks that arrived before the previous one was serviced */
+}swtimer_statistics_t;
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                Function-like Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -176,6 +187,38 @@ void SWTimer_StopTimers (void);
 */
 void SWTimer_StartTimers (void);
 
+/*!
+ *	@brief	Returns the amount of base time ticks since init
+ *
+ *	@param	void
+ *
+ * 	@return	uint32_t		Ticks of SWTIMER_BASE_TIME milliseconds
+ *
+ * 	@note The count only moves while at least one timer is enabled
+ *
+*/
+uint32_t SWTimer_GetTickCount(void);
+
+/*!
+ *	@brief	Returns the milliseconds left before the selected timer expires
+ *
+ *	@param	TimerToQuery			[in]	Timer to query
+ *
+ * 	@return	uint32_t				Time left in milliseconds
+ *
+*/
+uint32_t SWTimer_GetTimeLeft(swtimer_t TimerToQuery);
+
+/*!
+ *	@brief	Copies the SW timer service counters
+ *
+ *	@param	Statistics			[out]	Where the counters are copied
+ *
+ * 	@return	void
+ *
+*/
+void SWTimer_GetStatistics(swtimer_statistics_t * Statistics);
+
 /*! @} End of Software Timers */
 /*! @} End of Service Layer */
 #if defined(__cplusplus)
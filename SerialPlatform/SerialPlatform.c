@@ -84,6 +84,8 @@ static uint8_t DataReceived;
 static volatile uint16_t SerialPlatformStatus = 0;
 
 static serialplatformcallback_t ReportDataCallback = NULL;
+
+static serialplatformtxcallback_t ReportTxDoneCallback = NULL;
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                   Static Variables Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -148,6 +150,11 @@ void SerialPlatform_SendBlocking(uint8_t * CommandBuffer, uint16_t BufferSize)
 	}
 }
 
+void SerialPlatform_SetTxCallback(serialplatformtxcallback_t Callback)
+{
+	ReportTxDoneCallback = Callback;
+}
+
 uint8_t SerialPlatform_Read (void)
 {
 	CLEAR_FLAG(SerialPlatformStatus,SERIAL_PLATFORM_RX_DONE_FLAG);
@@ -194,6 +201,12 @@ void SerialPlatform_Callback(LPUART_Type *base, lpuart_handle_t *handle, status_
 	if(kStatus_LPUART_TxIdle == status)
 	{
 		SET_FLAG(SerialPlatformStatus,SERIAL_PLATFORM_TX_DONE_FLAG);
+
+		/* called from the interrupt, a new transfer can be started from here */
+		if(ReportTxDoneCallback != NULL)
+		{
+			ReportTxDoneCallback();
+		}
 	}
 }
 
@@ -55,6 +55,8 @@ typedef enum
 
 typedef void (*serialplatformcallback_t)(uint8_t);
 
+typedef void (*serialplatformtxcallback_t)(void);
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                Function-like Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -81,6 +83,8 @@ void SerialPlatform_SendNonBlocking(uint8_t * CommandBuffer, uint16_t BufferSize
 
 void SerialPlatform_SendBlocking(uint8_t * CommandBuffer, uint16_t BufferSize);
 
+void SerialPlatform_SetTxCallback(serialplatformtxcallback_t Callback);
+
 serialplatformstatus_t SerialPlatform_RxStatus(uint8_t * NewData);
 
 uint8_t SerialPlatform_Read(void);
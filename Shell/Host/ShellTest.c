@@ -0,0 +1,386 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+/*
+ * Host test of the shell receive path: about 100 KB of scripted command lines
+ * arrive back to back at SHELL_BAUDRATE while the main loop calls Shell_Task
+ * every poll period. Every line has to run once, in order and with the same
+ * arguments, and no byte may be dropped by the receive ring. The UART is
+ * simulated on virtual time, a transfer completes a byte time per byte later.
+ *
+ * The echo goes out at the same rate the script comes in, plus the prompts,
+ * so the transmit side can't keep up with a continuous paste. The blocking
+ * policy would spin on a UART only an interrupt can drain, the test is built
+ * with one of the non blocking policies instead.
+ *
+ * usage: ShellTest [poll period us]
+ *
+ * gcc -O2 -Wall -DSHELL_TX_FULL_POLICY=SHELL_TX_POLICY_DROP -I.. -I../../SerialPlatform \
+ *     -I../../MiscFunctions ShellTest.c ../Shell.c ../../MiscFunctions/MiscFunctions.c \
+ *     -o ShellTest
+ */
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Shell.h"
+#include "SerialPlatform.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if (SHELL_TX_FULL_POLICY == SHELL_TX_POLICY_BLOCK)
+#error "build with -DSHELL_TX_FULL_POLICY=SHELL_TX_POLICY_DROP or SHELL_TX_POLICY_TRUNCATE"
+#endif
+
+/* start, 8 data and stop bits */
+#define SHELL_TEST_BYTE_TIME			((10ULL * 1000000000ULL) / SHELL_BAUDRATE)
+
+#define SHELL_TEST_POLL_PERIOD_DEFAULT	(1000)
+
+#define SHELL_TEST_SCRIPT_SIZE			(100 * 1024)
+
+#define SHELL_TEST_LINES_MAX			(SHELL_TEST_SCRIPT_SIZE / 4)
+
+/* longest line the script builds, well under SHELL_COMMAND_SIZE_MAX */
+#define SHELL_TEST_LINE_SIZE_MAX		(48)
+
+#define SHELL_TEST_CHECK(Condition, Name)	ShellTest_Check((Condition), (Name), __LINE__)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void ShellTest_Check(bool isPassed, const char * Name, int Line);
+
+static void ShellTest_BuildScript(void);
+
+static shell_command_status_t ShellTest_Set(uint8_t ** Arguments, uint8_t ArgumentsCount);
+
+static shell_command_status_t ShellTest_Add(uint8_t ** Arguments, uint8_t ArgumentsCount);
+
+static shell_command_status_t ShellTest_Name(uint8_t ** Arguments, uint8_t ArgumentsCount);
+
+static shell_command_status_t ShellTest_Nop(uint8_t ** Arguments, uint8_t ArgumentsCount);
+
+static void ShellTest_Executed(const char * Command, uint8_t ** Arguments, uint8_t ArgumentsCount);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const char * const ShellTestNames[] =
+{
+	"led", "motor", "pump", "valve", "heater", "fan", "sensor_left", "sensor_right"
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t ShellTestFailures = 0;
+
+static uint32_t ShellTestChecks = 0;
+
+static shell_command_t ShellTestCommands[] =
+{
+	{"set", 2, ShellTest_Set},
+	{"add", 3, ShellTest_Add},
+	{"name", 1, ShellTest_Name},
+	{"nop", 0, ShellTest_Nop},
+};
+
+static char ShellTestScript[SHELL_TEST_SCRIPT_SIZE + SHELL_TEST_LINE_SIZE_MAX];
+
+static uint32_t ShellTestScriptSize = 0;
+
+/* each line without the line ending, as the command handler should see it */
+static char ShellTestLines[SHELL_TEST_LINES_MAX][SHELL_TEST_LINE_SIZE_MAX];
+
+static uint32_t ShellTestLinesTotal = 0;
+
+static uint32_t ShellTestLinesExecuted = 0;
+
+static uint32_t ShellTestLinesMismatched = 0;
+
+static uint64_t ShellTestTime = 0;
+
+static serialplatformcallback_t ShellTestRxCallback = NULL;
+
+static serialplatformtxcallback_t ShellTestTxCallback = NULL;
+
+static uint16_t ShellTestTxChunkSize = 0;
+
+static uint64_t ShellTestTxDoneTime = 0;
+
+static uint32_t ShellTestTxBytes = 0;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char ** argv)
+{
+	uint64_t PollPeriod = SHELL_TEST_POLL_PERIOD_DEFAULT;
+	uint64_t NextPollTime;
+	uint64_t NextRxTime;
+	uint32_t ScriptOffset = 0;
+	uint16_t ChunkSize;
+
+	if(argc > 1)
+	{
+		PollPeriod = strtoull(argv[1], NULL, 10);
+	}
+
+	/* the loop works in nanoseconds */
+	PollPeriod *= 1000ULL;
+
+	ShellTest_BuildScript();
+
+	Shell_Init(&ShellTestCommands[0], sizeof(ShellTestCommands) / sizeof(ShellTestCommands[0]), "> ");
+
+	NextPollTime = PollPeriod;
+	NextRxTime = SHELL_TEST_BYTE_TIME;
+
+	/* the earliest of the next received byte, transfer done and poll runs first */
+	while((ScriptOffset < ShellTestScriptSize) || (ShellTestTime < (NextRxTime + PollPeriod)))
+	{
+		if((ShellTestTxChunkSize != 0) && (ShellTestTxDoneTime <= NextPollTime) && \
+				((ShellTestTxDoneTime <= NextRxTime) || (ScriptOffset >= ShellTestScriptSize)))
+		{
+			ShellTestTime = ShellTestTxDoneTime;
+
+			/* the shell may start the next chunk from the callback */
+			ChunkSize = ShellTestTxChunkSize;
+			ShellTestTxChunkSize = 0;
+			ShellTestTxBytes += ChunkSize;
+
+			ShellTestTxCallback();
+		}
+		else if((ScriptOffset < ShellTestScriptSize) && (NextRxTime <= NextPollTime))
+		{
+			ShellTestTime = NextRxTime;
+
+			ShellTestRxCallback((uint8_t)ShellTestScript[ScriptOffset]);
+
+			ScriptOffset++;
+			NextRxTime += SHELL_TEST_BYTE_TIME;
+		}
+		else
+		{
+			ShellTestTime = NextPollTime;
+
+			Shell_Task();
+
+			NextPollTime += PollPeriod;
+		}
+	}
+
+	SHELL_TEST_CHECK(Shell_GetRxOverrunBytes() == 0, "no receive overrun");
+	SHELL_TEST_CHECK(ShellTestLinesExecuted == ShellTestLinesTotal, "every line executed");
+	SHELL_TEST_CHECK(ShellTestLinesMismatched == 0, "same command and arguments");
+
+	printf("%u bytes, %u lines in %.1f ms, poll every %.3f ms\n", ShellTestScriptSize, ShellTestLinesTotal, \
+			(double)ShellTestTime / 1000000.0, (double)PollPeriod / 1000000.0);
+	printf("executed %u, mismatched %u, rx overrun %u, rx high water %u of %u\n", ShellTestLinesExecuted, \
+			ShellTestLinesMismatched, Shell_GetRxOverrunBytes(), Shell_GetRxHighWaterMark(), SHELL_RX_BUFFER_SIZE - 1);
+	printf("tx sent %u, dropped %u\n", ShellTestTxBytes, Shell_GetDroppedBytes());
+	printf("%u checks, %u failures\n", ShellTestChecks, ShellTestFailures);
+
+	return (ShellTestFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void SerialPlatform_Init(uint32_t BaudRate, serialplatformcallback_t Callback)
+{
+	(void)BaudRate;
+
+	ShellTestRxCallback = Callback;
+}
+
+void SerialPlatform_SetTxCallback(serialplatformtxcallback_t Callback)
+{
+	ShellTestTxCallback = Callback;
+}
+
+void SerialPlatform_SendNonBlocking(uint8_t * CommandBuffer, uint16_t BufferSize)
+{
+	(void)CommandBuffer;
+
+	/* the shell never starts a transfer while one is on going */
+	SHELL_TEST_CHECK(ShellTestTxChunkSize == 0, "one transfer at a time");
+
+	ShellTestTxChunkSize = BufferSize;
+	ShellTestTxDoneTime = ShellTestTime + (BufferSize * SHELL_TEST_BYTE_TIME);
+}
+
+void SerialPlatform_SendBlocking(uint8_t * CommandBuffer, uint16_t BufferSize)
+{
+	(void)CommandBuffer;
+
+	ShellTestTxBytes += BufferSize;
+	ShellTestTime += (BufferSize * SHELL_TEST_BYTE_TIME);
+}
+
+static void ShellTest_BuildScript(void)
+{
+	char * Line;
+	uint32_t LineSize;
+
+	srand(1);
+
+	/* whole lines only, the last one may go a little over the script size */
+	while((ShellTestScriptSize < SHELL_TEST_SCRIPT_SIZE) && (ShellTestLinesTotal < SHELL_TEST_LINES_MAX))
+	{
+		Line = &ShellTestLines[ShellTestLinesTotal][0];
+
+		switch(rand() % 4)
+		{
+			case 0:
+				LineSize = (uint32_t)snprintf(Line, SHELL_TEST_LINE_SIZE_MAX, "set %s %d", \
+						ShellTestNames[rand() % 8], rand() % 100000);
+				break;
+			case 1:
+				LineSize = (uint32_t)snprintf(Line, SHELL_TEST_LINE_SIZE_MAX, "add %d %d %d", \
+						rand() % 1000, rand() % 1000000, rand() % 10);
+				break;
+			case 2:
+				LineSize = (uint32_t)snprintf(Line, SHELL_TEST_LINE_SIZE_MAX, "name %s", ShellTestNames[rand() % 8]);
+				break;
+			default:
+				LineSize = (uint32_t)snprintf(Line, SHELL_TEST_LINE_SIZE_MAX, "nop");
+				break;
+		}
+
+		memcpy(&ShellTestScript[ShellTestScriptSize], Line, LineSize);
+		ShellTestScriptSize += LineSize;
+
+		ShellTestScript[ShellTestScriptSize++] = '\r';
+		ShellTestScript[ShellTestScriptSize++] = '\n';
+
+		ShellTestLinesTotal++;
+	}
+}
+
+static shell_command_status_t ShellTest_Set(uint8_t ** Arguments, uint8_t ArgumentsCount)
+{
+	ShellTest_Executed("set", Arguments, ArgumentsCount);
+
+	return SHELL_COMMAND_DONE;
+}
+
+static shell_command_status_t ShellTest_Add(uint8_t ** Arguments, uint8_t ArgumentsCount)
+{
+	ShellTest_Executed("add", Arguments, ArgumentsCount);
+
+	return SHELL_COMMAND_DONE;
+}
+
+static shell_command_status_t ShellTest_Name(uint8_t ** Arguments, uint8_t ArgumentsCount)
+{
+	ShellTest_Executed("name", Arguments, ArgumentsCount);
+
+	return SHELL_COMMAND_DONE;
+}
+
+static shell_command_status_t ShellTest_Nop(uint8_t ** Arguments, uint8_t ArgumentsCount)
+{
+	ShellTest_Executed("nop", Arguments, ArgumentsCount);
+
+	return SHELL_COMMAND_DONE;
+}
+
+static void ShellTest_Executed(const char * Command, uint8_t ** Arguments, uint8_t ArgumentsCount)
+{
+	char Line[SHELL_COMMAND_SIZE_MAX * 2];
+	uint32_t LineSize;
+	uint8_t ArgumentIndex;
+
+	/* put the line back together and compare it with the one sent */
+	LineSize = (uint32_t)snprintf(Line, sizeof(Line), "%s", Command);
+
+	for(ArgumentIndex = 0; ArgumentIndex < ArgumentsCount; ArgumentIndex++)
+	{
+		LineSize += (uint32_t)snprintf(&Line[LineSize], sizeof(Line) - LineSize, " %s", (char *)Arguments[ArgumentIndex]);
+	}
+
+	if((ShellTestLinesExecuted >= ShellTestLinesTotal) || \
+			(strcmp(Line, &ShellTestLines[ShellTestLinesExecuted][0]) != 0))
+	{
+		if(ShellTestLinesMismatched < 10)
+		{
+			printf("line %u: got \"%s\"\n", ShellTestLinesExecuted, Line);
+		}
+
+		ShellTestLinesMismatched++;
+	}
+
+	ShellTestLinesExecuted++;
+}
+
+static void ShellTest_Check(bool isPassed, const char * Name, int Line)
+{
+	ShellTestChecks++;
+
+	if(isPassed == false)
+	{
+		if(ShellTestFailures < 10)
+		{
+			printf("line %d: %s failed\n", Line, Name);
+		}
+
+		ShellTestFailures++;
+	}
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////
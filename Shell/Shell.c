@@ -35,6 +35,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #include <stdint.h>
 #include <string.h>
+#include <stdbool.h>
 #include "Shell.h"
 #include "SerialPlatform.h"
 #include "MiscFunctions.h"
@@ -42,10 +43,18 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //                                   Defines & Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-#define SHELL_CHARACTER_RECEIVED_FLAG	(0)
-
 #define SHELL_COMMAND_PENDING_FLAG		(1)
 
+#define SHELL_BATCH_RECEIVING_FLAG		(2)
+
+#define SHELL_BATCH_RUNNING_FLAG		(3)
+
+#define SHELL_BATCH_OVERFLOW_FLAG		(4)
+
+#define SHELL_BATCH_START_LINE			("#batch")
+
+#define SHELL_BATCH_END_LINE			("#end")
+
 #define SHELL_CLEAR_SCREEN				(Shell_WriteString("\033[2J\033[H"))
 
 #define SHELL_PROMPT					(Shell_WriteString(ShellPrompt))
@@ -54,10 +63,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define SHELL_NEW_LINE					(Shell_WriteString("\n\r"))
 
+#define SHELL_TX_TRUNCATE_MARKER		("~\n\r")
+
+#define SHELL_TX_TRUNCATE_MARKER_SIZE	(sizeof(SHELL_TX_TRUNCATE_MARKER) - 1)
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                       Typedef Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+typedef enum
+{
+	SHELL_RESULT_DONE = 0,
+	SHELL_RESULT_ASYNCH,
+	SHELL_RESULT_NOT_FOUND,
+	SHELL_RESULT_TOO_MANY_ARGS,
+	SHELL_RESULT_WRONG_QUOTES
+}shell_result_t;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                  Function Prototypes Section
@@ -65,6 +86,38 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 static void Shell_ReceiveCallback (uint8_t NewReceivedData);
 
+static void Shell_ProcessCharacter(uint8_t NewCharacter);
+
+static shell_result_t Shell_ExecuteCommand(void);
+
+static shell_result_t Shell_SplitArguments(uint8_t CommandSize, uint8_t * ArgsCounter);
+
+static bool Shell_IsLine(const char * LineToCompare);
+
+static void Shell_BatchStoreLine(void);
+
+static void Shell_BatchTask(void);
+
+static void Shell_BatchReport(shell_result_t CommandResult);
+
+static uint32_t Shell_GetTime(void);
+
+static shell_status_t Shell_PrepareCommands(shell_command_t * CommandTable, uint16_t CommandTableSize);
+
+static shell_command_t * Shell_FindCommand(uint8_t * CommandName, uint8_t CommandNameSize);
+
+static void Shell_TxWrite(uint8_t * DataToWrite, uint16_t DataSize);
+
+static void Shell_TxCopy(uint8_t * DataToWrite, uint16_t DataSize);
+
+static uint16_t Shell_TxSpaceAvailable(void);
+
+static void Shell_TxStart(void);
+
+static void Shell_TxSendChunk(void);
+
+static void Shell_TxDoneCallback(void);
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                   Global Constants Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -86,22 +139,61 @@ static void Shell_ReceiveCallback (uint8_t NewReceivedData);
 
 static volatile uint16_t ShellStatus = 0;
 
-static volatile uint8_t NewCharacterRecevied;
+static uint8_t ShellRxBuffer[SHELL_RX_BUFFER_SIZE];
+
+/* write offset is only moved by the UART interrupt, read offset only by the task */
+static volatile uint16_t ShellRxWriteOffset = 0;
+
+static volatile uint16_t ShellRxReadOffset = 0;
 
-static shell_command_t * ApplicationCommands;
+static volatile uint32_t ShellRxOverrunBytes = 0;
 
-static uint8_t ApplicationCommandsTotal;
+static volatile uint16_t ShellRxHighWaterMark = 0;
+
+/* application table first, then the ones added with Shell_AddCommands */
+static shell_command_t * CommandTables[SHELL_COMMAND_TABLES_MAX];
+
+static uint16_t CommandTablesSize[SHELL_COMMAND_TABLES_MAX];
+
+static uint8_t CommandTablesTotal = 0;
 
 static uint8_t ShellCommandBuffer[SHELL_COMMAND_SIZE_MAX];
 
 static uint8_t ShellCommandCurrentOffset;
 
-static uint8_t ShellArgs[SHELL_COMMAND_ARGS_MAX][SHELL_COMMAND_ARGS_SIZE_MAX];
-
 static uint8_t * ShellArgsList[SHELL_COMMAND_ARGS_MAX];
 
 static char * ShellPrompt;
 
+static shell_time_t ShellTimeSource = NULL;
+
+static shell_binary_handler_t ShellBinaryHandler = NULL;
+
+static uint8_t ShellBatchBuffer[SHELL_BATCH_BUFFER_SIZE];
+
+static uint16_t ShellBatchWriteOffset = 0;
+
+static uint16_t ShellBatchReadOffset = 0;
+
+static uint16_t ShellBatchCommandIndex = 0;
+
+static uint32_t ShellBatchStartTime = 0;
+
+static uint8_t ShellTxBuffer[SHELL_TX_BUFFER_SIZE];
+
+/* write offset is only moved by the task, read offset only by the UART interrupt */
+static volatile uint16_t ShellTxWriteOffset = 0;
+
+static volatile uint16_t ShellTxReadOffset = 0;
+
+static volatile uint16_t ShellTxChunkSize = 0;
+
+static volatile bool isTxInProgress = false;
+
+static volatile uint32_t ShellTxDroppedBytes = 0;
+
+static uint16_t ShellTxHighWaterMark = 0;
+
 const char ShellWelcome[] =
 {
 		"\n\r"
@@ -114,19 +206,22 @@ const char ShellWelcome[] =
 //                                      Functions Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-shell_status_t Shell_Init(shell_command_t * CommandTable, uint8_t CommandTableSize, char * Prompt)
+shell_status_t Shell_Init(shell_command_t * CommandTable, uint16_t CommandTableSize, char * Prompt)
 {
 	shell_status_t Status = SHELL_WRONG_PARAMETER;
 
 	if(CommandTable != NULL)
 	{
-		if(CommandTableSize < SHELL_COMMANDS_MAX)
+		/* table is sorted in place, lookups are done with a binary search */
+		if(SHELL_OK == Shell_PrepareCommands(CommandTable, CommandTableSize))
 		{
 			if(Prompt != NULL)
 			{
-				ApplicationCommands = CommandTable;
+				CommandTables[0] = CommandTable;
+
+				CommandTablesSize[0] = CommandTableSize;
 
-				ApplicationCommandsTotal = CommandTableSize;
+				CommandTablesTotal = 1;
 
 				ShellPrompt = Prompt;
 
@@ -136,6 +231,8 @@ shell_status_t Shell_Init(shell_command_t * CommandTable, uint8_t CommandTableSi
 
 				SerialPlatform_Init(SHELL_BAUDRATE,Shell_ReceiveCallback);
 
+				SerialPlatform_SetTxCallback(Shell_TxDoneCallback);
+
 				SHELL_CLEAR_SCREEN;
 
 				Shell_WriteString((char*)&ShellWelcome[0]);
@@ -154,6 +251,40 @@ shell_status_t Shell_Init(shell_command_t * CommandTable, uint8_t CommandTableSi
 	return Status;
 }
 
+shell_status_t Shell_AddCommands(shell_command_t * CommandTable, uint16_t CommandTableSize)
+{
+	shell_status_t Status = SHELL_WRONG_PARAMETER;
+	uint16_t CommandOffset;
+
+	if((CommandTable != NULL) && (CommandTablesTotal > 0) && (CommandTablesTotal < SHELL_COMMAND_TABLES_MAX))
+	{
+		if(SHELL_OK == Shell_PrepareCommands(CommandTable, CommandTableSize))
+		{
+			Status = SHELL_OK;
+
+			/* names must be unique across all tables */
+			for(CommandOffset = 0; CommandOffset < CommandTableSize; CommandOffset++)
+			{
+				if(Shell_FindCommand((uint8_t*)CommandTable[CommandOffset].CommandText, strlen(CommandTable[CommandOffset].CommandText)) != NULL)
+				{
+					Status = SHELL_WRONG_PARAMETER;
+				}
+			}
+
+			if(SHELL_OK == Status)
+			{
+				CommandTables[CommandTablesTotal] = CommandTable;
+
+				CommandTablesSize[CommandTablesTotal] = CommandTableSize;
+
+				CommandTablesTotal++;
+			}
+		}
+	}
+
+	return Status;
+}
+
 shell_status_t Shell_ClearScreen(void)
 {
 	SHELL_CLEAR_SCREEN;
@@ -168,15 +299,15 @@ void Shell_NewLine(void)
 
 void Shell_WriteString(char * TextToWrite)
 {
-	uint8_t StringSize;
+	uint16_t StringSize;
 
 	StringSize = strlen(TextToWrite);
-	SerialPlatform_SendBlocking((uint8_t*)TextToWrite,StringSize);
+	Shell_TxWrite((uint8_t*)TextToWrite,StringSize);
 }
 
 void Shell_WriteNumber(uint32_t NumberToPrint)
 {
-	uint8_t AsciiBuffer[6]=
+	uint8_t AsciiBuffer[11]=
 	{
 		0
 	};
@@ -188,152 +319,738 @@ void Shell_WriteNumber(uint32_t NumberToPrint)
 
 void Shell_WriteCharacter(uint8_t DataToPrint)
 {
-	SerialPlatform_SendBlocking(&DataToPrint,1);
+	Shell_TxWrite(&DataToPrint,1);
+}
+
+void Shell_WriteBuffer(uint8_t * DataToWrite, uint16_t DataSize)
+{
+	Shell_TxWrite(DataToWrite,DataSize);
+}
+
+bool Shell_WriteFrame(uint8_t * DataToWrite, uint16_t DataSize)
+{
+	bool isWritten = true;
+
+#if (SHELL_TX_FULL_POLICY == SHELL_TX_POLICY_BLOCK)
+	Shell_TxWrite(DataToWrite,DataSize);
+#else
+	/* a frame is queued whole or not at all, whatever the policy does to text */
+	if(DataSize <= Shell_TxSpaceAvailable())
+	{
+		Shell_TxCopy(DataToWrite, DataSize);
+	}
+	else
+	{
+		ShellTxDroppedBytes += DataSize;
+		isWritten = false;
+	}
+
+	Shell_TxStart();
+#endif
+
+	return isWritten;
+}
+
+void Shell_SetBinaryHandler(shell_binary_handler_t Handler)
+{
+	ShellBinaryHandler = Handler;
 }
 
 void Shell_AsynchCommandDone(void)
 {
 	CLEAR_FLAG(ShellStatus,SHELL_COMMAND_PENDING_FLAG);
-	SHELL_NEW_LINE;
-	SHELL_PROMPT;
+
+	/* on a batch, the next command is executed on the next Shell_Task */
+	if(CHECK_FLAG(ShellStatus,SHELL_BATCH_RUNNING_FLAG))
+	{
+		Shell_BatchReport(SHELL_RESULT_DONE);
+	}
+	else
+	{
+		SHELL_NEW_LINE;
+		SHELL_PROMPT;
+	}
+}
+
+void Shell_SetTimeSource(shell_time_t TimeSource)
+{
+	ShellTimeSource = TimeSource;
+}
+
+uint32_t Shell_GetDroppedBytes(void)
+{
+	return ShellTxDroppedBytes;
+}
+
+uint32_t Shell_GetRxOverrunBytes(void)
+{
+	return ShellRxOverrunBytes;
+}
+
+uint16_t Shell_GetTxHighWaterMark(void)
+{
+	return ShellTxHighWaterMark;
+}
+
+uint16_t Shell_GetRxHighWaterMark(void)
+{
+	return ShellRxHighWaterMark;
 }
 
 void Shell_Task(void)
+{
+	uint8_t NewCharacter;
+
+	Shell_BatchTask();
+
+	/* everything queued since the last call is processed, an asynch command or a batch holds the rest */
+	while((ShellRxReadOffset != ShellRxWriteOffset) && (!CHECK_FLAG(ShellStatus,SHELL_COMMAND_PENDING_FLAG)) \
+			&& (!CHECK_FLAG(ShellStatus,SHELL_BATCH_RUNNING_FLAG)))
+	{
+		NewCharacter = ShellRxBuffer[ShellRxReadOffset];
+
+		if((ShellRxReadOffset + 1) >= SHELL_RX_BUFFER_SIZE)
+		{
+			ShellRxReadOffset = 0;
+		}
+		else
+		{
+			ShellRxReadOffset++;
+		}
+
+		Shell_ProcessCharacter(NewCharacter);
+
+		Shell_BatchTask();
+	}
+}
+
+static void Shell_ProcessCharacter(uint8_t NewCharacter)
 {
 	static uint8_t EofCounter = 0;
-	uint8_t CommandOffset;
+	shell_result_t CommandResult;
+
+	if(NewCharacter == '\r')
+	{
+		EofCounter++;
+	}
+	else if((EofCounter == 1) && (NewCharacter == '\n'))
+	{
+		if(CHECK_FLAG(ShellStatus,SHELL_BATCH_RECEIVING_FLAG))
+		{
+			Shell_BatchStoreLine();
+		}
+		else if(ShellCommandCurrentOffset > 2)
+		{
+			SHELL_NEW_LINE;
+
+			if(Shell_IsLine(SHELL_BATCH_START_LINE) == true)
+			{
+				/* from now on lines are stored, not executed */
+				SET_FLAG(ShellStatus,SHELL_BATCH_RECEIVING_FLAG);
+				CLEAR_FLAG(ShellStatus,SHELL_BATCH_OVERFLOW_FLAG);
+
+				ShellBatchWriteOffset = 0;
+			}
+			else
+			{
+				CommandResult = Shell_ExecuteCommand();
+
+				if(SHELL_RESULT_DONE == CommandResult)
+				{
+					SHELL_NEW_LINE;
+					SHELL_PROMPT;
+				}
+				else if(SHELL_RESULT_NOT_FOUND == CommandResult)
+				{
+					Shell_WriteString("\n\rCommand Not Found\n\r");
+					SHELL_NEW_LINE;
+					SHELL_PROMPT;
+				}
+				else if(SHELL_RESULT_TOO_MANY_ARGS == CommandResult)
+				{
+					Shell_WriteString("\n\rToo Many Arguments\n\r");
+					SHELL_NEW_LINE;
+					SHELL_PROMPT;
+				}
+				else if(SHELL_RESULT_WRONG_QUOTES == CommandResult)
+				{
+					Shell_WriteString("\n\rMissing Closing Quote\n\r");
+					SHELL_NEW_LINE;
+					SHELL_PROMPT;
+				}
+			}
+		}
+		else
+		{
+			SHELL_NEW_LINE;
+			SHELL_PROMPT;
+		}
+
+		/* buffer is not cleared, arguments of an asynch command still point into it */
+		EofCounter = 0;
+		ShellCommandCurrentOffset = 0;
+	}
+	else if(NewCharacter == 0x8)
+	{
+		if(ShellCommandCurrentOffset)
+		{
+			ShellCommandCurrentOffset--;
+			ShellCommandBuffer[ShellCommandCurrentOffset] = 0;
+
+			SHELL_BACKSPACE;
+		}
+	}
+	else if(ShellCommandCurrentOffset < (SHELL_COMMAND_SIZE_MAX - 1))
+	{
+		ShellCommandBuffer[ShellCommandCurrentOffset] = NewCharacter;
+		ShellCommandCurrentOffset++;
+
+		/* no echo while a batch is received */
+		if(!CHECK_FLAG(ShellStatus,SHELL_BATCH_RECEIVING_FLAG))
+		{
+			Shell_WriteCharacter(NewCharacter);
+		}
+	}
+}
+
+static shell_result_t Shell_ExecuteCommand(void)
+{
+	shell_result_t CommandResult = SHELL_RESULT_NOT_FOUND;
+	shell_command_t * CommandToExecute;
 	uint8_t CommandSize;
-	uint8_t CommandTextStatus;
 	shell_command_status_t CommandStatus;
-	uint8_t * ArgPosition;
-	uint8_t ArgsCounter;
-	uint8_t * ArgLastPosition;
+	uint8_t ArgsCounter = 0;
+
+	/* the command name goes up to the first space */
+	CommandSize = 0;
+
+	while((CommandSize < ShellCommandCurrentOffset) && (ShellCommandBuffer[CommandSize] != ' '))
+	{
+		CommandSize++;
+	}
 
-	if(CHECK_FLAG(ShellStatus,SHELL_CHARACTER_RECEIVED_FLAG))
+	CommandToExecute = Shell_FindCommand(&ShellCommandBuffer[0], CommandSize);
+
+	if(CommandToExecute != NULL)
 	{
-		CLEAR_FLAG(ShellStatus,SHELL_CHARACTER_RECEIVED_FLAG);
+		CommandResult = Shell_SplitArguments(CommandSize, &ArgsCounter);
+
+		if(ArgsCounter > CommandToExecute->CommandArgsCount)
+		{
+			CommandResult = SHELL_RESULT_TOO_MANY_ARGS;
+		}
+	}
+
+	if(SHELL_RESULT_DONE == CommandResult)
+	{
+		/* arguments point into the command buffer, nothing is copied */
+		if(CommandToExecute->CommandArgsCount)
+		{
+			CommandStatus = CommandToExecute->Command(&ShellArgsList[0],ArgsCounter);
+		}
+		else
+		{
+			CommandStatus = CommandToExecute->Command(NULL,0);
+		}
 
-		/* ignore character if there's a pending asynch command */
-		if(!CHECK_FLAG(ShellStatus,SHELL_COMMAND_PENDING_FLAG))
+		if(SHELL_COMMAND_DONE == CommandStatus)
 		{
-			if(NewCharacterRecevied == '\r')
+			CommandResult = SHELL_RESULT_DONE;
+		}
+		else
+		{
+			SET_FLAG(ShellStatus,SHELL_COMMAND_PENDING_FLAG);
+
+			CommandResult = SHELL_RESULT_ASYNCH;
+		}
+	}
+
+	return CommandResult;
+}
+
+static shell_result_t Shell_SplitArguments(uint8_t CommandSize, uint8_t * ArgsCounter)
+{
+	shell_result_t SplitResult = SHELL_RESULT_DONE;
+	uint8_t BufferOffset = CommandSize;
+	uint8_t ArgsFound = 0;
+
+	/* spaces and quotes are replaced by null terminators in place */
+	ShellCommandBuffer[ShellCommandCurrentOffset] = '\0';
+
+	while((BufferOffset < ShellCommandCurrentOffset) && (SHELL_RESULT_DONE == SplitResult))
+	{
+		if(ShellCommandBuffer[BufferOffset] == ' ')
+		{
+			ShellCommandBuffer[BufferOffset] = '\0';
+			BufferOffset++;
+		}
+		else if(ArgsFound >= SHELL_COMMAND_ARGS_MAX)
+		{
+			SplitResult = SHELL_RESULT_TOO_MANY_ARGS;
+		}
+		else if(ShellCommandBuffer[BufferOffset] == '"')
+		{
+			/* quoted arguments may have spaces */
+			BufferOffset++;
+			ShellArgsList[ArgsFound] = &ShellCommandBuffer[BufferOffset];
+			ArgsFound++;
+
+			while((BufferOffset < ShellCommandCurrentOffset) && (ShellCommandBuffer[BufferOffset] != '"'))
 			{
-				EofCounter++;
+				BufferOffset++;
 			}
-			else if((EofCounter == 1) && (NewCharacterRecevied == '\n'))
+
+			if(BufferOffset < ShellCommandCurrentOffset)
 			{
-				if(ShellCommandCurrentOffset > 2)
-				{
-					/* enter was received, start parsing */
-					CommandOffset = ApplicationCommandsTotal;
+				ShellCommandBuffer[BufferOffset] = '\0';
+				BufferOffset++;
+			}
+			else
+			{
+				SplitResult = SHELL_RESULT_WRONG_QUOTES;
+			}
+		}
+		else
+		{
+			ShellArgsList[ArgsFound] = &ShellCommandBuffer[BufferOffset];
+			ArgsFound++;
 
-					while(CommandOffset--)
-					{
-						CommandSize = strlen(ApplicationCommands[CommandOffset].CommandText);
+			while((BufferOffset < ShellCommandCurrentOffset) && (ShellCommandBuffer[BufferOffset] != ' '))
+			{
+				BufferOffset++;
+			}
+		}
+	}
 
-						CommandTextStatus = MiscFunction_StringCompare((uint8_t*)ApplicationCommands[CommandOffset].CommandText, &ShellCommandBuffer[0], CommandSize);
+	*ArgsCounter = ArgsFound;
 
-						if(STRING_OK == CommandTextStatus)
-						{
-							break;
-						}
-					}
+	return SplitResult;
+}
 
-					SHELL_NEW_LINE;
-					/* roll over means there's no match */
-					if(CommandOffset != 0xFF)
-					{
-						/* now look for parameters if needed*/
-						if(ApplicationCommands[CommandOffset].CommandArgsCount)
-						{
-							ArgsCounter = 0;
-							ArgLastPosition = &ShellCommandBuffer[0];
-
-							while(ArgsCounter < ApplicationCommands[CommandOffset].CommandArgsCount)
-							{
-								ArgPosition = MiscFunctions_FindTokenInString(ArgLastPosition, ' ');
-
-								if(ArgPosition != NULL)
-								{
-									/* function returns the address if the token, hence, point to the next */
-									MiscFunctions_MemClear(&ShellArgs[ArgsCounter][0],SHELL_COMMAND_ARGS_SIZE_MAX);
-									MiscFunctions_StringCopyUntilToken(ArgPosition, &ShellArgs[ArgsCounter][0], ' ');
-									ShellArgsList[ArgsCounter] = &ShellArgs[ArgsCounter][0];
-
-									ArgLastPosition = ArgPosition;
-									ArgsCounter++;
-								}
-								else
-								{
-									break;
-								}
-							}
-
-							CommandStatus = ApplicationCommands[CommandOffset].Command(&ShellArgsList[0],ArgsCounter);
-						}
-						else
-						{
-							CommandStatus = ApplicationCommands[CommandOffset].Command(NULL,0);
-						}
-
-						if(SHELL_COMMAND_DONE == CommandStatus)
-						{
-							SHELL_NEW_LINE;
-							SHELL_PROMPT;
-						}
-						else
-						{
-							SET_FLAG(ShellStatus,SHELL_COMMAND_PENDING_FLAG);
-						}
-					}
-					else
-					{
-						Shell_WriteString("\n\rCommand Not Found\n\r");
-						SHELL_NEW_LINE;
-						SHELL_PROMPT;
-					}
-
-					/* once command is done, refresh everything */
-					EofCounter = 0;
-					ShellCommandCurrentOffset = 0;
-
-					MiscFunctions_MemClear(&ShellCommandBuffer[0],SHELL_COMMAND_SIZE_MAX);
-				}
-				else
-				{
-					SHELL_NEW_LINE;
-					SHELL_PROMPT;
-					EofCounter = 0;
-					ShellCommandCurrentOffset = 0;
+static bool Shell_IsLine(const char * LineToCompare)
+{
+	bool isSameLine = false;
+	uint16_t LineSize;
 
-					MiscFunctions_MemClear(&ShellCommandBuffer[0],SHELL_COMMAND_SIZE_MAX);
-				}
+	LineSize = strlen(LineToCompare);
+
+	if(LineSize == ShellCommandCurrentOffset)
+	{
+		if(strncmp(LineToCompare, (char*)&ShellCommandBuffer[0], LineSize) == 0)
+		{
+			isSameLine = true;
+		}
+	}
+
+	return isSameLine;
+}
+
+static void Shell_BatchStoreLine(void)
+{
+	if(Shell_IsLine(SHELL_BATCH_END_LINE) == true)
+	{
+		CLEAR_FLAG(ShellStatus,SHELL_BATCH_RECEIVING_FLAG);
+
+		/* nothing runs unless the whole batch was stored */
+		if(CHECK_FLAG(ShellStatus,SHELL_BATCH_OVERFLOW_FLAG))
+		{
+			Shell_WriteString("#batch overflow\n\r");
+			SHELL_PROMPT;
+		}
+		else
+		{
+			SET_FLAG(ShellStatus,SHELL_BATCH_RUNNING_FLAG);
+
+			ShellBatchReadOffset = 0;
+			ShellBatchCommandIndex = 0;
+
+			Shell_WriteString("#batch begin\n\r");
+		}
+	}
+	else if(ShellCommandCurrentOffset)
+	{
+		/* lines are stored back to back, null terminated */
+		if((ShellBatchWriteOffset + ShellCommandCurrentOffset + 1) <= SHELL_BATCH_BUFFER_SIZE)
+		{
+			MiscFunctions_MemCopy(&ShellCommandBuffer[0], &ShellBatchBuffer[ShellBatchWriteOffset], ShellCommandCurrentOffset);
+
+			ShellBatchWriteOffset += ShellCommandCurrentOffset;
+			ShellBatchBuffer[ShellBatchWriteOffset] = 0;
+			ShellBatchWriteOffset++;
+		}
+		else
+		{
+			SET_FLAG(ShellStatus,SHELL_BATCH_OVERFLOW_FLAG);
+		}
+	}
+}
+
+static void Shell_BatchTask(void)
+{
+	shell_result_t CommandResult;
+	uint16_t LineSize;
+
+	while((CHECK_FLAG(ShellStatus,SHELL_BATCH_RUNNING_FLAG)) && (!CHECK_FLAG(ShellStatus,SHELL_COMMAND_PENDING_FLAG)))
+	{
+		if(ShellBatchReadOffset < ShellBatchWriteOffset)
+		{
+			LineSize = strlen((char*)&ShellBatchBuffer[ShellBatchReadOffset]);
+
+			MiscFunctions_MemClear(&ShellCommandBuffer[0],SHELL_COMMAND_SIZE_MAX);
+			MiscFunctions_MemCopy(&ShellBatchBuffer[ShellBatchReadOffset], &ShellCommandBuffer[0], LineSize);
+
+			ShellCommandCurrentOffset = LineSize;
+			ShellBatchReadOffset += (LineSize + 1);
+			ShellBatchCommandIndex++;
+
+			ShellBatchStartTime = Shell_GetTime();
+
+			CommandResult = Shell_ExecuteCommand();
+
+			/* asynch commands are reported once they are done */
+			if(SHELL_RESULT_ASYNCH != CommandResult)
+			{
+				Shell_BatchReport(CommandResult);
 			}
-			else if(NewCharacterRecevied == 0x8)
+		}
+		else
+		{
+			CLEAR_FLAG(ShellStatus,SHELL_BATCH_RUNNING_FLAG);
+
+			Shell_WriteString("#batch end ");
+			Shell_WriteNumber(ShellBatchCommandIndex);
+			SHELL_NEW_LINE;
+			SHELL_PROMPT;
+		}
+
+		ShellCommandCurrentOffset = 0;
+	}
+}
+
+static void Shell_BatchReport(shell_result_t CommandResult)
+{
+	/* one line per command: #result <index> <ok|unknown|args> <time> */
+	SHELL_NEW_LINE;
+	Shell_WriteString("#result ");
+	Shell_WriteNumber(ShellBatchCommandIndex);
+
+	if(SHELL_RESULT_NOT_FOUND == CommandResult)
+	{
+		Shell_WriteString(" unknown ");
+	}
+	else if((SHELL_RESULT_TOO_MANY_ARGS == CommandResult) || (SHELL_RESULT_WRONG_QUOTES == CommandResult))
+	{
+		Shell_WriteString(" args ");
+	}
+	else
+	{
+		Shell_WriteString(" ok ");
+	}
+
+	Shell_WriteNumber(Shell_GetTime() - ShellBatchStartTime);
+	SHELL_NEW_LINE;
+}
+
+static uint32_t Shell_GetTime(void)
+{
+	uint32_t CurrentTime = 0;
+
+	if(ShellTimeSource != NULL)
+	{
+		CurrentTime = ShellTimeSource();
+	}
+
+	return CurrentTime;
+}
+
+static shell_status_t Shell_PrepareCommands(shell_command_t * CommandTable, uint16_t CommandTableSize)
+{
+	shell_status_t Status = SHELL_OK;
+	shell_command_t CommandToInsert;
+	uint16_t CommandOffset;
+	uint16_t InsertOffset;
+
+	/* every entry needs a name and a function to execute */
+	for(CommandOffset = 0; CommandOffset < CommandTableSize; CommandOffset++)
+	{
+		if((CommandTable[CommandOffset].CommandText == NULL) || (CommandTable[CommandOffset].Command == NULL))
+		{
+			Status = SHELL_WRONG_PARAMETER;
+		}
+		else if((CommandTable[CommandOffset].CommandText[0] == '\0') || (strchr(CommandTable[CommandOffset].CommandText,' ') != NULL))
+		{
+			Status = SHELL_WRONG_PARAMETER;
+		}
+		else if(CommandTable[CommandOffset].CommandArgsCount > SHELL_COMMAND_ARGS_MAX)
+		{
+			Status = SHELL_WRONG_PARAMETER;
+		}
+	}
+
+	if(SHELL_OK == Status)
+	{
+		/* insertion sort, only done once at init */
+		for(CommandOffset = 1; CommandOffset < CommandTableSize; CommandOffset++)
+		{
+			CommandToInsert = CommandTable[CommandOffset];
+			InsertOffset = CommandOffset;
+
+			while((InsertOffset > 0) && (strcmp(CommandTable[InsertOffset - 1].CommandText, CommandToInsert.CommandText) > 0))
 			{
-				if(ShellCommandCurrentOffset)
-				{
-					ShellCommandCurrentOffset--;
-					ShellCommandBuffer[ShellCommandCurrentOffset] = 0;
+				CommandTable[InsertOffset] = CommandTable[InsertOffset - 1];
+				InsertOffset--;
+			}
 
-					SHELL_BACKSPACE;
-				}
+			CommandTable[InsertOffset] = CommandToInsert;
+		}
+
+		/* once sorted, duplicated names are next to each other */
+		for(CommandOffset = 1; CommandOffset < CommandTableSize; CommandOffset++)
+		{
+			if(strcmp(CommandTable[CommandOffset - 1].CommandText, CommandTable[CommandOffset].CommandText) == 0)
+			{
+				Status = SHELL_WRONG_PARAMETER;
+			}
+		}
+	}
+
+	return Status;
+}
+
+static shell_command_t * Shell_FindCommand(uint8_t * CommandName, uint8_t CommandNameSize)
+{
+	shell_command_t * CommandFound = NULL;
+	shell_command_t * CommandTable;
+	uint8_t TableOffset = 0;
+	uint16_t LowOffset;
+	uint16_t HighOffset;
+	uint16_t MiddleOffset;
+	int32_t CompareResult;
+
+	while((TableOffset < CommandTablesTotal) && (CommandFound == NULL))
+	{
+		CommandTable = CommandTables[TableOffset];
+		LowOffset = 0;
+		HighOffset = CommandTablesSize[TableOffset];
+
+		while((LowOffset < HighOffset) && (CommandFound == NULL))
+		{
+			MiddleOffset = LowOffset + ((HighOffset - LowOffset) >> 1);
+
+			CompareResult = strncmp(CommandTable[MiddleOffset].CommandText, (char*)CommandName, CommandNameSize);
+
+			/* the whole name must match, "led" is not "ledon" */
+			if((CompareResult == 0) && (CommandTable[MiddleOffset].CommandText[CommandNameSize] != '\0'))
+			{
+				CompareResult = 1;
+			}
+
+			if(CompareResult == 0)
+			{
+				CommandFound = &CommandTable[MiddleOffset];
+			}
+			else if(CompareResult < 0)
+			{
+				LowOffset = MiddleOffset + 1;
 			}
 			else
 			{
-				ShellCommandBuffer[ShellCommandCurrentOffset] = NewCharacterRecevied;
-				ShellCommandCurrentOffset++;
-				Shell_WriteCharacter(NewCharacterRecevied);
+				HighOffset = MiddleOffset;
 			}
 		}
+
+		TableOffset++;
+	}
+
+	return CommandFound;
+}
+
+static void Shell_TxWrite(uint8_t * DataToWrite, uint16_t DataSize)
+{
+	uint16_t SpaceAvailable;
+	uint16_t BytesToWrite;
+
+#if (SHELL_TX_FULL_POLICY == SHELL_TX_POLICY_BLOCK)
+	/* wait for the UART to make room, must not be called from an interrupt */
+	while(DataSize)
+	{
+		SpaceAvailable = Shell_TxSpaceAvailable();
+
+		if(SpaceAvailable)
+		{
+			BytesToWrite = (DataSize < SpaceAvailable) ? DataSize : SpaceAvailable;
+
+			Shell_TxCopy(DataToWrite, BytesToWrite);
+
+			DataToWrite += BytesToWrite;
+			DataSize -= BytesToWrite;
+		}
+
+		Shell_TxStart();
+	}
+#else
+	SpaceAvailable = Shell_TxSpaceAvailable();
+
+	if(DataSize <= SpaceAvailable)
+	{
+		Shell_TxCopy(DataToWrite, DataSize);
+	}
+	else
+	{
+#if (SHELL_TX_FULL_POLICY == SHELL_TX_POLICY_TRUNCATE)
+		/* leave room for the marker, if there's no room the marker is already there */
+		if(SpaceAvailable > SHELL_TX_TRUNCATE_MARKER_SIZE)
+		{
+			BytesToWrite = SpaceAvailable - SHELL_TX_TRUNCATE_MARKER_SIZE;
+
+			Shell_TxCopy(DataToWrite, BytesToWrite);
+			Shell_TxCopy((uint8_t*)SHELL_TX_TRUNCATE_MARKER, SHELL_TX_TRUNCATE_MARKER_SIZE);
+		}
+		else
+		{
+			BytesToWrite = 0;
+		}
+#else
+		BytesToWrite = SpaceAvailable;
+
+		Shell_TxCopy(DataToWrite, BytesToWrite);
+#endif
+		ShellTxDroppedBytes += (DataSize - BytesToWrite);
+	}
+
+	Shell_TxStart();
+#endif
+}
+
+static void Shell_TxCopy(uint8_t * DataToWrite, uint16_t DataSize)
+{
+	uint16_t WriteOffset = ShellTxWriteOffset;
+	uint16_t DataInBuffer;
+
+	while(DataSize--)
+	{
+		ShellTxBuffer[WriteOffset] = *DataToWrite++;
+
+		WriteOffset++;
+
+		if(WriteOffset >= SHELL_TX_BUFFER_SIZE)
+		{
+			WriteOffset = 0;
+		}
+	}
+
+	/* data is in place before the interrupt can see it */
+	ShellTxWriteOffset = WriteOffset;
+
+	DataInBuffer = (SHELL_TX_BUFFER_SIZE + WriteOffset - ShellTxReadOffset) % SHELL_TX_BUFFER_SIZE;
+
+	if(DataInBuffer > ShellTxHighWaterMark)
+	{
+		ShellTxHighWaterMark = DataInBuffer;
+	}
+}
+
+static uint16_t Shell_TxSpaceAvailable(void)
+{
+	uint16_t SpaceAvailable;
+
+	/* one byte is always left empty to tell full from empty */
+	SpaceAvailable = (SHELL_TX_BUFFER_SIZE + ShellTxReadOffset - ShellTxWriteOffset - 1) % SHELL_TX_BUFFER_SIZE;
+
+	return SpaceAvailable;
+}
+
+static void Shell_TxStart(void)
+{
+	/* when there's a transfer on going, the interrupt takes care of the new data */
+	if((isTxInProgress == false) && (ShellTxReadOffset != ShellTxWriteOffset))
+	{
+		isTxInProgress = true;
+
+		Shell_TxSendChunk();
+	}
+}
+
+static void Shell_TxSendChunk(void)
+{
+	uint16_t WriteOffset = ShellTxWriteOffset;
+
+	/* only the contiguous part, the rest goes on the next transfer */
+	if(WriteOffset > ShellTxReadOffset)
+	{
+		ShellTxChunkSize = WriteOffset - ShellTxReadOffset;
+	}
+	else
+	{
+		ShellTxChunkSize = SHELL_TX_BUFFER_SIZE - ShellTxReadOffset;
+	}
+
+	SerialPlatform_SendNonBlocking(&ShellTxBuffer[ShellTxReadOffset], ShellTxChunkSize);
+}
+
+static void Shell_TxDoneCallback(void)
+{
+	uint16_t ReadOffset;
+
+	ReadOffset = ShellTxReadOffset + ShellTxChunkSize;
+
+	if(ReadOffset >= SHELL_TX_BUFFER_SIZE)
+	{
+		ReadOffset = 0;
+	}
+
+	ShellTxReadOffset = ReadOffset;
+
+	if(ShellTxReadOffset != ShellTxWriteOffset)
+	{
+		Shell_TxSendChunk();
+	}
+	else
+	{
+		isTxInProgress = false;
 	}
 }
 
 static void Shell_ReceiveCallback (uint8_t NewReceivedData)
 {
-	NewCharacterRecevied = NewReceivedData;
+	uint16_t WriteOffset;
+	uint16_t DataInBuffer;
+	bool isBinaryData = false;
+
+	/* bytes taken by the binary channel never reach the shell */
+	if(ShellBinaryHandler != NULL)
+	{
+		isBinaryData = ShellBinaryHandler(NewReceivedData);
+	}
+
+	if(isBinaryData == false)
+	{
+		WriteOffset = ShellRxWriteOffset + 1;
 
-	SET_FLAG(ShellStatus,SHELL_CHARACTER_RECEIVED_FLAG);
+		if(WriteOffset >= SHELL_RX_BUFFER_SIZE)
+		{
+			WriteOffset = 0;
+		}
+
+		/* when full, the new byte is lost and counted */
+		if(WriteOffset != ShellRxReadOffset)
+		{
+			ShellRxBuffer[ShellRxWriteOffset] = NewReceivedData;
+
+			ShellRxWriteOffset = WriteOffset;
+
+			DataInBuffer = (SHELL_RX_BUFFER_SIZE + WriteOffset - ShellRxReadOffset) % SHELL_RX_BUFFER_SIZE;
+
+			if(DataInBuffer > ShellRxHighWaterMark)
+			{
+				ShellRxHighWaterMark = DataInBuffer;
+			}
+		}
+		else
+		{
+			ShellRxOverrunBytes++;
+		}
+	}
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // EOF
@@ -41,16 +41,32 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //                                  Defines & Macros Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-#define SHELL_COMMANDS_MAX			(10)
-
 #define SHELL_COMMAND_SIZE_MAX		(64)
 
-#define SHELL_COMMAND_ARGS_MAX		(5)
+/* application table plus the tables added with Shell_AddCommands */
+#define SHELL_COMMAND_TABLES_MAX	(2)
 
-#define SHELL_COMMAND_ARGS_SIZE_MAX	(10)
+#define SHELL_COMMAND_ARGS_MAX		(5)
 
 #define SHELL_BAUDRATE			(115200)
 
+#define SHELL_TX_BUFFER_SIZE		(512)
+
+#define SHELL_RX_BUFFER_SIZE		(128)
+
+#define SHELL_BATCH_BUFFER_SIZE		(512)
+
+/* what to do when the TX buffer can't take the whole string */
+#define SHELL_TX_POLICY_BLOCK		(0)
+
+#define SHELL_TX_POLICY_DROP		(1)
+
+#define SHELL_TX_POLICY_TRUNCATE	(2)
+
+#ifndef SHELL_TX_FULL_POLICY
+#define SHELL_TX_FULL_POLICY		(SHELL_TX_POLICY_BLOCK)
+#endif
+
 typedef enum
 {
 	SHELL_OK = 0,
@@ -65,6 +81,12 @@ typedef enum
 
 typedef shell_command_status_t (* shell_execute_t)(uint8_t **, uint8_t);
 
+/* free running millisecond count, used to time the commands of a batch */
+typedef uint32_t (* shell_time_t)(void);
+
+/* called from the UART interrupt on each byte, returns true if the byte isn't for the shell */
+typedef bool (* shell_binary_handler_t)(uint8_t);
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //                                      Typedef Section
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -96,7 +118,9 @@ typedef struct
 extern "C" {
 #endif // __cplusplus
 
-shell_status_t Shell_Init(shell_command_t * CommandTable, uint8_t CommandTableSize, char * Prompt);
+shell_status_t Shell_Init(shell_command_t * CommandTable, uint16_t CommandTableSize, char * Prompt);
+
+shell_status_t Shell_AddCommands(shell_command_t * CommandTable, uint16_t CommandTableSize);
 
 shell_status_t Shell_ClearScreen(void);
 
@@ -108,8 +132,24 @@ void Shell_WriteCharacter(uint8_t DataToPrint);
 
 void Shell_WriteNumber(uint32_t NumberToPrint);
 
+void Shell_WriteBuffer(uint8_t * DataToWrite, uint16_t DataSize);
+
+bool Shell_WriteFrame(uint8_t * DataToWrite, uint16_t DataSize);
+
+void Shell_SetBinaryHandler(shell_binary_handler_t Handler);
+
 void Shell_AsynchCommandDone(void);
 
+void Shell_SetTimeSource(shell_time_t TimeSource);
+
+uint32_t Shell_GetDroppedBytes(void);
+
+uint32_t Shell_GetRxOverrunBytes(void);
+
+uint16_t Shell_GetTxHighWaterMark(void);
+
+uint16_t Shell_GetRxHighWaterMark(void);
+
 void Shell_Task(void);
 
 #if defined(__cplusplus)
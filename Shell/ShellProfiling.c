@@ -0,0 +1,425 @@
+/*HEADER******************************************************************************************
+BSD 3-Clause License
+
+Copyright (c) 2020, Carlos Neri
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**END********************************************************************************************/
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Includes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#include <stdint.h>
+#include <stdbool.h>
+#ifdef FSL_RTOS_FREE_RTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
+#include "Shell.h"
+#include "ShellProfiling.h"
+#include "SW_Timer.h"
+#include "AtCommands.h"
+#include "DataLogger.h"
+#include "MiscFunctions.h"
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Defines & Macros Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef FSL_RTOS_FREE_RTOS
+/* tasks listed by top and stacks, each one takes a TaskStatus_t of RAM */
+#ifndef SHELL_PROFILING_TASKS_MAX
+#define SHELL_PROFILING_TASKS_MAX		(12)
+#endif
+
+#define SHELL_PROFILING_USE_TASK_STATE	(configUSE_TRACE_FACILITY == 1)
+
+#define SHELL_PROFILING_USE_RUN_TIME	(SHELL_PROFILING_USE_TASK_STATE && (configGENERATE_RUN_TIME_STATS == 1))
+#else
+#define SHELL_PROFILING_USE_TASK_STATE	(0)
+
+#define SHELL_PROFILING_USE_RUN_TIME	(0)
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                       Typedef Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  Function Prototypes Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static shell_command_status_t ShellProfiling_Top(uint8_t ** Args, uint8_t ArgsCount);
+
+static shell_command_status_t ShellProfiling_Timers(uint8_t ** Args, uint8_t ArgsCount);
+
+static shell_command_status_t ShellProfiling_Buffers(uint8_t ** Args, uint8_t ArgsCount);
+
+static shell_command_status_t ShellProfiling_AtLatency(uint8_t ** Args, uint8_t ArgsCount);
+
+static shell_command_status_t ShellProfiling_Logger(uint8_t ** Args, uint8_t ArgsCount);
+
+#ifdef FSL_RTOS_FREE_RTOS
+static shell_command_status_t ShellProfiling_Heap(uint8_t ** Args, uint8_t ArgsCount);
+#endif
+
+#if SHELL_PROFILING_USE_TASK_STATE
+static shell_command_status_t ShellProfiling_Stacks(uint8_t ** Args, uint8_t ArgsCount);
+
+static UBaseType_t ShellProfiling_GetTasks(uint32_t * TotalRunTime);
+#endif
+
+static void ShellProfiling_WriteValue(char * Label, uint32_t Value);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Constants Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Global Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   Static Variables Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* not constant, the shell sorts it at init */
+static shell_command_t ShellProfilingCommands[] =
+{
+		{"top",0,ShellProfiling_Top},
+		{"timers",0,ShellProfiling_Timers},
+		{"buffers",0,ShellProfiling_Buffers},
+		{"atlat",0,ShellProfiling_AtLatency},
+		{"logger",0,ShellProfiling_Logger},
+#ifdef FSL_RTOS_FREE_RTOS
+		{"heap",0,ShellProfiling_Heap},
+#endif
+#if SHELL_PROFILING_USE_TASK_STATE
+		{"stacks",0,ShellProfiling_Stacks},
+#endif
+};
+
+static const char ** ProfilingModuleNames = NULL;
+
+static uint8_t ProfilingModulesTotal = 0;
+
+static shellprofiling_counter_t ProfilingCounter = NULL;
+
+static uint32_t ProfilingModuleStart[SHELL_PROFILING_MODULES_MAX];
+
+static uint32_t ProfilingModuleCounts[SHELL_PROFILING_MODULES_MAX];
+
+static uint32_t ProfilingLastTop = 0;
+
+#if SHELL_PROFILING_USE_TASK_STATE
+/* printed straight from here, no text buffer to overflow */
+static TaskStatus_t ProfilingTasks[SHELL_PROFILING_TASKS_MAX];
+
+/* indexed by eTaskState, same letters as vTaskList */
+static const char ProfilingTaskStates[] = "XRBSD?";
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Functions Section
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+shell_status_t ShellProfiling_Init(const char ** ModuleNames, uint8_t ModulesTotal, shellprofiling_counter_t Counter)
+{
+	shell_status_t Status = SHELL_WRONG_PARAMETER;
+
+	/* modules are optional, the rest of the commands work without them */
+	if(ModulesTotal <= SHELL_PROFILING_MODULES_MAX)
+	{
+		ProfilingModuleNames = ModuleNames;
+
+		ProfilingModulesTotal = (ModuleNames != NULL) ? ModulesTotal : 0;
+
+		ProfilingCounter = Counter;
+
+		if(ProfilingCounter != NULL)
+		{
+			ProfilingLastTop = ProfilingCounter();
+		}
+
+		Status = Shell_AddCommands(&ShellProfilingCommands[0], SIZE_OF_ARRAY(ShellProfilingCommands));
+	}
+
+	return Status;
+}
+
+void ShellProfiling_ModuleStart(uint8_t Module)
+{
+	if((Module < ProfilingModulesTotal) && (ProfilingCounter != NULL))
+	{
+		ProfilingModuleStart[Module] = ProfilingCounter();
+	}
+}
+
+void ShellProfiling_ModuleStop(uint8_t Module)
+{
+	if((Module < ProfilingModulesTotal) && (ProfilingCounter != NULL))
+	{
+		ProfilingModuleCounts[Module] += (ProfilingCounter() - ProfilingModuleStart[Module]);
+	}
+}
+
+static shell_command_status_t ShellProfiling_Top(uint8_t ** Args, uint8_t ArgsCount)
+{
+#if SHELL_PROFILING_USE_RUN_TIME
+	/* FreeRTOS already keeps the run time per task */
+	uint32_t TotalRunTime;
+	UBaseType_t TasksTotal;
+	UBaseType_t TaskOffset;
+
+	TasksTotal = ShellProfiling_GetTasks(&TotalRunTime);
+
+	if(TotalRunTime == 0)
+	{
+		TotalRunTime = 1;
+	}
+
+	for(TaskOffset = 0; TaskOffset < TasksTotal; TaskOffset++)
+	{
+		ShellProfiling_WriteValue((char*)ProfilingTasks[TaskOffset].pcTaskName, ProfilingTasks[TaskOffset].ulRunTimeCounter);
+		Shell_WriteString(" (");
+		Shell_WriteNumber((uint32_t)(((uint64_t)ProfilingTasks[TaskOffset].ulRunTimeCounter * 100) / TotalRunTime));
+		Shell_WriteString("%)");
+	}
+#else
+	uint32_t CurrentCount;
+	uint32_t ElapsedCount;
+	uint32_t ModulesCount = 0;
+	uint8_t ModuleOffset;
+
+	if(ProfilingCounter != NULL)
+	{
+		/* time spent on each module since the last top */
+		CurrentCount = ProfilingCounter();
+		ElapsedCount = CurrentCount - ProfilingLastTop;
+		ProfilingLastTop = CurrentCount;
+
+		if(ElapsedCount == 0)
+		{
+			ElapsedCount = 1;
+		}
+
+		for(ModuleOffset = 0; ModuleOffset < ProfilingModulesTotal; ModuleOffset++)
+		{
+			ShellProfiling_WriteValue((char*)ProfilingModuleNames[ModuleOffset], ProfilingModuleCounts[ModuleOffset]);
+			Shell_WriteString(" (");
+			Shell_WriteNumber((uint32_t)(((uint64_t)ProfilingModuleCounts[ModuleOffset] * 100) / ElapsedCount));
+			Shell_WriteString("%)");
+
+			ModulesCount += ProfilingModuleCounts[ModuleOffset];
+			ProfilingModuleCounts[ModuleOffset] = 0;
+		}
+
+		ShellProfiling_WriteValue("other", (ElapsedCount > ModulesCount) ? (ElapsedCount - ModulesCount) : 0);
+		ShellProfiling_WriteValue("total", ElapsedCount);
+	}
+	else
+	{
+		Shell_WriteString("no profiling counter");
+	}
+#endif
+
+	return SHELL_COMMAND_DONE;
+}
+
+static shell_command_status_t ShellProfiling_Timers(uint8_t ** Args, uint8_t ArgsCount)
+{
+	swtimer_statistics_t TimerStatistics;
+	swtimer_t TimerOffset;
+
+	SWTimer_GetStatistics(&TimerStatistics);
+
+	ShellProfiling_WriteValue("ticks", TimerStatistics.Ticks);
+	ShellProfiling_WriteValue("missed ticks", TimerStatistics.MissedTicks);
+
+	/* one line per allocated timer: index, state and ms left */
+	for(TimerOffset = 0; TimerOffset < SWTIMER_MAX_TIMERS; TimerOffset++)
+	{
+		if(TimerStatistics.Allocated & (1 << TimerOffset))
+		{
+			Shell_NewLine();
+			Shell_WriteString("timer ");
+			Shell_WriteNumber(TimerOffset);
+
+			if(TimerStatistics.Enabled & (1 << TimerOffset))
+			{
+				Shell_WriteString(" on ");
+			}
+			else
+			{
+				Shell_WriteString(" off ");
+			}
+
+			Shell_WriteNumber(SWTimer_GetTimeLeft(TimerOffset));
+			Shell_WriteString(" ms");
+		}
+	}
+
+	return SHELL_COMMAND_DONE;
+}
+
+static shell_command_status_t ShellProfiling_Buffers(uint8_t ** Args, uint8_t ArgsCount)
+{
+	AtCommandsStatistics_t AtStatistics;
+
+	AtCommands_GetStatistics(&AtStatistics);
+
+	ShellProfiling_WriteValue("shell tx max", Shell_GetTxHighWaterMark());
+	ShellProfiling_WriteValue("shell tx dropped", Shell_GetDroppedBytes());
+	ShellProfiling_WriteValue("shell rx max", Shell_GetRxHighWaterMark());
+	ShellProfiling_WriteValue("shell rx overrun", Shell_GetRxOverrunBytes());
+	ShellProfiling_WriteValue("at rx max", AtStatistics.RxHighWaterMark);
+
+	return SHELL_COMMAND_DONE;
+}
+
+static shell_command_status_t ShellProfiling_AtLatency(uint8_t ** Args, uint8_t ArgsCount)
+{
+	AtCommandsStatistics_t AtStatistics;
+	uint8_t BucketOffset;
+
+	AtCommands_GetStatistics(&AtStatistics);
+
+	/* resolution is the SW timer base time */
+	for(BucketOffset = 0; BucketOffset < ATCOMMANDS_LATENCY_BUCKETS; BucketOffset++)
+	{
+		Shell_NewLine();
+
+		if(BucketOffset < (ATCOMMANDS_LATENCY_BUCKETS - 1))
+		{
+			Shell_WriteString("< ");
+			Shell_WriteNumber(AtCommandsLatencyLimits[BucketOffset]);
+		}
+		else
+		{
+			Shell_WriteString(">= ");
+			Shell_WriteNumber(AtCommandsLatencyLimits[BucketOffset - 1]);
+		}
+
+		Shell_WriteString(" ms: ");
+		Shell_WriteNumber(AtStatistics.LatencyHistogram[BucketOffset]);
+	}
+
+	return SHELL_COMMAND_DONE;
+}
+
+static shell_command_status_t ShellProfiling_Logger(uint8_t ** Args, uint8_t ArgsCount)
+{
+	ShellProfiling_WriteValue("pending logs", DataLogger_GetPendingLogs());
+	ShellProfiling_WriteValue("max pending logs", DataLogger_GetMaxPendingLogs());
+
+	return SHELL_COMMAND_DONE;
+}
+
+#ifdef FSL_RTOS_FREE_RTOS
+static shell_command_status_t ShellProfiling_Heap(uint8_t ** Args, uint8_t ArgsCount)
+{
+	ShellProfiling_WriteValue("heap free", xPortGetFreeHeapSize());
+	ShellProfiling_WriteValue("heap min free", xPortGetMinimumEverFreeHeapSize());
+
+	return SHELL_COMMAND_DONE;
+}
+
+#endif
+
+#if SHELL_PROFILING_USE_TASK_STATE
+static shell_command_status_t ShellProfiling_Stacks(uint8_t ** Args, uint8_t ArgsCount)
+{
+	UBaseType_t TasksTotal;
+	UBaseType_t TaskOffset;
+	eTaskState TaskState;
+
+	TasksTotal = ShellProfiling_GetTasks(NULL);
+
+	/* name, state, priority, stack high water mark (words) and number */
+	for(TaskOffset = 0; TaskOffset < TasksTotal; TaskOffset++)
+	{
+		TaskState = ProfilingTasks[TaskOffset].eCurrentState;
+
+		if(TaskState > eDeleted)
+		{
+			TaskState = eDeleted + 1;
+		}
+
+		Shell_NewLine();
+		Shell_WriteString((char*)ProfilingTasks[TaskOffset].pcTaskName);
+		Shell_WriteCharacter(' ');
+		Shell_WriteCharacter((uint8_t)ProfilingTaskStates[TaskState]);
+		Shell_WriteCharacter(' ');
+		Shell_WriteNumber(ProfilingTasks[TaskOffset].uxCurrentPriority);
+		Shell_WriteCharacter(' ');
+		Shell_WriteNumber(ProfilingTasks[TaskOffset].usStackHighWaterMark);
+		Shell_WriteCharacter(' ');
+		Shell_WriteNumber(ProfilingTasks[TaskOffset].xTaskNumber);
+	}
+
+	return SHELL_COMMAND_DONE;
+}
+
+static UBaseType_t ShellProfiling_GetTasks(uint32_t * TotalRunTime)
+{
+	UBaseType_t TasksTotal;
+	uint32_t RunTime = 0;
+
+	/* FreeRTOS fills nothing when the array is too small, say so instead of listing part of it */
+	TasksTotal = uxTaskGetSystemState(&ProfilingTasks[0], SHELL_PROFILING_TASKS_MAX, &RunTime);
+
+	if(TasksTotal == 0)
+	{
+		ShellProfiling_WriteValue("tasks over SHELL_PROFILING_TASKS_MAX", uxTaskGetNumberOfTasks());
+	}
+
+	if(TotalRunTime != NULL)
+	{
+		*TotalRunTime = RunTime;
+	}
+
+	return TasksTotal;
+}
+#endif
+
+static void ShellProfiling_WriteValue(char * Label, uint32_t Value)
+{
+	Shell_NewLine();
+	Shell_WriteString(Label);
+	Shell_WriteString(": ");
+	Shell_WriteNumber(Value);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// EOF
+///////////////////////////////////////////////////////////////////////////////////////////////////